@@ -17,25 +17,92 @@
  *************************************************************/
 
 #include <Wire.h>
-#include "rgb_lcd.h"
+#include "counting_lcd.h"
+#include "pixel_canvas.h"
+#include "task_scheduler.h"
+#include "anim_timeline.h"
+#include "mem_monitor.h"
 #include "sort_program.h"
 #include "primes_program.h"
 #include "calculator_program.h"
 #include "paddle_game.h"
 #include "asi_program.h"
+#include "asteroids_game.h"
+#include "life_program.h"
+#include "search_program.h"
+#include "fib_program.h"
+#include "bench_serial.h"
+#include "ext_sort.h"
+#include "pot_trace.h"
+#include "vm_program.h"
+#include "logger_program.h"
+#include "micro_bench.h"
 
 // ══════════════════════════════════════════════════════════════════════════════
 // HARDWARE
 // ══════════════════════════════════════════════════════════════════════════════
 
-rgb_lcd lcd;
+CountingLcd lcd;   // rgb_lcd that counts its I2C bytes
 const int POT_PIN    = A0;
 const int BUZZER_PIN = 8;
+const int TEMP_PIN   = A1;   // Grove temperature sensor (Logger)
 
 //  Backlight colours
 const byte COL_PINK[3]  = {255,   0, 128};
 const byte COL_GREEN[3] = {  0, 255,   0};
 
+// ══════════════════════════════════════════════════════════════════════════════
+// PROGRAMS
+// ══════════════════════════════════════════════════════════════════════════════
+
+//  Program table, in menu order (see program_registry.h)
+constexpr ProgramInfo PROGRAMS[] = {
+  SORT_PROGRAM,
+  PRIMES_PROGRAM,
+  CALC_PROGRAM,
+  PADDLE_PROGRAM,
+  ASI_PROGRAM,
+  ASTEROIDS_PROGRAM,
+  LIFE_PROGRAM,
+  SEARCH_PROGRAM,
+  FIB_PROGRAM,
+  LOGGER_PROGRAM,
+  VM_PROGRAM
+};
+constexpr int PROGRAM_COUNT = sizeof(PROGRAMS) / sizeof(PROGRAMS[0]);
+
+//  Menu pages: labels are packed onto a page, " | " apart, as long as they
+// fit between the arrows
+const int MENU_PAGE_WIDTH = 13;
+
+//  Compile-time checks
+constexpr int labelLength(const char* s) { return *s ? 1 + labelLength(s + 1) : 0; }
+
+constexpr bool programsComplete() {
+  for (int i = 0; i < PROGRAM_COUNT; i++) {
+    if (!PROGRAMS[i].name || !PROGRAMS[i].enter || !PROGRAMS[i].tick) return false;
+    if (labelLength(PROGRAMS[i].name) > MENU_PAGE_WIDTH) return false;
+  }
+  return true;
+}
+
+constexpr unsigned long programStaticTotal() {
+  unsigned long total = 0;
+  for (int i = 0; i < PROGRAM_COUNT; i++) total += PROGRAMS[i].staticBytes;
+  return total;
+}
+
+constexpr bool programsKeepSharedGlyphs() {
+  for (int i = 0; i < PROGRAM_COUNT; i++) {
+    if (PROGRAMS[i].cgram & CGRAM_SHARED_GLYPHS) return false;
+  }
+  return true;
+}
+
+static_assert(programsComplete(), "every program needs enter/tick hooks and a label of at most 13 chars");
+static_assert(programStaticTotal() <= PROGRAM_STATIC_BUDGET, "resident program statics exceed PROGRAM_STATIC_BUDGET");
+static_assert(programsKeepSharedGlyphs(), "CGRAM slots 1-3 hold the shared µ and arrow glyphs");
+
 // ══════════════════════════════════════════════════════════════════════════════
 // SHARED STATE & CONFIGURATION
 // ══════════════════════════════════════════════════════════════════════════════
@@ -49,18 +116,19 @@ const unsigned long SCROLL_START_DELAY = 750UL;
 //  Cooldown between page transitions (prevents jump-through)
 const unsigned long PAGE_TRANSITION_COOLDOWN = 900UL;
 
-//  Top-level application states
+//  Top-level application states; program i runs in state APP_FIRST_PROGRAM + i
 enum AppState {
   APP_WELCOME,
   APP_PROGRAM_SELECT,
-  APP_SORT_TEST,
-  APP_PRIMES,
-  APP_CALCULATOR,
-  APP_PADDLE_GAME,
-  APP_ASI
+  APP_FIRST_PROGRAM
 };
+const int APP_STATE_COUNT = APP_FIRST_PROGRAM + PROGRAM_COUNT;
 
-AppState appState = APP_WELCOME;
+int appState = APP_WELCOME;
+
+//  Screen handlers for the two built-in states (end of file)
+void handleWelcome(unsigned long now);
+void handleProgramSelect(unsigned long now);
 
 //  Timing
 unsigned long stateEnteredAt = 0;   // millis() when current state began
@@ -72,9 +140,14 @@ int  potValue         = 0;
 int  potValuePrev     = -1;    // -1 = no previous reading (sentinel)
 bool potHasMoved      = false; // has pot moved since entering current state?
 int  remappedPotValue = 10;    // pot value mapped to [10, 350]
+int  potFiltered      = 0;     // lightly smoothed pot (EMA, alpha = 1/2)
+unsigned long potSampledAt     = 0;  // micros() of the latest ADC sample
+unsigned long potPrevSampledAt = 0;  // micros() of the sample before that
 
-//  Program selection page (1, 2, or 3)
+//  Program selection page (1-menuPageCount)
 int selectionPage = 1;
+int menuPageFirst[PROGRAM_COUNT + 1];  // first program on each page, then PROGRAM_COUNT
+int menuPageCount = 0;
 unsigned long pageChangedAt = 0;  // millis() of last page transition
 
 //  Movement gate: blocks selection on pages 2+ until intentional pot movement
@@ -83,28 +156,11 @@ bool selectionGateOpen    = true;  // true = selection allowed
 const int GATE_MOVEMENT_THRESHOLD = 50;  // pot units required to open gate
 
 //  Welcome jingle state
-bool welcomeJinglePlayed = false;
+bool welcomeJinglePlayed = false;  // notes queued for this visit
 
 //  Scroll state
 int scrollOffset = 0;   // leading-character index into the scroll string
 
-//  Celebratory animation frames
-// Slot 0 is overwritten each animation tick.
-// Phase 1 – pulsing diamond (frames 0-2)
-byte celebFrame0[8] = { 0b00100, 0b01110, 0b11111, 0b11111, 0b01110, 0b00100, 0b00000, 0b00000 };
-byte celebFrame1[8] = { 0b00000, 0b00100, 0b01110, 0b11111, 0b01110, 0b00100, 0b00000, 0b00000 };
-byte celebFrame2[8] = { 0b00000, 0b00000, 0b00100, 0b01110, 0b00100, 0b00000, 0b00000, 0b00000 };
-// Phase 2 – spinning line (frames 3-6)
-byte celebFrame3[8] = { 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00000, 0b00000, 0b00000 };  // |
-byte celebFrame4[8] = { 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b00000, 0b00000, 0b00000 };  // /
-byte celebFrame5[8] = { 0b00000, 0b00000, 0b11111, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000 };  // —
-byte celebFrame6[8] = { 0b10000, 0b01000, 0b00100, 0b00010, 0b00001, 0b00000, 0b00000, 0b00000 };  // backslash
-// Phase 3 – sparkle (frame 7)
-byte celebFrame7[8] = { 0b10001, 0b01010, 0b00100, 0b01010, 0b10001, 0b00000, 0b00000, 0b00000 };  // X sparkle
-const int     CELEB_FRAME_COUNT = 8;
-int           celebFrameIdx = 0;
-unsigned long celebTickAt   = 0;
-
 //  Micro (µ) symbol custom character
 // Custom character slot 1 = µ (mu) for microseconds display
 byte microChar[8] = { 0b00000, 0b01010, 0b01010, 0b01010, 0b01110, 0b01000, 0b01000, 0b00000 };
@@ -120,6 +176,71 @@ byte leftArrowChar[8] = { 0b00000, 0b00100, 0b01000, 0b11111, 0b01000, 0b00100,
 //  Pot deadband – absorbs ADC noise
 const int POT_DEADBAND = 8;
 
+//  Tasks (see task_scheduler.h)
+// The slider is sampled every millisecond; the current screen is redrawn at
+// 50 Hz (games: every millisecond); Serial input is polled every 5 ms, or on
+// every pass while a benchmark sweep runs.  Programs add their own compute
+// and audio tasks in TASK_GROUP_PROGRAM.
+const unsigned long INPUT_PERIOD_MS  = 1UL;
+const unsigned long UI_FRAME_MS      = 20UL;
+const unsigned long SERIAL_PERIOD_MS = 5UL;
+const unsigned long SERIAL_SLICE_US  = 8000UL;  // budget of a sliced sweep measurement
+
+int inputTask  = -1;
+int uiTask     = -1;
+int serialTask = -1;
+
+//  Power management
+// When no task is due the core sleeps until the next interrupt (the 1 ms
+// timer tick at the latest).  The backlight dims after DIM_AFTER_MS without
+// slider movement or a change of screen, and comes back on the first sample
+// that sees the slider move.
+const unsigned long DIM_AFTER_MS = 60000UL;
+const uint8_t       DIM_SHIFT    = 3;      // dimmed backlight = colour / 8
+
+byte backlightColor[3] = {255, 0, 128};
+bool backlightDimmed   = false;
+
+//  Awake-time accounting per top-level state (µs)
+unsigned long long powerTotalUs[APP_STATE_COUNT];
+unsigned long long powerAwakeUs[APP_STATE_COUNT];
+
+//  Memory monitor
+// The memory task records the deepest stack use of each top-level state
+// (mem_monitor.h); the stack is repainted on the first frame of every state.
+// When a state comes within MEM_WARN_BYTES of the stack limit Serial gets a
+// "# mem" line and the LCD shows a warning over row 0 until the state ends.
+const unsigned long MEM_PERIOD_MS  = 100UL;
+const unsigned long MEM_WARN_BYTES = 1024UL;
+
+int           memTask           = -1;
+unsigned long memPeak[APP_STATE_COUNT];   // deepest stack use per state (bytes)
+bool          memRepaintPending = false;
+bool          memWarned         = false;  // this state is low on stack
+
+//  Boot
+// Start-up is timed from reset to the first frame and to the first frame a
+// student can use (the menu or a program).  The welcome gives way to the menu
+// as soon as the slider moves.  With resume on ("boot resume on") a restart
+// goes straight back into the last program, at its last locked-in setting
+// when the program keeps one; holding the slider at the far left while
+// powering on shows the welcome instead.
+#define KV_BOOT_RESUME  KV_KEY(KV_NS_BOOT, 0)
+#define KV_BOOT_LAST    KV_KEY(KV_NS_BOOT, 1)
+const int BOOT_SKIP_RESUME_POT = 20;  // slider at or below this at power-on
+
+struct BootRecord {
+  char    program[14];  // menu label
+  uint8_t hasParam;
+  int32_t param;        // argument for the program's resume hook
+};
+
+BootRecord    bootLast;                // mirrors KV_BOOT_LAST
+unsigned long bootSetupMs       = 0;   // millis() at the end of setup()
+unsigned long bootFirstFrameMs  = 0;   // first frame of any screen
+unsigned long bootInteractiveMs = 0;   // first frame of the menu or a program
+bool          bootResumed       = false;
+
 // ══════════════════════════════════════════════════════════════════════════════
 // SHARED HELPERS
 // ══════════════════════════════════════════════════════════════════════════════
@@ -156,43 +277,297 @@ void tickScroll(const char* str, uint8_t row, unsigned long now, int wrapGap = 4
 }
 
 //  Celebration sound helper
-// Non-blocking ascending jingle. Call each loop iteration during celebration.
-// Auto-resets when stateEnteredAt changes.
+// Ascending jingle C5 E5 G5 C6 starting 0.5 s into the state.  The first call
+// after stateEnteredAt changes queues the notes as one-shot tasks, so their
+// timing doesn't depend on the screen's frame rate; later calls do nothing.
+const unsigned int  CELEB_NOTE_HZ[4] = { 523, 659, 784, 1047 };
+const unsigned long CELEB_NOTE_AT[4] = { 500UL, 650UL, 800UL, 950UL };  // ms into the state
+const unsigned long CELEB_NOTE_MS[4] = { 100UL, 100UL, 100UL, 200UL };  // last note longer
+int celebNoteIdx = 0;
+
+void queueCelebrationNote(unsigned long now);
+
+void playCelebrationNote(unsigned long now) {
+  tone(BUZZER_PIN, CELEB_NOTE_HZ[celebNoteIdx], CELEB_NOTE_MS[celebNoteIdx]);
+  celebNoteIdx++;
+  if (celebNoteIdx < 4) queueCelebrationNote(now);
+}
+
+void queueCelebrationNote(unsigned long now) {
+  unsigned long at = stateEnteredAt + CELEB_NOTE_AT[celebNoteIdx];
+  taskAddOnce("jingle", playCelebrationNote, ((long)(at - now) > 0) ? at - now : 0, TASK_PRIO_AUDIO);
+}
+
+//  Welcome jingle: C4 E4 G4 C5 starting 1 s into the welcome
+const unsigned int  WELCOME_NOTE_HZ[4] = { 262, 330, 392, 523 };
+const unsigned long WELCOME_NOTE_AT[4] = { 1000UL, 1120UL, 1240UL, 1360UL };
+const unsigned long WELCOME_NOTE_MS[4] = { 100UL, 100UL, 100UL, 150UL };
+int welcomeNoteIdx = 0;
+
+void queueWelcomeNote(unsigned long now);
+
+void playWelcomeNote(unsigned long now) {
+  tone(BUZZER_PIN, WELCOME_NOTE_HZ[welcomeNoteIdx], WELCOME_NOTE_MS[welcomeNoteIdx]);
+  welcomeNoteIdx++;
+  if (welcomeNoteIdx < 4) queueWelcomeNote(now);
+}
+
+void queueWelcomeNote(unsigned long now) {
+  unsigned long at = stateEnteredAt + WELCOME_NOTE_AT[welcomeNoteIdx];
+  taskAddOnce("jingle", playWelcomeNote, ((long)(at - now) > 0) ? at - now : 0, TASK_PRIO_AUDIO);
+}
+
 void tickCelebrationSound(unsigned long now) {
   static unsigned long soundStateStart = 0;
-  static int noteIdx = -1;
 
   if (soundStateStart != stateEnteredAt) {
     soundStateStart = stateEnteredAt;
-    noteIdx = -1;
+    celebNoteIdx    = 0;
+    queueCelebrationNote(now);
   }
+}
+
+//  Progress bar helper
+// Draws a bar of `cells` characters with 5 steps per cell (partial cells use
+// CGRAM slots 4-7, full cells the ROM block) followed by an ETA.  Call
+// progressBegin() once when a job starts and progressUpdate() from each time
+// slice; the LCD is only touched when the lit pixel count or the displayed
+// ETA changes.  The ETA divides the remaining work by an exponentially
+// smoothed throughput so that uneven slices don't make it jump around.
+byte progressGlyph[4][8] = {
+  { 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b10000 },
+  { 0b11000, 0b11000, 0b11000, 0b11000, 0b11000, 0b11000, 0b11000, 0b11000 },
+  { 0b11100, 0b11100, 0b11100, 0b11100, 0b11100, 0b11100, 0b11100, 0b11100 },
+  { 0b11110, 0b11110, 0b11110, 0b11110, 0b11110, 0b11110, 0b11110, 0b11110 }
+};
+const uint8_t PROGRESS_FIRST_SLOT = 4;       // slots 4-7 = 1-4 lit columns
+const unsigned long PROGRESS_RATE_SAMPLE_MS = 250UL;
+
+uint8_t       progressRow       = 1;
+uint8_t       progressCol       = 0;
+uint8_t       progressCells     = 11;
+int           progressShownPx   = -1;   // lit pixel columns on screen, -1 = none drawn
+long          progressShownEta  = -2;   // seconds on screen, -1 = "--"
+float         progressRate      = 0;    // smoothed work units per ms
+unsigned long progressLastDone  = 0;
+unsigned long progressLastMs    = 0;
+
+void progressBegin(uint8_t row, uint8_t col, uint8_t cells) {
+  progressRow      = row;
+  progressCol      = col;
+  progressCells    = cells;
+  progressShownPx  = -1;
+  progressShownEta = -2;
+  progressRate     = 0;
+  progressLastDone = 0;
+  progressLastMs   = 0;
+  for (uint8_t i = 0; i < 4; i++) lcd.createChar(PROGRESS_FIRST_SLOT + i, progressGlyph[i]);
+}
+
+void progressUpdate(unsigned long done, unsigned long total, unsigned long elapsedMs) {
+  if (total == 0) total = 1;
+  if (done > total) done = total;
+
+  //  Bar – redraw only the cells between the old and new end of the bar
+  int px = (int)((unsigned long long)done * progressCells * 5 / total);
+  if (px != progressShownPx) {
+    int from = (progressShownPx < 0) ? 0 : min(px, progressShownPx) / 5;
+    int to   = (progressShownPx < 0) ? progressCells - 1 : max(px, progressShownPx) / 5;
+    if (to > progressCells - 1) to = progressCells - 1;
+    lcd.setCursor(progressCol + from, progressRow);
+    for (int c = from; c <= to; c++) {
+      int lit = px - c * 5;
+      if      (lit >= 5) lcd.write((uint8_t)0xFF);
+      else if (lit <= 0) lcd.write((uint8_t)' ');
+      else               lcd.write((uint8_t)(PROGRESS_FIRST_SLOT + lit - 1));
+    }
+    progressShownPx = px;
+  }
+
+  //  Throughput – one sample per PROGRESS_RATE_SAMPLE_MS, EMA with alpha 1/4
+  if (elapsedMs - progressLastMs >= PROGRESS_RATE_SAMPLE_MS && done > progressLastDone) {
+    float inst = (float)(done - progressLastDone) / (float)(elapsedMs - progressLastMs);
+    progressRate     = (progressRate == 0) ? inst : progressRate + (inst - progressRate) / 4;
+    progressLastDone = done;
+    progressLastMs   = elapsedMs;
+  }
+
+  //  ETA – 5 columns right of the bar, "--" until the first rate sample
+  long eta = -1;
+  if (done >= total)         eta = 0;
+  else if (progressRate > 0) eta = (long)((total - done) / progressRate / 1000.0f + 0.999f);
+  if (eta != progressShownEta) {
+    char buf[8];
+    if (eta < 0)         snprintf(buf, sizeof(buf), "   --");
+    else if (eta > 7200) snprintf(buf, sizeof(buf), "  >2h");
+    else                 snprintf(buf, sizeof(buf), "%4lds", eta);
+    lcd.setCursor(progressCol + progressCells, progressRow);
+    lcd.print(buf);
+    progressShownEta = eta;
+  }
+}
+
+//  Backlight helper
+// Programs set their colour through here so the dimmer knows what to restore.
+void applyBacklight() {
+  uint8_t shift = backlightDimmed ? DIM_SHIFT : 0;
+  lcd.setRGB(backlightColor[0] >> shift, backlightColor[1] >> shift, backlightColor[2] >> shift);
+}
+
+void setBacklight(const byte* col) {
+  backlightColor[0] = col[0];
+  backlightColor[1] = col[1];
+  backlightColor[2] = col[2];
+  applyBacklight();
+}
+
+//  Frame pacing helpers
+// Redraw period of the current screen; games ask for 1 ms while playing.
+// Every change of top-level state resets it to UI_FRAME_MS.
+void setUiFrameMs(unsigned long ms) {
+  taskSetPeriod(uiTask, ms);
+}
+
+// Sleeps until the next interrupt: the 1 ms timer tick at the latest.
+void lowPowerWait() {
+#ifdef ARDUINO
+  __WFI();
+#else
+  delayMicroseconds(1000);
+#endif
+}
+
+// Dims the backlight once the current screen has been left alone for
+// DIM_AFTER_MS, and restores it as soon as either the slider moves or the
+// program moves on to another screen.
+void tickBacklightDimmer(unsigned long now, bool busy) {
+  unsigned long quietFor = min(now - potLastMovedAt, now - stateEnteredAt);
+  bool dim = !busy && quietFor >= DIM_AFTER_MS;
+  if (dim != backlightDimmed) {
+    backlightDimmed = dim;
+    applyBacklight();
+  }
+}
+
+//  Name of a top-level state for Serial reports
+const char* appStateName(int state) {
+  if (state == APP_WELCOME)        return "welcome";
+  if (state == APP_PROGRAM_SELECT) return "select";
+  return PROGRAMS[state - APP_FIRST_PROGRAM].name;
+}
+
+//  Serial command: power [reset]
+// Prints the share of wall-clock time each top-level state spent awake.
+void powerCommand(char* args) {
+  char* sub = args ? strtok(args, " \t\r") : NULL;
+  if (sub && strcmp(sub, "reset") == 0) {
+    memset(powerTotalUs, 0, sizeof(powerTotalUs));
+    memset(powerAwakeUs, 0, sizeof(powerAwakeUs));
+    return;
+  }
+  benchWrite("state,ms,awake_ms,awake_pct\n");
+  for (int i = 0; i < APP_STATE_COUNT; i++) {
+    if (powerTotalUs[i] == 0) continue;
+    unsigned long permille = (unsigned long)(powerAwakeUs[i] * 1000ULL / powerTotalUs[i]);
+    benchPrintf("%s,%lu,%lu,%lu.%lu\n", appStateName(i),
+                (unsigned long)(powerTotalUs[i] / 1000ULL), (unsigned long)(powerAwakeUs[i] / 1000ULL),
+                permille / 10, permille % 10);
+  }
+  benchPrintf("# backlight %s\n", backlightDimmed ? "dimmed" : "on");
+}
+
+// Folds the stack peak since the last repaint into the current state's.
+void memRecordPeak() {
+  unsigned long peak = memStackPeak();
+  if (peak > memPeak[appState]) memPeak[appState] = peak;
+}
 
-  unsigned long elapsed = now - stateEnteredAt;
+//  Serial command: mem [reset]
+// Prints static, heap and stack usage and the stack peak of every state.
+void memCommand(char* args) {
+  char* sub = args ? strtok(args, " \t\r") : NULL;
+  if (sub && strcmp(sub, "reset") == 0) {
+    memset(memPeak, 0, sizeof(memPeak));
+    memRepaintPending = true;
+    return;
+  }
+  memRecordPeak();
+  unsigned long stack = memStackSize();
+  benchPrintf("# ram static=%lu heap_used=%lu heap_free=%lu stack=%lu\n",
+              memStaticBytes(), memHeapUsed(), memHeapFree(), stack);
+  benchWrite("state,stack_peak,headroom\n");
+  for (int i = 0; i < APP_STATE_COUNT; i++) {
+    if (memPeak[i] == 0) continue;
+    benchPrintf("%s,%lu,%ld\n", appStateName(i), memPeak[i], (long)(stack - memPeak[i]));
+  }
+}
 
-  if (noteIdx < 0 && elapsed >= 500UL) {
-    tone(BUZZER_PIN, 523, 100);   // C5
-    noteIdx = 0;
-  } else if (noteIdx == 0 && elapsed >= 650UL) {
-    tone(BUZZER_PIN, 659, 100);   // E5
-    noteIdx = 1;
-  } else if (noteIdx == 1 && elapsed >= 800UL) {
-    tone(BUZZER_PIN, 784, 100);   // G5
-    noteIdx = 2;
-  } else if (noteIdx == 2 && elapsed >= 950UL) {
-    tone(BUZZER_PIN, 1047, 200);  // C6 (longer final note)
-    noteIdx = 3;
+//  Pot sampling helper
+// Reads the ADC, updates the smoothed value and movement detection.  Called
+// once per loop(); latency-sensitive handlers may call it again mid-frame to
+// act on the freshest sample.
+void samplePot(unsigned long now) {
+  potValue = traceInput(analogRead(POT_PIN), now);
+  int potStep = potValue - potFiltered;
+  potFiltered += (potStep + (potStep > 0) - (potStep < 0)) / 2;   // rounded, so it settles on potValue
+  potPrevSampledAt = potSampledAt;
+  potSampledAt     = micros();
+  if (abs(potValue - potValuePrev) > POT_DEADBAND) {
+    potLastMovedAt = now;
+    potHasMoved    = true;
+    potValuePrev   = potValue;
   }
+  remappedPotValue = map(potValue, 0, 1023, 10, 350);
+}
+
+//  Resume helpers
+bool bootResumeEnabled() {
+  uint8_t on = 0;
+  return kvGet(KV_BOOT_RESUME, &on, sizeof(on)) && on;
+}
+
+// Writes bootLast to flash, but only while resume is on: nothing reads it
+// otherwise, and every program switch would cost a record.
+void bootSaveLast() {
+  if (bootResumeEnabled()) kvPut(KV_BOOT_LAST, &bootLast, sizeof(bootLast));
 }
 
 //  State-transition helper
+// Remembers the program being entered for resume.  A setting saved for the
+// same program is kept, so resuming reuses it until a new one is locked in.
+void bootRecordProgram(const char* name) {
+  if (strncmp(bootLast.program, name, sizeof(bootLast.program)) == 0) return;
+  memset(&bootLast, 0, sizeof(bootLast));
+  strncpy(bootLast.program, name, sizeof(bootLast.program) - 1);
+  bootSaveLast();
+}
+
+// Called by programs when a setting is locked in (see ProgramInfo::resume).
+void bootRememberParam(long param) {
+  if (appState < APP_FIRST_PROGRAM) return;
+  bootRecordProgram(PROGRAMS[appState - APP_FIRST_PROGRAM].name);
+  if (bootLast.hasParam && bootLast.param == (int32_t)param) return;
+  bootLast.hasParam = 1;
+  bootLast.param    = (int32_t)param;
+  bootSaveLast();
+}
+
 // Common bookkeeping whenever we move to a new top-level state.
 void enterAppState(int next) {
-  appState       = (AppState)next;
+  memRecordPeak();
+  memRepaintPending = true;
+  memWarned         = false;
+  if (appState >= APP_FIRST_PROGRAM && PROGRAMS[appState - APP_FIRST_PROGRAM].exit) {
+    PROGRAMS[appState - APP_FIRST_PROGRAM].exit();
+  }
+  taskCancelGroup(TASK_GROUP_PROGRAM);  // anything the exit hook left behind
+  appState       = next;
   stateEnteredAt = millis();
   scrollOffset   = 0;
   scrollTickAt   = millis();
   potHasMoved    = false;
-  lcd.setRGB(COL_PINK[0], COL_PINK[1], COL_PINK[2]);
+  setBacklight(COL_PINK);
+  setUiFrameMs(UI_FRAME_MS);
   lcd.clear();
 
   // Reset program-specific states to their initial values
@@ -202,65 +577,188 @@ void enterAppState(int next) {
     selectionPage = 1;  // Always start at page 1 when entering selection screen
     pageChangedAt = 0;  // Reset cooldown timer
     selectionGateOpen = true;  // Page 1 has no gate
-  } else if (next == APP_PRIMES) {
-    enterPrimesState(PRIMES_TITLE);
-  } else if (next == APP_SORT_TEST) {
-    enterSortState(SORT_TITLE);
-  } else if (next == APP_CALCULATOR) {
-    enterCalcState(CALC_TITLE);
-  } else if (next == APP_PADDLE_GAME) {
-    enterGameState(GAME_TITLE);
-  } else if (next == APP_ASI) {
-    enterASIState(ASI_WELCOME_1);
+  } else {
+    bootRecordProgram(PROGRAMS[next - APP_FIRST_PROGRAM].name);
+    PROGRAMS[next - APP_FIRST_PROGRAM].enter();
+  }
+}
+
+//  Starts a program by its menu label (Serial commands use this)
+bool enterProgramNamed(const char* name) {
+  for (int i = 0; i < PROGRAM_COUNT; i++) {
+    if (strcmp(PROGRAMS[i].name, name) == 0) {
+      enterAppState(APP_FIRST_PROGRAM + i);
+      return true;
+    }
+  }
+  return false;
+}
+
+//  Menu layout helper
+// Packs the program labels onto pages in table order.
+void layoutMenu() {
+  int width = 0;
+  menuPageCount = 0;
+  for (int i = 0; i < PROGRAM_COUNT; i++) {
+    int len = strlen(PROGRAMS[i].name);
+    if (menuPageCount == 0 || width + 3 + len > MENU_PAGE_WIDTH) {
+      menuPageFirst[menuPageCount++] = i;
+      width = len;
+    } else {
+      width += 3 + len;
+    }
+  }
+  menuPageFirst[menuPageCount] = PROGRAM_COUNT;
+}
+
+// Enters the last program instead of the welcome when resume is on and the
+// slider isn't held at the far left.  Returns true if it did.
+bool bootTryResume() {
+  if (!kvGet(KV_BOOT_LAST, &bootLast, sizeof(bootLast))) memset(&bootLast, 0, sizeof(bootLast));
+  bootLast.program[sizeof(bootLast.program) - 1] = '\0';
+  if (!bootResumeEnabled() || potValuePrev <= BOOT_SKIP_RESUME_POT) return false;
+
+  for (int i = 0; i < PROGRAM_COUNT; i++) {
+    if (strcmp(PROGRAMS[i].name, bootLast.program) != 0) continue;
+    enterAppState(APP_FIRST_PROGRAM + i);
+    if (bootLast.hasParam && PROGRAMS[i].resume) PROGRAMS[i].resume(bootLast.param);
+    bootResumed = true;
+    return true;
+  }
+  return false;
+}
+
+//  Serial command: boot [resume on|off]
+// Prints the start-up times of this boot and the resume setting.
+void bootCommand(char* args) {
+  char* sub = args ? strtok(args, " \t\r") : NULL;
+  if (sub && strcmp(sub, "resume") == 0) {
+    char* arg = strtok(NULL, " \t\r");
+    if (!arg || (strcmp(arg, "on") != 0 && strcmp(arg, "off") != 0)) {
+      benchWrite("# boot: resume on|off\n");
+      return;
+    }
+    uint8_t on = (strcmp(arg, "on") == 0);
+    kvPut(KV_BOOT_RESUME, &on, sizeof(on));
+    bootSaveLast();  // the program in use now, which wasn't saved while off
   }
+  benchPrintf("# boot: setup_ms=%lu first_frame_ms=%lu interactive_ms=%lu resumed=%d resume=%s last=%s",
+              bootSetupMs, bootFirstFrameMs, bootInteractiveMs, bootResumed ? 1 : 0,
+              bootResumeEnabled() ? "on" : "off", bootLast.program[0] ? bootLast.program : "-");
+  if (bootLast.hasParam) benchPrintf(",%ld", (long)bootLast.param);
+  benchWrite("\n");
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SETUP & MAIN LOOP
 // ══════════════════════════════════════════════════════════════════════════════
 
+//  System tasks
+
+// Reads the pot and detects movement.
+void inputTaskRun(unsigned long now) {
+  samplePot(now);
+}
+
+// Dispatches to the current screen: one indirect call for any program.
+// Repaints the stack on a state's first frame, at the same shallow depth
+// every frame starts from.
+void uiTaskRun(unsigned long now) {
+  if (memRepaintPending) {
+    memResetPeak();
+    memRepaintPending = false;
+  }
+  if (appState == APP_WELCOME)             handleWelcome(now);
+  else if (appState == APP_PROGRAM_SELECT) handleProgramSelect(now);
+  else                                     PROGRAMS[appState - APP_FIRST_PROGRAM].tick(now);
+  animTick(now);
+  memSample();
+
+  if (bootFirstFrameMs == 0) bootFirstFrameMs = millis();
+  if (bootInteractiveMs == 0 && appState != APP_WELCOME) bootInteractiveMs = millis();
+
+  //  Low-memory warning drawn over the program's row 0
+  if (memWarned) {
+    char line[17];
+    snprintf(line, sizeof(line), "Low stack:%5luB", memStackSize() - memPeak[appState]);
+    lcd.setCursor(0, 0);
+    lcd.print(line);
+  }
+}
+
+// Serial benchmark commands (one measurement per run while a sweep runs, and
+// one line per run while an external sort is streaming).
+void serialTaskRun(unsigned long now) {
+  benchPoll();
+  taskSetPeriod(serialTask, (benchSweep.kind == BENCH_IDLE && !xsortBusy()) ? SERIAL_PERIOD_MS : 0);
+}
+
+// Tracks the stack peak and raises the low-memory warning once per state.
+void memTaskRun(unsigned long now) {
+  memRecordPeak();
+  unsigned long stack = memStackSize();
+  if (!memWarned && memPeak[appState] + MEM_WARN_BYTES > stack) {
+    memWarned = true;
+    benchPrintf("# mem: %s stack peak %lu of %lu bytes\n", appStateName(appState), memPeak[appState], stack);
+  }
+}
+
 void setup() {
-  Serial.begin(9600);
+  memBegin();  // paint the stack before anything uses it
+  Serial.begin(BENCH_BAUD);
 
   lcd.begin(16, 2);
-  lcd.setRGB(COL_PINK[0], COL_PINK[1], COL_PINK[2]);
-  lcd.createChar(0, celebFrame0);  // slot 0 = animation frame (overwritten each tick)
+  setBacklight(COL_PINK);
   lcd.createChar(1, microChar);    // slot 1 = µ (micro) symbol
   lcd.createChar(2, arrowChar);    // slot 2 = → (rightwards arrow)
   lcd.createChar(3, leftArrowChar);// slot 3 = ← (leftwards arrow)
 
   pinMode(BUZZER_PIN, OUTPUT);
+  layoutMenu();
+
+#if CALC_BENCHMARK_ON_BOOT
+  runCalcBenchmark();
+#endif
 
   // Seed potValuePrev so the first reading doesn't register as a spurious change
   potValuePrev = analogRead(POT_PIN);
+  potFiltered  = potValuePrev;
 
   // Stamp the start time for the welcome state
   stateEnteredAt = millis();
   scrollTickAt   = millis();
+
+  inputTask  = taskAdd("input",  inputTaskRun,  INPUT_PERIOD_MS,  TASK_PRIO_INPUT);
+  uiTask     = taskAdd("ui",     uiTaskRun,     UI_FRAME_MS,      TASK_PRIO_UI);
+  serialTask = taskAdd("serial", serialTaskRun, SERIAL_PERIOD_MS, TASK_PRIO_SERIAL, SERIAL_SLICE_US);
+  memTask    = taskAdd("memory", memTaskRun,    MEM_PERIOD_MS,    TASK_PRIO_SERIAL);
+
+  bootTryResume();
+  bootSetupMs = millis();
 }
 
 void loop() {
   unsigned long now = millis();
+  unsigned long loopStartUs = micros();
 
-  //  Read pot and detect movement
-  potValue = analogRead(POT_PIN);
-  if (abs(potValue - potValuePrev) > POT_DEADBAND) {
-    potLastMovedAt = now;
-    potHasMoved    = true;
-    potValuePrev   = potValue;
-  }
-  remappedPotValue = map(potValue, 0, 1023, 10, 350);
+  //  Run whatever is due
+  unsigned long idleMs = taskRunDue(now);
+
+  //  Loop latency for trace record/replay sessions
+  traceNoteLoop(micros() - loopStartUs);
 
-  //  Dispatch to current state handler
-  switch (appState) {
-    case APP_WELCOME:        handleWelcome(now);       break;
-    case APP_PROGRAM_SELECT: handleProgramSelect(now); break;
-    case APP_SORT_TEST:      handleSortTest(now);      break;
-    case APP_PRIMES:         handlePrimes(now);        break;
-    case APP_CALCULATOR:     handleCalculator(now);    break;
-    case APP_PADDLE_GAME:    handlePaddleGame(now);    break;
-    case APP_ASI:            handleASI(now);           break;
+  //  Idle: dim after inactivity, sleep until the next task is due
+  tickBacklightDimmer(now, taskHasBackground());
+  unsigned long sleptUs = 0;
+  if (idleMs > 0) {
+    unsigned long sleepFrom = micros();
+    lowPowerWait();
+    sleptUs = micros() - sleepFrom;
   }
+
+  unsigned long loopUs = micros() - loopStartUs;
+  powerTotalUs[appState] += loopUs;
+  powerAwakeUs[appState] += loopUs - sleptUs;
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -269,18 +767,14 @@ void loop() {
 
 //  handleWelcome
 // Layout: 0.75 s static, then 6 s scrolling (wrap gap 4). Total = 6.75 s.
+// Moving the slider skips straight to the menu.
 void handleWelcome(unsigned long now) {
   const char* msg = "Welcome to the Classroom Computer!";
 
-  // Play welcome jingle 1 second after entering welcome state
-  if (!welcomeJinglePlayed && (now - stateEnteredAt >= 1000UL)) {
-    tone(BUZZER_PIN, 262, 100);  // C4
-    delay(120);
-    tone(BUZZER_PIN, 330, 100);  // E4
-    delay(120);
-    tone(BUZZER_PIN, 392, 100);  // G4
-    delay(120);
-    tone(BUZZER_PIN, 523, 150);  // C5
+  // Queue the jingle on the first frame; leaving early cancels what's left
+  if (!welcomeJinglePlayed) {
+    welcomeNoteIdx = 0;
+    queueWelcomeNote(now);
     welcomeJinglePlayed = true;
   }
 
@@ -295,12 +789,19 @@ void handleWelcome(unsigned long now) {
   lcd.setCursor(0, 1);
   lcd.print("(C) 2026 by R.R.");
 
-  if (now - stateEnteredAt >= 6750UL) {
+  if (potHasMoved || now - stateEnteredAt >= 6750UL) {
     enterAppState(APP_PROGRAM_SELECT);
   }
 }
 
 //  handleProgramSelect
+// Pages come from layoutMenu().  On page 1 the slider's lower 80% picks a
+// program and the top 20% turns the page; on later pages 0-15% turns back,
+// 85-100% turns forward (except on the last page) and the middle picks.
+const int MENU_BACK_MAX       = 153;  // ≤ 15%: previous page
+const int MENU_FORWARD_FIRST  = 819;  // ≥ 80% on page 1: next page
+const int MENU_FORWARD_MIN    = 870;  // ≥ 85% on later pages: next page
+
 void handleProgramSelect(unsigned long now) {
   const char* msg = "Use slider to select program";
 
@@ -311,54 +812,49 @@ void handleProgramSelect(unsigned long now) {
     tickScroll(msg, 0, now, 4, true);
   }
 
+  bool firstPage = (selectionPage == 1);
+  bool lastPage  = (selectionPage == menuPageCount);
+  int  forwardAt = firstPage ? MENU_FORWARD_FIRST : MENU_FORWARD_MIN;
+
   //  Handle page transitions based on pot position
   // Only allow transitions after cooldown period to prevent jump-through
   if (now - pageChangedAt >= PAGE_TRANSITION_COOLDOWN) {
-    if (selectionPage == 1) {
-      if (potValue >= 819) {  // 80% → transition to page 2
-        selectionPage = 2;
-        potHasMoved = false;
-        pageChangedAt = now;
-        potValueAtPageChange = potValue;  // snapshot for movement gate
-        selectionGateOpen = false;        // require intentional movement
-      }
-    } else if (selectionPage == 2) {
-      if (potValue <= 153) {  // 15% → back to page 1
-        selectionPage = 1;
-        potHasMoved = false;
-        pageChangedAt = now;
-        selectionGateOpen = true;         // page 1 has no gate
-      } else if (potValue >= 870) {  // 85% → forward to page 3
-        selectionPage = 3;
-        potHasMoved = false;
-        pageChangedAt = now;
-        potValueAtPageChange = potValue;
-        selectionGateOpen = false;
-      }
-    } else if (selectionPage == 3) {
-      if (potValue <= 153) {  // 15% → back to page 2
-        selectionPage = 2;
-        potHasMoved = false;
-        pageChangedAt = now;
-        potValueAtPageChange = potValue;
-        selectionGateOpen = false;
-      }
+    if (!lastPage && potValue >= forwardAt) {
+      selectionPage++;
+      potHasMoved = false;
+      pageChangedAt = now;
+      potValueAtPageChange = potValue;  // snapshot for movement gate
+      selectionGateOpen = false;        // require intentional movement
+    } else if (!firstPage && potValue <= MENU_BACK_MAX) {
+      selectionPage--;
+      potHasMoved = false;
+      pageChangedAt = now;
+      potValueAtPageChange = potValue;
+      selectionGateOpen = (selectionPage == 1);  // page 1 has no gate
     }
+    firstPage = (selectionPage == 1);
+    lastPage  = (selectionPage == menuPageCount);
+    forwardAt = firstPage ? MENU_FORWARD_FIRST : MENU_FORWARD_MIN;
   }
 
-  //  Display bottom line based on current page
-  lcd.setCursor(0, 1);
-  if (selectionPage == 1) {
-    lcd.print("Sort | Primes  ");  // 15 chars
-    lcd.write((uint8_t)2);          // → at position 16
-  } else if (selectionPage == 2) {
-    lcd.write((uint8_t)3);          // ← at position 1
-    lcd.print(" Calculator   ");    // 14 chars (positions 2-15)
-    lcd.write((uint8_t)2);          // → at position 16
-  } else {  // page 3 (last page, no right arrow)
-    lcd.write((uint8_t)3);          // ← at position 1
-    lcd.print(" Game | ASI    ");   // 15 chars (positions 2-16)
+  int first = menuPageFirst[selectionPage - 1];
+  int count = menuPageFirst[selectionPage] - first;
+
+  //  Display bottom line: "← " on later pages, labels, "→" unless last page
+  char line[17];
+  memset(line, ' ', 16);
+  line[16] = '\0';
+  int col = firstPage ? 0 : 2;
+  for (int i = 0; i < count; i++) {
+    if (i > 0) { memcpy(line + col, " | ", 3); col += 3; }
+    int len = strlen(PROGRAMS[first + i].name);
+    memcpy(line + col, PROGRAMS[first + i].name, len);
+    col += len;
   }
+  if (!firstPage) line[0] = 3;  // ← custom character
+  if (!lastPage)  line[15] = 2; // → custom character
+  lcd.setCursor(0, 1);
+  for (int i = 0; i < 16; i++) lcd.write((uint8_t)line[i]);
 
   //  Open movement gate once pot moves far enough from page-change position
   if (!selectionGateOpen && abs(potValue - potValueAtPageChange) > GATE_MOVEMENT_THRESHOLD) {
@@ -368,25 +864,13 @@ void handleProgramSelect(unsigned long now) {
   }
 
   //  Handle program selection after 625ms hold
-  if (potHasMoved && (now - potLastMovedAt >= 625UL)) {
-    if (selectionPage == 1) {
-      if (potValue <= 409) {        // 0-40% → Sort
-        enterAppState(APP_SORT_TEST);
-      } else if (potValue <= 818) {  // 40-80% → Primes
-        enterAppState(APP_PRIMES);
-      }
-      // 80-100% is transition zone, no program entry
-    } else if (selectionPage == 2 && selectionGateOpen) {
-      if (potValue >= 154 && potValue <= 869) {  // 15-85% → Calculator
-        enterAppState(APP_CALCULATOR);
-      }
-      // 0-15% and 85-100% are transition zones
-    } else if (selectionPage == 3 && selectionGateOpen) {
-      if (potValue >= 154 && potValue <= 583) {  // 15-57% → Paddle Game
-        enterAppState(APP_PADDLE_GAME);
-      } else if (potValue >= 584) {  // 57-100% → ASI
-        enterAppState(APP_ASI);
-      }
+  // The pick zone is split evenly between the programs on the page.
+  if (potHasMoved && (now - potLastMovedAt >= 625UL) && (firstPage || selectionGateOpen)) {
+    int lo = firstPage ? 0 : MENU_BACK_MAX + 1;
+    int hi = lastPage ? 1023 : forwardAt - 1;
+    if (potValue >= lo && potValue <= hi) {
+      int pick = first + (int)((long)(potValue - lo) * count / (hi - lo + 1));
+      enterAppState(APP_FIRST_PROGRAM + pick);
     }
   }
 }
@@ -0,0 +1,170 @@
+#ifndef ANIM_TIMELINE_H
+#define ANIM_TIMELINE_H
+
+#include <Arduino.h>
+#include "sketch_shared.h"
+
+//  Keyframe animation timeline
+// A clip is a const table of keyframes, so on the R4 it stays in flash, and
+// the sketch plays up to ANIM_MAX_TRACKS clips at once:
+//
+//   ANIM_GLYPH  – a CGRAM slot steps through glyph bitmaps and is shown at a cell
+//   ANIM_FADE   – the backlight moves linearly between colours
+//   ANIM_BLINK  – a string at a cell is shown (value 1) or blanked (value 0)
+//
+// Clips loop every lengthMs; keys[0] must be at 0 ms.  animTick() runs once
+// per UI frame but only looks at a track when its ANIM_FRAME_MS frame clock
+// has moved on, and only touches the LCD when the value it works out differs
+// from the one on screen: a glyph clip uploads one bitmap per key, a blink
+// one string per key.
+//
+// A track belongs to the state it was played in.  Every enterXState() sets
+// stateEnteredAt, so programs start their animations from the enter function
+// and the old ones stop by themselves on the next state change; the new
+// state's enter function has already set the backlight and cleared the LCD.
+
+#define ANIM_MAX_TRACKS 4
+#define ANIM_FRAME_MS   40UL   // 25 frames a second
+
+enum AnimKind { ANIM_GLYPH, ANIM_FADE, ANIM_BLINK };
+
+struct AnimKey {
+  uint16_t atMs;    // into the loop
+  uint8_t  value;   // glyph or colour index; 1/0 for a blink
+};
+
+struct AnimClip {
+  uint8_t            kind;
+  uint8_t            slot;       // ANIM_GLYPH: CGRAM slot
+  uint16_t           lengthMs;
+  uint8_t            keyCount;
+  const AnimKey*     keys;
+  const byte       (*glyphs)[8]; // ANIM_GLYPH
+  const byte* const* colours;    // ANIM_FADE
+};
+
+struct AnimTrack {
+  const AnimClip* clip;          // NULL = free
+  unsigned long   startedAt;
+  unsigned long   stateAt;       // stateEnteredAt when it was played
+  uint32_t        frame;         // last frame looked at
+  uint32_t        shown;         // value on screen (RGB packed for a fade)
+  const char*     text;          // ANIM_BLINK
+  uint8_t         col, row;
+};
+
+#define ANIM_NOTHING_SHOWN 0xFFFFFFFFUL
+
+static AnimTrack animTracks[ANIM_MAX_TRACKS];
+
+//  Celebration: pulsing diamond (0-2), spinning line (3-6), sparkle (7),
+// 200 ms a frame in CGRAM slot 0
+static const byte CELEB_GLYPHS[8][8] = {
+  { 0b00100, 0b01110, 0b11111, 0b11111, 0b01110, 0b00100, 0b00000, 0b00000 },
+  { 0b00000, 0b00100, 0b01110, 0b11111, 0b01110, 0b00100, 0b00000, 0b00000 },
+  { 0b00000, 0b00000, 0b00100, 0b01110, 0b00100, 0b00000, 0b00000, 0b00000 },
+  { 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00000, 0b00000, 0b00000 },  // |
+  { 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b00000, 0b00000, 0b00000 },  // /
+  { 0b00000, 0b00000, 0b11111, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000 },  // —
+  { 0b10000, 0b01000, 0b00100, 0b00010, 0b00001, 0b00000, 0b00000, 0b00000 },  // backslash
+  { 0b10001, 0b01010, 0b00100, 0b01010, 0b10001, 0b00000, 0b00000, 0b00000 },  // X sparkle
+};
+static const AnimKey CELEB_GLYPH_KEYS[8] = {
+  { 0, 0 }, { 200, 1 }, { 400, 2 }, { 600, 3 }, { 800, 4 }, { 1000, 5 }, { 1200, 6 }, { 1400, 7 }
+};
+static const AnimClip CELEB_GLYPH_CLIP = {
+  ANIM_GLYPH, 0, 1600, 8, CELEB_GLYPH_KEYS, CELEB_GLYPHS, NULL
+};
+
+//  Celebration glow: the green result backlight brightens and back, 1.6 s
+static const byte        CELEB_GLOW_PALE[3]   = { 150, 255, 150 };
+static const byte* const CELEB_GLOW_COLOURS[2] = { COL_GREEN, CELEB_GLOW_PALE };
+static const AnimKey     CELEB_GLOW_KEYS[2]    = { { 0, 0 }, { 800, 1 } };
+static const AnimClip CELEB_GLOW_CLIP = {
+  ANIM_FADE, 0, 1600, 2, CELEB_GLOW_KEYS, NULL, CELEB_GLOW_COLOURS
+};
+
+//  Text blink: 500 ms on, 300 ms off
+static const AnimKey  BLINK_KEYS[2] = { { 0, 1 }, { 500, 0 } };
+static const AnimClip BLINK_CLIP = {
+  ANIM_BLINK, 0, 800, 2, BLINK_KEYS, NULL, NULL
+};
+
+// Starts clip at (col, row) with text for a blink; returns the track, or -1
+// if every track is busy.
+static int animPlay(const AnimClip* clip, uint8_t col = 0, uint8_t row = 0, const char* text = NULL) {
+  for (int i = 0; i < ANIM_MAX_TRACKS; i++) {
+    AnimTrack& t = animTracks[i];
+    if (t.clip != NULL && t.stateAt == stateEnteredAt) continue;
+    t.clip      = clip;
+    t.startedAt = millis();
+    t.stateAt   = stateEnteredAt;
+    t.frame     = ANIM_NOTHING_SHOWN;
+    t.shown     = ANIM_NOTHING_SHOWN;
+    t.text      = text;
+    t.col       = col;
+    t.row       = row;
+    return i;
+  }
+  return -1;
+}
+
+// The clip's value at ms into the loop: the key's value for glyphs and
+// blinks, the blended colour for a fade.
+static uint32_t animValueAt(const AnimClip* clip, uint32_t ms) {
+  uint8_t k = 0;
+  while (k + 1 < clip->keyCount && clip->keys[k + 1].atMs <= ms) k++;
+  const AnimKey& from = clip->keys[k];
+  if (clip->kind != ANIM_FADE) return from.value;
+
+  // Toward the next key, or back to the first at the end of the loop
+  const AnimKey& to  = clip->keys[(k + 1 < clip->keyCount) ? k + 1 : 0];
+  uint32_t       end = (k + 1 < clip->keyCount) ? to.atMs : clip->lengthMs;
+  uint32_t       pos = (ms - from.atMs) * 256 / (end - from.atMs);
+  const byte*    a   = clip->colours[from.value];
+  const byte*    b   = clip->colours[to.value];
+  uint32_t rgb = 0;
+  for (int c = 0; c < 3; c++) {
+    rgb = (rgb << 8) | (uint8_t)(a[c] + ((int)b[c] - a[c]) * (int)pos / 256);
+  }
+  return rgb;
+}
+
+static void animShow(AnimTrack& t, uint32_t value) {
+  const AnimClip* clip = t.clip;
+  if (clip->kind == ANIM_GLYPH) {
+    byte glyph[8];   // createChar() takes a writable buffer
+    memcpy(glyph, clip->glyphs[value], 8);
+    lcd.createChar(clip->slot, glyph);
+    lcd.setCursor(t.col, t.row);   // createChar moves the cursor
+    lcd.write(clip->slot);
+  } else if (clip->kind == ANIM_FADE) {
+    byte col[3] = { (byte)(value >> 16), (byte)(value >> 8), (byte)value };
+    setBacklight(col);
+  } else {
+    lcd.setCursor(t.col, t.row);
+    for (const char* p = t.text; *p; p++) lcd.write(value ? (uint8_t)*p : (uint8_t)' ');
+  }
+}
+
+// Advances every track; tracks from an earlier state are dropped untouched.
+static void animTick(unsigned long now) {
+  for (int i = 0; i < ANIM_MAX_TRACKS; i++) {
+    AnimTrack& t = animTracks[i];
+    if (t.clip == NULL) continue;
+    if (t.stateAt != stateEnteredAt) {
+      t.clip = NULL;
+      continue;
+    }
+    uint32_t frame = (now - t.startedAt) / ANIM_FRAME_MS;
+    if (frame == t.frame) continue;
+    t.frame = frame;
+
+    uint32_t value = animValueAt(t.clip, frame * ANIM_FRAME_MS % t.clip->lengthMs);
+    if (value == t.shown) continue;
+    t.shown = value;
+    animShow(t, value);
+  }
+}
+
+#endif
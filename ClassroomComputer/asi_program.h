@@ -2,6 +2,8 @@
 #define ASI_PROGRAM_H
 
 #include <Arduino.h>
+#include "sketch_shared.h"
+#include "program_registry.h"
 
 //  ASI Program states
 enum ASIState {
@@ -24,17 +26,6 @@ void handleASI(unsigned long now);
 static void tickASIWelcomeJingle(unsigned long now);
 static void tickASIDoneJingle(unsigned long now);
 
-//  External references (defined in main sketch)
-extern rgb_lcd lcd;
-extern const byte COL_PINK[3];
-extern unsigned long stateEnteredAt;
-extern int scrollOffset;
-extern unsigned long scrollTickAt;
-extern const int BUZZER_PIN;
-extern int scrollSpeed;
-extern void enterAppState(int nextState);
-extern void tickScroll(const char* str, uint8_t row, unsigned long now, int wrapGap, bool loop);
-
 //  Implementations
 
 void enterASIState(ASIState next) {
@@ -43,7 +34,7 @@ void enterASIState(ASIState next) {
   scrollOffset   = 0;
   scrollTickAt   = millis();
 
-  lcd.setRGB(COL_PINK[0], COL_PINK[1], COL_PINK[2]);
+  setBacklight(COL_PINK);
   lcd.clear();
 
   if (next == ASI_BLACKOUT) {
@@ -92,7 +83,7 @@ static void tickASIBlackoutDits(unsigned long now) {
   if (lastStateStart != stateEnteredAt) { lastStateStart = stateEnteredAt; noteIdx = -1; }
 
   unsigned long e = now - stateEnteredAt;
-  if      (noteIdx < 0  && e >=   0UL) { tone(BUZZER_PIN, 2800, 35); noteIdx = 0; }
+  if      (noteIdx < 0)                 { tone(BUZZER_PIN, 2800, 35); noteIdx = 0; }
   else if (noteIdx == 0 && e >=  70UL) { tone(BUZZER_PIN, 2800, 35); noteIdx = 1; }
   else if (noteIdx == 1 && e >= 140UL) { tone(BUZZER_PIN, 2800, 35); noteIdx = 2; }
   else if (noteIdx == 2 && e >= 210UL) { tone(BUZZER_PIN, 2800, 35); noteIdx = 3; }
@@ -158,4 +149,14 @@ void handleASI(unsigned long now) {
   }
 }
 
+//  Registry entry (see program_registry.h)
+static void asiEnter() { enterASIState(ASI_WELCOME_1); }
+
+constexpr ProgramInfo ASI_PROGRAM = {
+  "ASI", asiEnter, handleASI, NULL,
+  0,
+  0,
+  NULL
+};
+
 #endif
@@ -0,0 +1,418 @@
+#ifndef ASTEROIDS_GAME_H
+#define ASTEROIDS_GAME_H
+
+#include <Arduino.h>
+#include "kv_store.h"
+#include "sketch_shared.h"
+#include "program_registry.h"
+
+//  Asteroids – port of snippets/arduino_asteroids.ino to the 16x2 LCD.
+// The screen is turned on its side: the ship sits in column 0 and is steered
+// up and down the 16 pixel rows with the slider, asteroids drift in from the
+// right, and the ship fires automatically.  Scoring follows the original:
+// +2 per hit, -1 per asteroid that slips past, game over on contact.
+
+//  Asteroids states
+enum AsteroidsState {
+  AST_TITLE,         // "Asteroids" for 1.5 s
+  AST_INSTRUCTIONS,  // "Slider steers / ship auto-fires" for 2.5 s
+  AST_PLAYING,       // Active gameplay until the ship is hit
+  AST_OVER           // "Game Over! [fps] / Score: X" for 3.5 s
+};
+
+//  Playfield (pixels, 5x8 per character cell) and Q8.8 fixed point
+static const int AST_FIELD_W   = 80;
+static const int AST_FIELD_H   = 16;
+static const int AST_FX_SHIFT  = 8;             // 256 = one pixel
+static const int AST_SHIP_H    = 3;             // ship is 3 pixel rows tall
+static const int AST_HIT_PX    = 3;             // bullet/asteroid hit distance
+static const int AST_SHIP_SLOTS[2] = {4, 6};    // CGRAM slots for the ship glyph
+
+//  Object pools.  Each pool keeps its live objects packed at the front
+// (indices 0..count-1) in structure-of-arrays layout, so updates are tight
+// loops over contiguous int16_t arrays with no per-object active flag to
+// test.  Spent bullets are removed by swapping the last live one into the
+// hole; destroyed asteroids are recycled in place by respawning them.
+static const int AST_MAX_ASTEROIDS = 40;
+static const int AST_MAX_BULLETS   = 8;
+
+static int16_t astX[AST_MAX_ASTEROIDS],  astY[AST_MAX_ASTEROIDS];   // Q8.8 pixels
+static int16_t astVX[AST_MAX_ASTEROIDS], astVY[AST_MAX_ASTEROIDS];  // Q8.8 per tick
+static int     astCount = 0;
+
+static int16_t bulX[AST_MAX_BULLETS], bulY[AST_MAX_BULLETS];
+static int     bulCount = 0;
+
+//  Coarse collision grid: one bucket per character cell.  Rebuilt every tick
+// as singly linked lists through astNext, so a bullet only tests the
+// asteroids in the cells around it instead of every asteroid.
+static const int AST_GRID_COLS = 16;
+static const int AST_GRID_ROWS = 2;
+static int8_t astGridHead[AST_GRID_ROWS * AST_GRID_COLS];
+static int8_t astNext[AST_MAX_ASTEROIDS];
+
+//  Timing
+static const unsigned long AST_SIM_STEP_MS        = 20;   // 50 Hz physics
+static const unsigned long AST_RENDER_INTERVAL_MS = 50;   // 20 fps display
+static const unsigned long AST_FIRE_INTERVAL_MS   = 260;
+static const int           AST_MAX_SIM_STEPS      = 4;
+
+//  Game-specific state
+static AsteroidsState astState = AST_TITLE;
+static int           astShipY     = 6;   // top pixel row of the ship (0-13)
+static int           astScore     = 0;
+static int           astFinalScore = 0;
+static long          astBestScore  = 0;      // high score from the KV store
+static bool          astNewBest    = false;
+static unsigned long astSimClock  = 0;
+static unsigned long astLastShot  = 0;
+static char          astDrawn[2][16];    // what is on the LCD now
+static int           astDrawnShipY = -1;
+
+//  Frame stats for the Game Over screen / Serial
+static unsigned long astFrames      = 0;
+static unsigned long astFirstFrameUs = 0;
+static unsigned long astLastFrameUs  = 0;
+static unsigned long astMaxFrameUs   = 0;
+static int           astPeakAsteroids = 0;
+static int           astFps = 0;
+
+//  Forward declarations
+void enterAsteroidsState(AsteroidsState next);
+void handleAsteroids(unsigned long now);
+
+//  Game helpers
+static void astSpawn(int i);
+static void astStep(unsigned long now);
+static void astRender();
+static void tickAsteroidsOverSound(unsigned long now);
+static void astReport();
+
+//  State handler forward declarations
+static void handleAstTitle(unsigned long now);
+static void handleAstInstructions(unsigned long now);
+static void handleAstPlaying(unsigned long now);
+static void handleAstOver(unsigned long now);
+
+//  Implementations
+
+void enterAsteroidsState(AsteroidsState next) {
+  astState = next;
+  stateEnteredAt = millis();
+  potHasMoved = false;
+  setUiFrameMs(next == AST_PLAYING ? 1 : UI_FRAME_MS);
+
+  if (next == AST_PLAYING) {
+    randomSeed(micros());
+    astScore = 0;
+    bulCount = 0;
+    astCount = 0;
+    for (int i = 0; i < 6; i++) astSpawn(astCount++);  // the original's MAX_ASTEROIDS
+    astSimClock = millis();
+    astLastShot = millis();
+    astFrames = 0;
+    astMaxFrameUs = 0;
+    astPeakAsteroids = astCount;
+    memset(astDrawn, ' ', sizeof(astDrawn));
+    astDrawnShipY = -1;
+  }
+
+  if (next == AST_TITLE) astBestScore = kvBestScore(KV_SCORE_ASTEROIDS);
+
+  if (next == AST_OVER) setBacklight(COL_GREEN);
+  else                  setBacklight(COL_PINK);
+  lcd.clear();
+}
+
+void handleAsteroids(unsigned long now) {
+  switch (astState) {
+    case AST_TITLE:        handleAstTitle(now);        break;
+    case AST_INSTRUCTIONS: handleAstInstructions(now); break;
+    case AST_PLAYING:      handleAstPlaying(now);      break;
+    case AST_OVER:         handleAstOver(now);         break;
+  }
+}
+
+//  Game helper implementations
+
+// (Re)places asteroid i just off the right edge with a random row and speed.
+static void astSpawn(int i) {
+  astX[i]  = (int16_t)((AST_FIELD_W + random(0, 40)) << AST_FX_SHIFT);
+  astY[i]  = (int16_t)(random(0, AST_FIELD_H - 2) << AST_FX_SHIFT);
+  int bonus = constrain(astScore, 0, 50) * 4;            // faster as the score grows
+  astVX[i] = (int16_t)-random(64, 200 + bonus);         // 0.25-1.6 px per tick
+  astVY[i] = (int16_t)random(-24, 25);                  // slight drift
+}
+
+// Removes bullet i by moving the last live one into its slot.
+static void bulKill(int i) {
+  bulCount--;
+  bulX[i] = bulX[bulCount];
+  bulY[i] = bulY[bulCount];
+}
+
+static int astCellIndex(int16_t x, int16_t y) {
+  int cx = (x >> AST_FX_SHIFT) / 5;
+  int cy = (y >> AST_FX_SHIFT) / 8;
+  if (cx < 0 || cx >= AST_GRID_COLS || cy < 0 || cy >= AST_GRID_ROWS) return -1;
+  return cy * AST_GRID_COLS + cx;
+}
+
+// One physics tick: move, bucket, collide, spawn.
+static void astStep(unsigned long now) {
+  // Ship follows the filtered slider
+  astShipY = map(potFiltered, 0, 1023, 0, AST_FIELD_H - AST_SHIP_H);
+
+  // Auto-fire from the ship's nose
+  if (now - astLastShot >= AST_FIRE_INTERVAL_MS && bulCount < AST_MAX_BULLETS) {
+    bulX[bulCount] = (int16_t)(5 << AST_FX_SHIFT);
+    bulY[bulCount] = (int16_t)((astShipY + 1) << AST_FX_SHIFT);
+    bulCount++;
+    astLastShot = now;
+    tone(BUZZER_PIN, 800, 15);
+  }
+
+  // Move bullets (3 px per tick) and drop those that left the field
+  for (int i = bulCount - 1; i >= 0; i--) {
+    bulX[i] += 3 << AST_FX_SHIFT;
+    if ((bulX[i] >> AST_FX_SHIFT) >= AST_FIELD_W) bulKill(i);
+  }
+
+  // Move asteroids, bounce off top/bottom, recycle those that got past
+  const int16_t maxY = (int16_t)((AST_FIELD_H - 2) << AST_FX_SHIFT);
+  for (int i = astCount - 1; i >= 0; i--) {
+    astX[i] += astVX[i];
+    astY[i] += astVY[i];
+    if (astY[i] < 0)    { astY[i] = 0;    astVY[i] = -astVY[i]; }
+    if (astY[i] > maxY) { astY[i] = maxY; astVY[i] = -astVY[i]; }
+    if (astX[i] < 0) {
+      astScore -= 1;
+      astSpawn(i);
+    }
+  }
+
+  // Bucket asteroids into the grid
+  memset(astGridHead, -1, sizeof(astGridHead));
+  for (int i = 0; i < astCount; i++) {
+    int c = astCellIndex(astX[i], astY[i]);
+    if (c < 0) { astNext[i] = -1; continue; }   // still off-screen
+    astNext[i] = astGridHead[c];
+    astGridHead[c] = (int8_t)i;
+  }
+
+  // Bullets vs asteroids: only the 3x2 block of cells around the bullet
+  for (int b = bulCount - 1; b >= 0; b--) {
+    int bx = bulX[b] >> AST_FX_SHIFT;
+    int by = bulY[b] >> AST_FX_SHIFT;
+    int cx = bx / 5;
+    int hit = -1;
+    for (int gx = cx - 1; gx <= cx + 1 && hit < 0; gx++) {
+      if (gx < 0 || gx >= AST_GRID_COLS) continue;
+      for (int gy = 0; gy < AST_GRID_ROWS && hit < 0; gy++) {
+        for (int a = astGridHead[gy * AST_GRID_COLS + gx]; a >= 0; a = astNext[a]) {
+          if (abs((astX[a] >> AST_FX_SHIFT) - bx) < AST_HIT_PX &&
+              abs((astY[a] >> AST_FX_SHIFT) - by) < AST_HIT_PX) {
+            hit = a;
+            break;
+          }
+        }
+      }
+    }
+    if (hit >= 0) {
+      bulKill(b);
+      astSpawn(hit);   // respawned off-screen, so later distance tests miss it
+      astScore += 2;
+      tone(BUZZER_PIN, 1000, 30);
+    }
+  }
+
+  // Ship vs asteroids: the ship occupies cell column 0 only
+  for (int gy = 0; gy < AST_GRID_ROWS; gy++) {
+    for (int gx = 0; gx <= 1; gx++) {
+      for (int a = astGridHead[gy * AST_GRID_COLS + gx]; a >= 0; a = astNext[a]) {
+        int ax = astX[a] >> AST_FX_SHIFT;
+        int ay = astY[a] >> AST_FX_SHIFT;
+        if (ax < 4 && ay + 1 >= astShipY && ay <= astShipY + AST_SHIP_H - 1) {
+          astFinalScore = astScore;
+          astNewBest    = kvRecordScore(KV_SCORE_ASTEROIDS, astFinalScore);
+          astReport();
+          enterAsteroidsState(AST_OVER);
+          return;
+        }
+      }
+    }
+  }
+
+  // Difficulty: one more asteroid in the pool for every 4 points
+  int target = 6 + (astScore > 0 ? astScore / 4 : 0);
+  if (target > AST_MAX_ASTEROIDS) target = AST_MAX_ASTEROIDS;
+  if (astCount < target) astSpawn(astCount++);
+  if (astCount > astPeakAsteroids) astPeakAsteroids = astCount;
+}
+
+// Draws the frame as a 16x2 character map and writes only changed cells.
+// The ship is a custom glyph at pixel resolution; asteroids and bullets use
+// ROM characters so any number of them fit without CGRAM slots.
+static void astRender() {
+  char frame[2][16];
+  memset(frame, ' ', sizeof(frame));
+
+  for (int b = 0; b < bulCount; b++) {
+    int c = astCellIndex(bulX[b], bulY[b]);
+    if (c >= 0) frame[c / 16][c % 16] = '-';
+  }
+  for (int a = 0; a < astCount; a++) {
+    int c = astCellIndex(astX[a], astY[a]);
+    if (c >= 0) frame[c / 16][c % 16] = '*';
+  }
+
+  // Ship glyphs: rows 0-7 go to slot 4 (cell 0,0), rows 8-15 to slot 6 (cell 0,1)
+  if (astShipY != astDrawnShipY) {
+    byte glyph[2][8];
+    memset(glyph, 0, sizeof(glyph));
+    const byte shape[AST_SHIP_H] = {0b11000, 0b11110, 0b11000};
+    for (int r = 0; r < AST_SHIP_H; r++) {
+      int y = astShipY + r;
+      glyph[y / 8][y % 8] = shape[r];
+    }
+    lcd.createChar(AST_SHIP_SLOTS[0], glyph[0]);
+    lcd.createChar(AST_SHIP_SLOTS[1], glyph[1]);
+    astDrawnShipY = astShipY;
+    astDrawn[0][0] = 0;   // force the ship cells to be rewritten
+    astDrawn[1][0] = 0;
+  }
+  frame[0][0] = (char)AST_SHIP_SLOTS[0];
+  frame[1][0] = (char)AST_SHIP_SLOTS[1];
+
+  for (int row = 0; row < 2; row++) {
+    int col = 0;
+    while (col < 16) {
+      if (frame[row][col] == astDrawn[row][col]) { col++; continue; }
+      // Write the whole run of changed cells with one cursor move
+      lcd.setCursor(col, row);
+      while (col < 16 && frame[row][col] != astDrawn[row][col]) {
+        lcd.write((uint8_t)frame[row][col]);
+        astDrawn[row][col] = frame[row][col];
+        col++;
+      }
+    }
+  }
+}
+
+// Computes the achieved frame rate and prints the run's stats over Serial.
+static void astReport() {
+  astFps = 0;
+  if (astFrames > 1 && astLastFrameUs != astFirstFrameUs) {
+    astFps = (int)((astFrames - 1) * 1000000.0 / (astLastFrameUs - astFirstFrameUs) + 0.5);
+  }
+  Serial.print("asteroids: fps=");
+  Serial.print(astFps);
+  Serial.print(" max_render_ms=");
+  Serial.print(astMaxFrameUs / 1000.0, 2);
+  Serial.print(" peak_asteroids=");
+  Serial.print(astPeakAsteroids);
+  Serial.print(" score=");
+  Serial.println(astFinalScore);
+}
+
+// Non-blocking game-over sound: 600 → 400 → 200 Hz, as in the original but
+// without the delay() calls.
+static void tickAsteroidsOverSound(unsigned long now) {
+  static unsigned long lastStateStart = 0;
+  static int noteIdx = -1;
+  if (lastStateStart != stateEnteredAt) { lastStateStart = stateEnteredAt; noteIdx = -1; }
+
+  unsigned long e = now - stateEnteredAt;
+  if      (noteIdx < 0)                 { tone(BUZZER_PIN, 600, 300); noteIdx = 0; }
+  else if (noteIdx == 0 && e >= 350UL) { tone(BUZZER_PIN, 400, 300); noteIdx = 1; }
+  else if (noteIdx == 1 && e >= 700UL) { tone(BUZZER_PIN, 200, 500); noteIdx = 2; }
+}
+
+//  State handlers
+
+static void handleAstTitle(unsigned long now) {
+  lcd.setCursor(0, 0);
+  lcd.print("Asteroids");
+  if (astBestScore > 0) {
+    lcd.setCursor(0, 1);
+    lcd.print("Best: ");
+    lcd.print(astBestScore);
+  }
+
+  if (now - stateEnteredAt >= 1500UL) {
+    enterAsteroidsState(AST_INSTRUCTIONS);
+  }
+}
+
+static void handleAstInstructions(unsigned long now) {
+  lcd.setCursor(0, 0);
+  lcd.print("Slider steers,");
+  lcd.setCursor(0, 1);
+  lcd.print("ship auto-fires");
+
+  if (now - stateEnteredAt >= 2500UL) {
+    enterAsteroidsState(AST_PLAYING);
+  }
+}
+
+static void handleAstPlaying(unsigned long now) {
+  static unsigned long lastRenderAt = 0;
+
+  // Fixed-timestep physics; drop time beyond AST_MAX_SIM_STEPS after a stall
+  int steps = 0;
+  while (now - astSimClock >= AST_SIM_STEP_MS && astState == AST_PLAYING) {
+    if (steps == AST_MAX_SIM_STEPS) { astSimClock = now; break; }
+    samplePot(millis());
+    astStep(astSimClock + AST_SIM_STEP_MS);
+    astSimClock += AST_SIM_STEP_MS;
+    steps++;
+  }
+  if (astState != AST_PLAYING) return;
+
+  if (astFrames == 0 || now - lastRenderAt >= AST_RENDER_INTERVAL_MS) {
+    lastRenderAt = now;
+    unsigned long t0 = micros();
+    astRender();
+    unsigned long t1 = micros();
+    if (t1 - t0 > astMaxFrameUs) astMaxFrameUs = t1 - t0;
+    if (astFrames == 0) astFirstFrameUs = t1;
+    astLastFrameUs = t1;
+    astFrames++;
+  }
+}
+
+static void handleAstOver(unsigned long now) {
+  lcd.setCursor(0, 0);
+  lcd.print("Game Over!");
+  lcd.setCursor(astFps >= 100 ? 10 : (astFps >= 10 ? 11 : 12), 0);
+  lcd.print(astFps);
+  lcd.print("fps");
+  lcd.setCursor(0, 1);
+  lcd.print("Score: ");
+  lcd.print(astFinalScore);
+  lcd.print(astNewBest ? "  Best!" : "     ");  // or clear leftover digits
+
+  tickAsteroidsOverSound(now);
+
+  if (now - stateEnteredAt >= 3500UL) {
+    enterAppState(1);  // APP_PROGRAM_SELECT
+  }
+}
+
+//  Registry entry (see program_registry.h)
+static void asteroidsEnter() { enterAsteroidsState(AST_TITLE); }
+static void asteroidsExit()  { noTone(BUZZER_PIN); }
+
+constexpr size_t ASTEROIDS_STATIC_BYTES =
+  sizeof(astX) + sizeof(astY) + sizeof(astVX) + sizeof(astVY) + sizeof(bulX) + sizeof(bulY) +
+  sizeof(astGridHead) + sizeof(astNext) + sizeof(astDrawn);
+static_assert(ASTEROIDS_STATIC_BYTES <= UINT16_MAX, "ASTEROIDS_STATIC_BYTES does not fit ProgramInfo::staticBytes");
+
+constexpr ProgramInfo ASTEROIDS_PROGRAM = {
+  "Asteroids", asteroidsEnter, handleAsteroids, asteroidsExit,
+  ASTEROIDS_STATIC_BYTES,
+  CGRAM_SLOT(4) | CGRAM_SLOT(6),
+  NULL
+};
+
+#endif
@@ -0,0 +1,451 @@
+#ifndef BENCH_SERIAL_H
+#define BENCH_SERIAL_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+//  Headless batch benchmarks over Serial
+// Type a command line on the Serial monitor (BENCH_BAUD, newline-terminated)
+// and the sketch sweeps the requested parameters, printing one CSV row per
+// measurement.  The LCD program keeps running; one measurement is taken per
+// loop() call so "stop" is noticed between measurements, and a primes or pi
+// measurement is cut into slices of the serial task's budget.  Sort rows
+// wait while the Sort Test's own run is using the sort buffers, and pi rows
+// while the Primes program is counting in piSegment (a row the count
+// interrupts starts over).
+//
+//   sort   n=10,50,100 algo=bubble,merge dist=random,sorted,reversed,few reps=3 seed=1
+//   primes n=1000:30000:1000 reps=2
+//   pi     n=1000000,1000000000 algo=meissel,sieve
+//   stop
+//   help
+//   trace rec|play|stop|dump|clear|load <hex>   (see pot_trace.h)
+//   power [reset]                               (awake time per state)
+//   tasks                                       (scheduler statistics)
+//   mem [reset]                                 (RAM use and stack peak per state)
+//   vm load <hex>|run|stop|save|dump|clear|bench [n]   (see vm_program.h)
+//   micro [save|stop] [pct=10]                  (kernel microbenchmarks, JSON; see micro_bench.h)
+//   logger [run|dump|synth on|off]              (sensor window statistics; see logger_program.h)
+//   boot [resume on|off]                        (start-up times; resume the last program)
+//   xsort begin|put|end|stop                    (external merge sort; see ext_sort.h)
+//
+// Lists are comma separated; a:b:step expands to a range.  Missing keys take
+// the defaults shown by "help".  Output columns:
+//   kind,algo,dist,n,rep,us,result
+// where result is 1/0 (sorted correctly) for sorts, p_N for primes and pi(n)
+// for pi.  The sieve count is a plain reference for checking the Meissel one
+// and only goes up to PI_SIEVE_MAX.
+//
+// Host builds (no ARDUINO define) read commands from stdin and write the CSV
+// to stdout, so sweeps can be scripted: echo "sort n=10:500:10" | host/build/sketch
+// (make -C host builds it).
+
+#define BENCH_BAUD        115200
+#define BENCH_LINE_MAX    96
+#define BENCH_MAX_VALUES  32
+#define BENCH_MAX_SORT_N  500     // size of sortBuf / mergeTmp
+#define BENCH_MAX_PRIME_N 200000L
+#define BENCH_MAX_PI_N    2147483647L  // n is a long
+
+enum BenchKind  { BENCH_IDLE, BENCH_SORT, BENCH_PRIMES, BENCH_PI };
+enum BenchAlgo  { BENCH_BUBBLE, BENCH_MERGE, BENCH_TRIAL, BENCH_MEISSEL, BENCH_SIEVE };
+enum BenchDist  { BENCH_RANDOM, BENCH_SORTED, BENCH_REVERSED, BENCH_FEW };
+
+static const char* const BENCH_ALGO_NAMES[] = { "bubble", "merge", "trial", "meissel", "sieve" };
+static const char* const BENCH_DIST_NAMES[] = { "random", "sorted", "reversed", "few" };
+
+//  Sweep in progress – nested loops n × algo × dist × rep, n outermost
+struct BenchSweep {
+  BenchKind     kind;
+  long          n[BENCH_MAX_VALUES];
+  uint8_t       nCount;
+  uint8_t       algo[3];
+  uint8_t       algoCount;
+  uint8_t       dist[4];
+  uint8_t       distCount;
+  int           reps;
+  uint8_t       ni, ai, di;    // cursor
+  int           rep;
+  unsigned long startedAt;     // millis() when the sweep began
+  unsigned long rows;
+  bool          waiting;       // told the user the sweep waits for a program
+  bool          slicing;       // a primes or pi measurement is part done:
+  long          count;         //   primes found so far
+  unsigned long candidate;     //   last odd number tested (pi: next segment)
+  unsigned long spentUs;       //   time spent counting
+};
+
+static BenchSweep benchSweep;
+static char       benchLine[BENCH_LINE_MAX];
+static uint8_t    benchLineLen = 0;
+static bool       benchLineReady = false;  // complete line waiting in benchLine
+
+static void traceCommand(char* args);  // pot_trace.h
+static void vmCommand(char* args);     // vm_program.h
+static void microCommand(char* args);  // micro_bench.h
+static void loggerCommand(char* args); // logger_program.h
+static void xsortCommand(char* args);  // ext_sort.h
+void powerCommand(char* args);         // ClassroomComputer.ino
+void memCommand(char* args);           // ClassroomComputer.ino
+void bootCommand(char* args);          // ClassroomComputer.ino
+
+//  I/O
+#ifdef ARDUINO
+static int benchReadChar() {
+  return Serial.available() ? Serial.read() : -1;
+}
+
+static void benchWrite(const char* s) {
+  Serial.print(s);
+}
+#else
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+
+// stdin is made non-blocking for polling.  A terminal shares that flag with
+// the shell, so the old flags go back on exit and on the usual signals.
+static int  benchStdinFlags = -1;
+static bool benchStdinEof   = false;  // stdin is closed; host/sketch.cpp exits once idle
+
+static void benchRestoreStdin() {
+  if (benchStdinFlags >= 0) fcntl(0, F_SETFL, benchStdinFlags);
+}
+
+static void benchRestoreStdinOnSignal(int sig) {
+  benchRestoreStdin();
+  signal(sig, SIG_DFL);
+  raise(sig);
+}
+
+static int benchReadChar() {
+  static bool nonBlocking = false;
+  if (!nonBlocking) {
+    nonBlocking     = true;
+    benchStdinFlags = fcntl(0, F_GETFL);
+    if (benchStdinFlags >= 0) {
+      fcntl(0, F_SETFL, benchStdinFlags | O_NONBLOCK);
+      atexit(benchRestoreStdin);
+      signal(SIGINT,  benchRestoreStdinOnSignal);
+      signal(SIGTERM, benchRestoreStdinOnSignal);
+      signal(SIGHUP,  benchRestoreStdinOnSignal);
+    }
+  }
+  unsigned char c;
+  ssize_t got = read(0, &c, 1);
+  if (got == 0) benchStdinEof = true;
+  return (got == 1) ? c : -1;
+}
+
+static void benchWrite(const char* s) {
+  fputs(s, stdout);
+  fflush(stdout);
+}
+#endif
+
+static void benchPrintf(const char* fmt, ...) {
+  char buf[128];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  benchWrite(buf);
+}
+
+//  Command parsing
+
+// Index of name in names[], or -1.
+static int benchLookup(const char* name, int len, const char* const* names, int count) {
+  for (int i = 0; i < count; i++) {
+    if ((int)strlen(names[i]) == len && strncmp(names[i], name, len) == 0) return i;
+  }
+  return -1;
+}
+
+// Parses "a,b,c" and "a:b:step" items into out[]; returns the count.
+static int benchParseNumbers(const char* s, long* out, int maxCount) {
+  int count = 0;
+  while (*s && count < maxCount) {
+    char* end;
+    long a = strtol(s, &end, 10);
+    if (end == s) break;
+    s = end;
+    if (*s == ':') {
+      long b = strtol(s + 1, &end, 10);
+      s = end;
+      long step = 1;
+      if (*s == ':') { step = strtol(s + 1, &end, 10); s = end; }
+      if (step <= 0) step = 1;
+      for (long v = a; v <= b && count < maxCount; v += step) out[count++] = v;
+    } else {
+      out[count++] = a;
+    }
+    if (*s == ',') s++;
+  }
+  return count;
+}
+
+// Parses "name,name" against names[] into out[]; returns the count.
+static int benchParseNames(const char* s, uint8_t* out, int maxCount,
+                           const char* const* names, int nameCount, int offset) {
+  int count = 0;
+  while (*s && count < maxCount) {
+    const char* end = strchr(s, ',');
+    int len = end ? (int)(end - s) : (int)strlen(s);
+    int idx = benchLookup(s, len, names, nameCount);
+    if (idx >= 0) out[count++] = (uint8_t)(idx + offset);
+    else          benchPrintf("# unknown value '%.*s'\n", len, s);
+    if (!end) break;
+    s = end + 1;
+  }
+  return count;
+}
+
+static void benchHelp() {
+  benchWrite("# commands:\n");
+  benchWrite("#   sort   n=10,100:500:100 algo=bubble,merge dist=random,sorted,reversed,few reps=1 seed=1\n");
+  benchWrite("#   primes n=1000,10000 reps=1\n");
+  benchWrite("#   pi     n=1000000 algo=meissel,sieve reps=1\n");
+  benchWrite("#   trace rec|play|stop|dump|clear|load <hex>\n");
+  benchWrite("#   power [reset]\n");
+  benchWrite("#   tasks\n");
+  benchWrite("#   mem [reset]\n");
+  benchWrite("#   vm load <hex>|run|stop|save|dump|clear|bench [n]\n");
+  benchWrite("#   micro [save|stop] [pct=10]\n");
+  benchWrite("#   logger [run|dump|synth on|off]\n");
+  benchWrite("#   boot [resume on|off]\n");
+  benchWrite("#   xsort begin [run=256] [ways=8] | put v v ... | end | stop\n");
+  benchWrite("#   stop | help\n");
+  benchWrite("# defaults: sort n=100 algo=bubble,merge dist=random reps=1; primes n=1000 reps=1\n");
+}
+
+// One CSV row per registered task; period 0 = background.
+static void benchTasks() {
+  benchWrite("task,period_ms,prio,budget_us,runs,late,overruns,max_us\n");
+  for (int i = 0; i < TASK_MAX; i++) {
+    const Task& t = tasks[i];
+    if (!t.active) continue;
+    benchPrintf("%s,%lu,%u,%lu,%lu,%lu,%lu,%lu\n", t.name, t.oneShot ? 0UL : t.periodMs,
+                t.priority, t.budgetUs, t.runs, t.late, t.overruns, t.maxUs);
+  }
+}
+
+// Sets up benchSweep from one command line.
+static void benchCommand(char* line) {
+  char* tok = strtok(line, " \t\r");
+  if (!tok) return;
+
+  if (strcmp(tok, "help") == 0) { benchHelp(); return; }
+  if (strcmp(tok, "trace") == 0) { traceCommand(strtok(NULL, "")); return; }
+  if (strcmp(tok, "power") == 0) { powerCommand(strtok(NULL, "")); return; }
+  if (strcmp(tok, "tasks") == 0) { benchTasks(); return; }
+  if (strcmp(tok, "mem") == 0)   { memCommand(strtok(NULL, "")); return; }
+  if (strcmp(tok, "vm") == 0)    { vmCommand(strtok(NULL, "")); return; }
+  if (strcmp(tok, "micro") == 0) { microCommand(strtok(NULL, "")); return; }
+  if (strcmp(tok, "logger") == 0) { loggerCommand(strtok(NULL, "")); return; }
+  if (strcmp(tok, "boot") == 0)  { bootCommand(strtok(NULL, "")); return; }
+  if (strcmp(tok, "xsort") == 0) { xsortCommand(strtok(NULL, "")); return; }
+  if (strcmp(tok, "stop") == 0) {
+    if (benchSweep.kind != BENCH_IDLE) benchPrintf("# stopped after %lu rows\n", benchSweep.rows);
+    benchSweep.kind = BENCH_IDLE;
+    return;
+  }
+
+  BenchSweep s;
+  memset(&s, 0, sizeof(s));
+  if      (strcmp(tok, "sort") == 0)   s.kind = BENCH_SORT;
+  else if (strcmp(tok, "primes") == 0) s.kind = BENCH_PRIMES;
+  else if (strcmp(tok, "pi") == 0)     s.kind = BENCH_PI;
+  else { benchPrintf("# unknown command '%s' (try help)\n", tok); return; }
+
+  // Defaults
+  s.n[0] = (s.kind == BENCH_SORT) ? 100 : (s.kind == BENCH_PI) ? 1000000 : 1000;
+  s.nCount = 1;
+  if (s.kind == BENCH_SORT) {
+    s.algo[0] = BENCH_BUBBLE; s.algo[1] = BENCH_MERGE; s.algoCount = 2;
+  } else if (s.kind == BENCH_PI) {
+    s.algo[0] = BENCH_MEISSEL; s.algo[1] = BENCH_SIEVE; s.algoCount = 2;
+  } else {
+    s.algo[0] = BENCH_TRIAL; s.algoCount = 1;
+  }
+  s.dist[0] = BENCH_RANDOM; s.distCount = 1;
+  s.reps = 1;
+
+  while ((tok = strtok(NULL, " \t\r")) != NULL) {
+    char* eq = strchr(tok, '=');
+    if (!eq) { benchPrintf("# ignoring '%s'\n", tok); continue; }
+    *eq = '\0';
+    const char* val = eq + 1;
+    if (strcmp(tok, "n") == 0) {
+      s.nCount = benchParseNumbers(val, s.n, BENCH_MAX_VALUES);
+    } else if (strcmp(tok, "reps") == 0) {
+      s.reps = constrain(atoi(val), 1, 1000);
+    } else if (strcmp(tok, "seed") == 0) {
+      randomSeed(strtoul(val, NULL, 10));
+    } else if (strcmp(tok, "algo") == 0 && s.kind == BENCH_SORT) {
+      s.algoCount = benchParseNames(val, s.algo, 2, BENCH_ALGO_NAMES, 2, 0);
+    } else if (strcmp(tok, "algo") == 0 && s.kind == BENCH_PI) {
+      s.algoCount = benchParseNames(val, s.algo, 2, BENCH_ALGO_NAMES + BENCH_MEISSEL, 2, BENCH_MEISSEL);
+    } else if (strcmp(tok, "dist") == 0 && s.kind == BENCH_SORT) {
+      s.distCount = benchParseNames(val, s.dist, 4, BENCH_DIST_NAMES, 4, 0);
+    } else {
+      benchPrintf("# ignoring '%s'\n", tok);
+    }
+  }
+
+  // Clamp N to what the buffers and the patience of a classroom allow
+  long maxN = (s.kind == BENCH_SORT) ? BENCH_MAX_SORT_N : (s.kind == BENCH_PI) ? BENCH_MAX_PI_N : BENCH_MAX_PRIME_N;
+  for (int i = 0; i < s.nCount; i++) s.n[i] = constrain(s.n[i], 1L, maxN);
+  if (s.nCount == 0 || s.algoCount == 0 || s.distCount == 0) {
+    benchWrite("# nothing to run\n");
+    return;
+  }
+
+  s.startedAt = millis();
+  benchSweep = s;
+  benchWrite("kind,algo,dist,n,rep,us,result\n");
+}
+
+//  Measurements
+
+static void benchFill(int* a, int n, uint8_t dist) {
+  for (int i = 0; i < n; i++) {
+    switch (dist) {
+      case BENCH_SORTED:   a[i] = i;               break;
+      case BENCH_REVERSED: a[i] = n - i;           break;
+      case BENCH_FEW:      a[i] = random(10);      break;
+      default:             a[i] = random(10000);   break;
+    }
+  }
+}
+
+// Runs the measurement under the cursor, prints its row, advances the cursor.
+// A primes or pi measurement can take several calls; a sort waits while the
+// Sort Test is running and a pi while the Primes program is counting.
+static void benchStep() {
+  BenchSweep& s = benchSweep;
+  long    n    = s.n[s.ni];
+  uint8_t algo = s.algo[s.ai];
+  uint8_t dist = s.dist[s.di];
+  unsigned long us;
+  unsigned long result;
+
+  if (s.kind == BENCH_SORT && sortRunning()) {
+    // sortBuf and mergeTmp belong to the Sort Test until its run is over
+    if (!s.waiting) benchWrite("# sort: waiting for the Sort Test's run to finish\n");
+    s.waiting = true;
+    return;
+  }
+  if (s.kind == BENCH_PI && primesCounting()) {
+    // and piSegment to the Primes program's count, which overwrites a
+    // part-done row's segment, so that row starts over
+    if (!s.waiting) benchWrite("# pi: waiting for the Primes count to finish\n");
+    s.waiting = true;
+    s.slicing = false;
+    return;
+  }
+  s.waiting = false;
+
+  if (s.kind == BENCH_SORT) {
+    benchFill(sortBuf, (int)n, dist);
+    unsigned long t0 = micros();
+    if (algo == BENCH_BUBBLE) bubbleSort(sortBuf, (int)n);
+    else                      mergeSortHelper(sortBuf, mergeTmp, (int)n);
+    us = micros() - t0;
+    result = 1;
+    for (int i = 1; i < n; i++) if (sortBuf[i - 1] > sortBuf[i]) { result = 0; break; }
+    benchPrintf("sort,%s,%s,%ld,%d,%lu,%lu\n", BENCH_ALGO_NAMES[algo], BENCH_DIST_NAMES[dist],
+                n, s.rep + 1, us, result);
+  } else if (s.kind == BENCH_PI && algo == BENCH_SIEVE && (uint32_t)n > PI_SIEVE_MAX) {
+    benchPrintf("# sieve skips n > %lu\n", (unsigned long)PI_SIEVE_MAX);
+  } else if (s.kind == BENCH_PI) {
+    // Meissel steps or sieve segments in slices of the serial task's budget,
+    // like the primes rows below; only the time spent counting is counted
+    static PiJob job;  // sieves in piSegment, so never alongside the Primes count
+    unsigned long t0 = micros();
+    if (!s.slicing) {
+      s.slicing   = true;
+      s.count     = (n >= 2) ? 1 : 0;   // 2, for the sieve
+      s.candidate = 0;                  // next sieve segment
+      s.spentUs   = 0;
+      if (algo == BENCH_MEISSEL) piJobStart(&job, (uint32_t)n);
+      else                       piTablesInit();
+    }
+    bool more;
+    if (algo == BENCH_MEISSEL) {
+      more = (job.phase != PI_PHASE_DONE);
+      while (more && taskHasBudget()) more = piJobStep(&job);
+    } else {
+      more = (n >= 2 && s.candidate <= (unsigned long)n);
+      while (more && taskHasBudget()) {
+        s.count     += piSieveCount((uint32_t)s.candidate, (uint32_t)n);
+        s.candidate += PI_SEGMENT_SPAN;
+        more = (s.candidate <= (unsigned long)n);
+      }
+    }
+    s.spentUs += micros() - t0;
+    if (more) return;
+    s.slicing = false;
+    us     = s.spentUs;
+    result = (algo == BENCH_MEISSEL) ? job.result : (unsigned long)s.count;
+    benchPrintf("pi,%s,,%ld,%d,%lu,%lu\n", BENCH_ALGO_NAMES[algo], n, s.rep + 1, us, result);
+  } else {
+    // Trial division, as the Primes program does it, in slices of the serial
+    // task's budget so a large n doesn't stall the screen; only the time
+    // spent dividing is counted
+    if (!s.slicing) {
+      s.slicing   = true;
+      s.count     = 1;
+      s.candidate = 1;
+      s.spentUs   = 0;
+    }
+    unsigned long t0 = micros();
+    while (s.count < n && taskHasBudget()) {
+      s.candidate += 2;
+      if (isPrime(s.candidate)) s.count++;
+    }
+    s.spentUs += micros() - t0;
+    if (s.count < n) return;
+    s.slicing = false;
+    us     = s.spentUs;
+    result = (n == 1) ? 2 : s.candidate;
+    benchPrintf("primes,%s,,%ld,%d,%lu,%lu\n", BENCH_ALGO_NAMES[algo], n, s.rep + 1, us, result);
+  }
+  s.rows++;
+
+  // Advance: rep fastest, then dist, then algo, then n
+  if (++s.rep < s.reps) return;
+  s.rep = 0;
+  if (++s.di < s.distCount) return;
+  s.di = 0;
+  if (++s.ai < s.algoCount) return;
+  s.ai = 0;
+  if (++s.ni < s.nCount) return;
+
+  benchPrintf("# done: %lu rows in %lu ms\n", s.rows, millis() - s.startedAt);
+  s.kind = BENCH_IDLE;
+}
+
+//  Called once per loop(): collects a command line, or takes the next
+// measurement of a running sweep.  A new command waits until the running
+// sweep finishes (input stays unread meanwhile) unless it is "stop".
+static void benchPoll() {
+  int c;
+  while (!benchLineReady && (c = benchReadChar()) >= 0) {
+    if (c == '\n') {
+      benchLine[benchLineLen] = '\0';
+      benchLineLen   = 0;
+      benchLineReady = true;
+    } else if (benchLineLen < BENCH_LINE_MAX - 1) {
+      benchLine[benchLineLen++] = (char)c;
+    }
+  }
+  if (benchLineReady && (benchSweep.kind == BENCH_IDLE || strncmp(benchLine, "stop", 4) == 0)) {
+    benchLineReady = false;
+    benchCommand(benchLine);
+  }
+  if (benchSweep.kind != BENCH_IDLE) benchStep();
+}
+
+#endif
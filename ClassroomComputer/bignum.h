@@ -0,0 +1,320 @@
+#ifndef BIGNUM_H
+#define BIGNUM_H
+
+#include <stdint.h>
+#include <string.h>
+
+//  Arbitrary-precision unsigned integers in fixed buffers
+// A BigNum is little-endian 32-bit limbs with a live length.  Limbs at or
+// beyond len are always zero, so shorter operands can be treated as
+// zero-padded without copying.  Capacity is fixed at compile time; every
+// operation that could exceed it reports overflow instead of writing past
+// the end.  No heap, no Arduino dependencies (builds on host unchanged).
+
+#define BIG_MAX_LIMBS        128   // 4096 bits ≈ 1233 decimal digits
+#define BIG_KARATSUBA_CUTOFF 16    // below this many limbs schoolbook is faster
+#define BIG_SCRATCH_LIMBS    (2 * BIG_MAX_LIMBS + 64)
+#define BIG_CHUNK_BASE       1000000000UL  // 10^9 – decimal chunk size
+#define BIG_CHUNK_DIGITS     9
+
+struct BigNum {
+  uint16_t len;
+  uint32_t limb[BIG_MAX_LIMBS];
+};
+
+static void bigSetSmall(BigNum* a, uint32_t v) {
+  memset(a->limb, 0, sizeof(a->limb));
+  a->limb[0] = v;
+  a->len = (v != 0) ? 1 : 0;
+}
+
+static bool bigIsZero(const BigNum* a) { return a->len == 0; }
+
+static void bigTrim(BigNum* a) {
+  while (a->len > 0 && a->limb[a->len - 1] == 0) a->len--;
+}
+
+//  a *= m in place; returns false (a unchanged past capacity) on overflow
+static bool bigMulSmall(BigNum* a, uint32_t m) {
+  uint64_t carry = 0;
+  for (int i = 0; i < a->len; i++) {
+    uint64_t t = (uint64_t)a->limb[i] * m + carry;
+    a->limb[i] = (uint32_t)t;
+    carry = t >> 32;
+  }
+  if (carry) {
+    if (a->len >= BIG_MAX_LIMBS) return false;
+    a->limb[a->len++] = (uint32_t)carry;
+  }
+  if (m == 0) a->len = 0;
+  return true;
+}
+
+//  a /= d in place; returns the remainder
+static uint32_t bigDivSmall(BigNum* a, uint32_t d) {
+  uint64_t rem = 0;
+  for (int i = a->len - 1; i >= 0; i--) {
+    uint64_t cur = (rem << 32) | a->limb[i];
+    a->limb[i] = (uint32_t)(cur / d);
+    rem = cur % d;
+  }
+  bigTrim(a);
+  return (uint32_t)rem;
+}
+
+//  Raw limb helpers used by the multipliers (lengths are explicit)
+
+// r[0..na+nb) = a[0..na) * b[0..nb); r must not alias a or b
+static void bigMulSchoolbook(uint32_t* r, const uint32_t* a, int na, const uint32_t* b, int nb) {
+  memset(r, 0, (size_t)(na + nb) * sizeof(uint32_t));
+  for (int i = 0; i < na; i++) {
+    uint64_t carry = 0;
+    uint32_t ai = a[i];
+    if (ai == 0) continue;
+    for (int j = 0; j < nb; j++) {
+      uint64_t t = (uint64_t)ai * b[j] + r[i + j] + carry;
+      r[i + j] = (uint32_t)t;
+      carry = t >> 32;
+    }
+    r[i + nb] = (uint32_t)carry;
+  }
+}
+
+// r[0..n) += a[0..n); returns carry out
+static uint32_t bigAddInto(uint32_t* r, const uint32_t* a, int n) {
+  uint64_t carry = 0;
+  for (int i = 0; i < n; i++) {
+    uint64_t t = (uint64_t)r[i] + a[i] + carry;
+    r[i] = (uint32_t)t;
+    carry = t >> 32;
+  }
+  return (uint32_t)carry;
+}
+
+// r[0..n) -= a[0..n); returns borrow out
+static uint32_t bigSubInto(uint32_t* r, const uint32_t* a, int n) {
+  int64_t borrow = 0;
+  for (int i = 0; i < n; i++) {
+    int64_t t = (int64_t)r[i] - a[i] - borrow;
+    r[i] = (uint32_t)t;
+    borrow = (t < 0) ? 1 : 0;
+  }
+  return (uint32_t)borrow;
+}
+
+// Propagates a carry into r[0..n)
+static void bigCarryInto(uint32_t* r, int n, uint32_t carry) {
+  for (int i = 0; i < n && carry; i++) {
+    uint64_t t = (uint64_t)r[i] + carry;
+    r[i] = (uint32_t)t;
+    carry = (uint32_t)(t >> 32);
+  }
+}
+
+// r[0..2n) = a[0..n) * b[0..n) by Karatsuba.
+// scratch needs roughly 4n limbs plus a few per recursion level.
+//   a = a1·B^m + a0,  b = b1·B^m + b0
+//   a·b = z2·B^2m + (z1 - z2 - z0)·B^m + z0,  z1 = (a0 + a1)(b0 + b1)
+static void bigMulKaratsuba(uint32_t* r, const uint32_t* a, const uint32_t* b, int n, uint32_t* scratch) {
+  if (n < BIG_KARATSUBA_CUTOFF) {
+    bigMulSchoolbook(r, a, n, b, n);
+    return;
+  }
+  int m = n / 2;     // low half
+  int h = n - m;     // high half, h >= m
+
+  // z0 → r[0..2m), z2 → r[2m..2n)
+  bigMulKaratsuba(r,         a,     b,     m, scratch);
+  bigMulKaratsuba(r + 2 * m, a + m, b + m, h, scratch);
+
+  // sa = a0 + a1, sb = b0 + b1, each h + 1 limbs
+  uint32_t* sa = scratch;
+  uint32_t* sb = sa + (h + 1);
+  uint32_t* z1 = sb + (h + 1);          // 2(h + 1) limbs
+  uint32_t* next = z1 + 2 * (h + 1);
+  memcpy(sa, a + m, (size_t)h * sizeof(uint32_t));
+  memcpy(sb, b + m, (size_t)h * sizeof(uint32_t));
+  sa[h] = 0;
+  sb[h] = 0;
+  bigCarryInto(sa + m, h + 1 - m, bigAddInto(sa, a, m));
+  bigCarryInto(sb + m, h + 1 - m, bigAddInto(sb, b, m));
+  bigMulKaratsuba(z1, sa, sb, h + 1, next);
+
+  // z1 -= z0 + z2  (never negative)
+  int zl = 2 * (h + 1);
+  uint32_t bw = bigSubInto(z1, r, 2 * m);
+  for (int i = 2 * m; i < zl && bw; i++) { bw = (z1[i] == 0) ? 1 : 0; z1[i]--; }
+  bw = bigSubInto(z1, r + 2 * m, 2 * h);
+  for (int i = 2 * h; i < zl && bw; i++) { bw = (z1[i] == 0) ? 1 : 0; z1[i]--; }
+
+  // r[m..) += z1; the true middle term fits within r[m..2n)
+  int span = 2 * n - m;
+  int add  = (zl < span) ? zl : span;
+  uint32_t c = bigAddInto(r + m, z1, add);
+  bigCarryInto(r + m + add, span - add, c);
+}
+
+//  r = a * b.  r must not alias a or b.  Uses Karatsuba when both operands
+// are long enough and the zero-padded square product fits; otherwise
+// schoolbook.  Returns false on overflow.
+static bool bigMul(BigNum* r, const BigNum* a, const BigNum* b, uint32_t* scratch) {
+  if (a->len == 0 || b->len == 0) { bigSetSmall(r, 0); return true; }
+  if (a->len + b->len > BIG_MAX_LIMBS + 1) return false;
+
+  int n = (a->len > b->len) ? a->len : b->len;
+  int shorter = (a->len < b->len) ? a->len : b->len;
+  if (shorter >= BIG_KARATSUBA_CUTOFF && 2 * n <= BIG_MAX_LIMBS) {
+    // Zero limbs past len make the shorter operand implicitly padded to n
+    memset(r->limb, 0, sizeof(r->limb));
+    bigMulKaratsuba(r->limb, a->limb, b->limb, n, scratch);
+  } else {
+    int nr = a->len + b->len;
+    if (nr > BIG_MAX_LIMBS) {
+      // Product may still fit if the top limb is zero; compute into scratch
+      bigMulSchoolbook(scratch, a->limb, a->len, b->limb, b->len);
+      if (scratch[nr - 1] != 0) return false;
+      memset(r->limb, 0, sizeof(r->limb));
+      memcpy(r->limb, scratch, (size_t)(nr - 1) * sizeof(uint32_t));
+      r->len = (uint16_t)(nr - 1);
+      bigTrim(r);
+      return true;
+    }
+    memset(r->limb, 0, sizeof(r->limb));
+    bigMulSchoolbook(r->limb, a->limb, a->len, b->limb, b->len);
+  }
+  r->len = (uint16_t)((a->len + b->len < BIG_MAX_LIMBS) ? a->len + b->len : BIG_MAX_LIMBS);
+  bigTrim(r);
+  return true;
+}
+
+//  Time-sliced jobs
+// A BigJob computes base^n or n! one bounded step at a time, then converts
+// the binary result to base-10^9 chunks one division at a time.  Digits are
+// pulled most-significant first with bigJobNextDigit(), so the decimal string
+// is never materialized.  The caller decides how many steps fit in a slice.
+
+enum BigJobOp    { BIG_OP_POWER, BIG_OP_FACTORIAL };
+enum BigJobPhase { BIG_PHASE_COMPUTE, BIG_PHASE_CONVERT, BIG_PHASE_DONE, BIG_PHASE_OVERFLOW };
+
+struct BigJob {
+  BigJobOp    op;
+  BigJobPhase phase;
+  uint32_t    base;         // power only
+  uint32_t    n;            // exponent or factorial argument
+  int32_t     bit;          // power: next exponent bit (MSB first)
+  uint32_t    nextFactor;   // factorial: next multiplier
+  uint32_t    stepsDone;
+  uint32_t    stepsTotal;   // for progress display
+  BigNum*     acc;          // current value
+  BigNum*     spare;        // product target, swapped with acc
+  uint32_t*   scratch;      // Karatsuba scratch, reused for decimal chunks
+  int         chunkCount;
+  int         chunkIdx;     // streaming cursor: chunk (counts down)
+  int         digitIdx;     //                   digit within chunk
+  uint32_t    digitCount;
+};
+
+static BigNum   bigA, bigB;
+static uint32_t bigScratch[BIG_SCRATCH_LIMBS];
+
+static void bigJobStart(BigJob* job, BigJobOp op, uint32_t base, uint32_t n) {
+  job->op         = op;
+  job->phase      = BIG_PHASE_COMPUTE;
+  job->base       = base;
+  job->n          = n;
+  job->stepsDone  = 0;
+  job->acc        = &bigA;
+  job->spare      = &bigB;
+  job->scratch    = bigScratch;
+  job->chunkCount = 0;
+  job->digitCount = 0;
+  bigSetSmall(job->acc, 1);
+
+  if (op == BIG_OP_POWER) {
+    int32_t top = -1;
+    for (int32_t i = 31; i >= 0; i--) if (n & (1UL << i)) { top = i; break; }
+    job->bit        = top;
+    job->stepsTotal = (uint32_t)(top + 1);
+  } else {
+    job->nextFactor = 2;
+    job->stepsTotal = (n > 1) ? n - 1 : 0;
+  }
+}
+
+//  Counts decimal digits and rewinds the streaming cursor
+static void bigJobFinishConvert(BigJob* job) {
+  job->phase = BIG_PHASE_DONE;
+  if (job->chunkCount == 0) {          // value is zero
+    job->scratch[0] = 0;
+    job->chunkCount = 1;
+  }
+  uint32_t top = job->scratch[job->chunkCount - 1];
+  int topDigits = 1;
+  while (top >= 10) { top /= 10; topDigits++; }
+  job->digitCount = (uint32_t)(job->chunkCount - 1) * BIG_CHUNK_DIGITS + topDigits;
+  job->chunkIdx   = job->chunkCount - 1;
+  job->digitIdx   = BIG_CHUNK_DIGITS - topDigits;
+}
+
+//  Performs one bounded unit of work; returns true while more remain.
+// Compute: one square-and-multiply bit, or one small multiply that packs as
+// many consecutive factors as fit in 32 bits.  Convert: one division of the
+// whole value by 10^9.
+static bool bigJobStep(BigJob* job) {
+  if (job->phase == BIG_PHASE_COMPUTE) {
+    if (job->op == BIG_OP_POWER) {
+      if (job->bit < 0) { job->phase = BIG_PHASE_CONVERT; return true; }
+      if (!bigMul(job->spare, job->acc, job->acc, job->scratch)) {
+        job->phase = BIG_PHASE_OVERFLOW;
+        return false;
+      }
+      BigNum* t = job->acc; job->acc = job->spare; job->spare = t;
+      if (job->n & (1UL << job->bit)) {
+        if (!bigMulSmall(job->acc, job->base)) { job->phase = BIG_PHASE_OVERFLOW; return false; }
+      }
+      job->bit--;
+      job->stepsDone++;
+    } else {
+      if (job->nextFactor > job->n) { job->phase = BIG_PHASE_CONVERT; return true; }
+      uint32_t packed = 1;
+      uint32_t first  = job->nextFactor;
+      while (job->nextFactor <= job->n &&
+             (uint64_t)packed * job->nextFactor <= 0xFFFFFFFFULL) {
+        packed *= job->nextFactor++;
+      }
+      if (!bigMulSmall(job->acc, packed)) { job->phase = BIG_PHASE_OVERFLOW; return false; }
+      job->stepsDone += job->nextFactor - first;
+    }
+    return true;
+  }
+
+  if (job->phase == BIG_PHASE_CONVERT) {
+    // acc is consumed; chunks land least-significant first in scratch
+    if (bigIsZero(job->acc)) { bigJobFinishConvert(job); return false; }
+    job->scratch[job->chunkCount++] = bigDivSmall(job->acc, BIG_CHUNK_BASE);
+    return true;
+  }
+
+  return false;
+}
+
+//  True while bigJobNextDigit() still has digits to hand out
+static bool bigJobHasDigits(const BigJob* job) {
+  return job->phase == BIG_PHASE_DONE && job->chunkIdx >= 0;
+}
+
+//  Next decimal digit, most significant first; returns 0 once exhausted
+static char bigJobNextDigit(BigJob* job) {
+  if (job->phase != BIG_PHASE_DONE || job->chunkIdx < 0) return 0;
+  uint32_t chunk = job->scratch[job->chunkIdx];
+  uint32_t div = 1;
+  for (int i = job->digitIdx + 1; i < BIG_CHUNK_DIGITS; i++) div *= 10;
+  char c = (char)('0' + (chunk / div) % 10);
+  if (++job->digitIdx >= BIG_CHUNK_DIGITS) {
+    job->digitIdx = 0;
+    job->chunkIdx--;
+  }
+  return c;
+}
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef CALC_ENGINE_H
+#define CALC_ENGINE_H
+
+#include <stdint.h>
+#include <string.h>
+
+//  Exact calculator arithmetic
+// Results are kept as a reduced 64-bit rational (num / den, den > 0) so that
+// +, -, * and / on integer operands are exact.  Formatting performs long
+// division one decimal digit at a time and rounds half away from zero at the
+// last digit that fits, so the printed string is correctly rounded and
+// identical on the Uno R4 and on a host build (no float anywhere).
+
+#define CALC_RESULT_CHARS 14                      // default width of a formatted result
+#define CALC_EXACT_BYTES  (CALC_RESULT_CHARS + 8)  // out[] formatCalcExact() needs at that width
+
+struct CalcValue {
+  int64_t num;
+  int64_t den;   // always > 0
+};
+
+//  Greatest common divisor of two non-negative values
+static int64_t calcGcd(int64_t a, int64_t b) {
+  while (b != 0) { int64_t t = a % b; a = b; b = t; }
+  return a;
+}
+
+//  Build a reduced rational; den == 0 is treated as division by zero and
+// yields 0 / 0 so callers can detect it with calcIsValid().
+static CalcValue calcMake(int64_t num, int64_t den) {
+  CalcValue v;
+  if (den == 0) { v.num = 0; v.den = 0; return v; }
+  if (den < 0) { num = -num; den = -den; }
+  int64_t g = calcGcd(num < 0 ? -num : num, den);
+  if (g > 1) { num /= g; den /= g; }
+  v.num = num;
+  v.den = den;
+  return v;
+}
+
+static bool calcIsValid(CalcValue v) { return v.den != 0; }
+
+//  Apply op ('+', '-', '*', '/') to two integer operands
+static CalcValue calcEvaluate(long a, char op, long b) {
+  switch (op) {
+    case '+': return calcMake((int64_t)a + b, 1);
+    case '-': return calcMake((int64_t)a - b, 1);
+    case '*': return calcMake((int64_t)a * b, 1);
+    case '/': return calcMake((int64_t)a, (int64_t)b);
+  }
+  return calcMake(0, 0);
+}
+
+// Inserts commas into a string of digits with an optional leading '-'.
+// E.g. "1000000" -> "1,000,000", "-1000" -> "-1,000", "999" -> "999"
+static void addCommasToIntStr(const char* digits, char* out) {
+  int outIdx = 0;
+  int start = 0;
+  int len = strlen(digits);
+  if (len > 0 && digits[0] == '-') { out[outIdx++] = '-'; start = 1; len--; }
+  int first = (len % 3 == 0) ? 3 : len % 3;
+  for (int i = 0; i < first; i++) out[outIdx++] = digits[start + i];
+  for (int i = first; i < len; i++) {
+    if ((i - first) % 3 == 0) out[outIdx++] = ',';
+    out[outIdx++] = digits[start + i];
+  }
+  out[outIdx] = '\0';
+}
+
+//  Number of characters the integer part occupies once commas are inserted
+static int calcIntWidth(int digitCount, bool negative) {
+  return digitCount + (digitCount - 1) / 3 + (negative ? 1 : 0);
+}
+
+// Formats an exact value into out[] (must be ≥ maxChars + 8 bytes):
+//   Integer: no decimal point, commas every 3 digits  e.g. "1,000,000"
+//   Non-integer: integer part with commas + '.' + as many decimal digits as
+//           fit within maxChars total characters, rounded half away from
+//           zero, trailing zeros stripped  e.g. 1/3 -> "0.333333333333"
+static void formatCalcExact(CalcValue v, char* out, int maxChars = CALC_RESULT_CHARS) {
+  if (!calcIsValid(v)) { strcpy(out, "Error"); return; }
+
+  bool negative = v.num < 0;
+  uint64_t mag  = negative ? (uint64_t)0 - (uint64_t)v.num : (uint64_t)v.num;
+  uint64_t den  = (uint64_t)v.den;
+  uint64_t ip   = mag / den;
+  uint64_t rem  = mag % den;
+
+  // digits[] holds the integer part then the decimals, most significant first;
+  // slot 0 is reserved for a carry out of the integer part during rounding.
+  char digits[48];
+  char tmp[24];
+  int  intDigits = 0;
+  do { tmp[intDigits++] = (char)('0' + ip % 10); ip /= 10; } while (ip > 0);
+  digits[0] = '0';
+  for (int i = 0; i < intDigits; i++) digits[1 + i] = tmp[intDigits - 1 - i];
+
+  int decPlaces = 0;
+  if (rem != 0) {
+    decPlaces = maxChars - calcIntWidth(intDigits, negative) - 1;
+    if (decPlaces < 1) decPlaces = 1;
+    if (decPlaces > 40 - intDigits) decPlaces = 40 - intDigits;
+  }
+
+  // Long division: each step is rem*10 / den.  rem < den, so rem*10 only
+  // overflows when den > UINT64_MAX / 10, far beyond any calculator input.
+  for (int i = 0; i < decPlaces; i++) {
+    rem *= 10;
+    digits[1 + intDigits + i] = (char)('0' + rem / den);
+    rem %= den;
+  }
+
+  // Round half away from zero on the remaining fraction
+  int total = 1 + intDigits + decPlaces;
+  if (rem != 0 && rem >= den - rem) {
+    int i = total - 1;
+    while (i >= 0 && digits[i] == '9') { digits[i] = '0'; i--; }
+    digits[i]++;
+  }
+
+  // A carry into slot 0 adds an integer digit; the decimals it pushes past
+  // maxChars were all rounded to zero, so dropping them loses nothing.
+  int first = 1;
+  if (digits[0] != '0') {
+    first = 0;
+    intDigits++;
+    while (decPlaces > 0 && calcIntWidth(intDigits, negative) + 1 + decPlaces > maxChars) {
+      decPlaces--;
+    }
+  }
+
+  // Strip trailing zeros from the decimal part (e.g. "499.5000" -> "499.5")
+  while (decPlaces > 0 && digits[first + intDigits + decPlaces - 1] == '0') decPlaces--;
+
+  // Never print "-0"
+  bool allZero = true;
+  for (int i = 0; i < intDigits + decPlaces; i++) {
+    if (digits[first + i] != '0') { allZero = false; break; }
+  }
+
+  char intStr[24];
+  int  n = 0;
+  if (negative && !allZero) intStr[n++] = '-';
+  for (int i = 0; i < intDigits; i++) intStr[n++] = digits[first + i];
+  intStr[n] = '\0';
+  addCommasToIntStr(intStr, out);
+
+  if (decPlaces > 0) {
+    int len = strlen(out);
+    out[len++] = '.';
+    for (int i = 0; i < decPlaces; i++) out[len++] = digits[first + intDigits + i];
+    out[len] = '\0';
+  }
+}
+
+#endif
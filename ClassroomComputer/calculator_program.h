@@ -2,18 +2,36 @@
 #define CALCULATOR_PROGRAM_H
 
 #include <Arduino.h>
+#include "calc_engine.h"
+#include "bignum.h"
+#include "task_scheduler.h"
+#include "sketch_shared.h"
+#include "program_registry.h"
+#include "anim_timeline.h"
+
+//  Set to 1 to run runCalcBenchmark() from setup() and print the comparison
+// between the exact engine and the legacy float + dtostrf path over Serial.
+#ifndef CALC_BENCHMARK_ON_BOOT
+#define CALC_BENCHMARK_ON_BOOT 0
+#endif
 
 //  Calculator program states
 enum CalcState {
   CALC_TITLE,            // "Calculator Program" for 1.2 s
   CALC_INTRO,            // "Select two #s to / +, -, *, or /" for 3.3 s
+  CALC_SELECT_MODE,      // "Choose mode:" / Basic or Big #s until slider static for 1.3 s
   CALC_SELECT_A_INTRO,   // "Move slider to / select 1st #" for 2 s
   CALC_SELECT_A,         // "A = [value]" until slider static for 1.3 s
   CALC_SELECT_B_INTRO,   // "Move slider to / select 2nd #" for 1.2 s
   CALC_SELECT_B,         // "B = [value]" until slider static for 1.3 s
   CALC_SELECT_OP_INTRO,  // "Move slider to / select operation" for 1.2 s
   CALC_SELECT_OP,        // "       [op]" until slider static for 1.3 s
-  CALC_RESULT            // "A [op] B = / [result] X" for 5 s, then back to program select
+  CALC_RESULT,           // "A [op] B = / [result] X" for 5 s, then back to program select
+  CALC_BIG_SELECT_OP,    // "Pick operation" / "n!" or "a^n" until slider static for 1.3 s
+  CALC_BIG_SELECT_BASE,  // "a = [2-100]" until slider static for 2.5 s (a^n only)
+  CALC_BIG_SELECT_N,     // "n = [1-1000]" until slider static for 2.5 s
+  CALC_BIG_RUNNING,      // "Computing [expr] / [progress] ETA" in time slices
+  CALC_BIG_RESULT        // "[expr]: [d] dig" / streaming digits until done or slider moves
 };
 
 //  Calculator-specific state
@@ -21,12 +39,23 @@ static CalcState calcState = CALC_TITLE;
 static int       calcA     = 1;      // First number (1-100)
 static int       calcB     = 1;      // Second number (1-100)
 static char      calcOp    = '+';    // Operation: '+', '-', '*', '/'
-static float     calcResult = 0.0;   // Computation result (float for division)
-
+static CalcValue calcResult = {0, 1}; // Exact result as a reduced rational
+
+//  Big-number mode state
+static const unsigned long BIG_SLICE_MICROS = 8000UL;  // compute budget per task run
+static BigJob  bigJob;
+static int     bigTask        = -1;    // scheduler handle of the running job
+static bool    bigIsFactorial = true;  // n! (true) or a^n (false)
+static int     bigBase        = 2;     // a in a^n (2-100)
+static int     bigN           = 100;   // n (1-1000)
+static char    bigWindow[17];          // 16 visible digits of the stream
+static bool    bigStreamDone  = false; // last digit has entered the window
+static unsigned long bigStreamDoneAt = 0;
 //  Forward declarations (need to be visible to other modules)
 // These are declared here but implemented below, and called from the main sketch
 void enterCalcState(CalcState next);
 void handleCalculator(unsigned long now);
+void runCalcBenchmark();
 
 //  Calculator helper: map pot to operation
 static char mapPotToOp(int pot) {
@@ -46,44 +75,43 @@ static void handleCalcSelectB(unsigned long now);
 static void handleCalcSelectOpIntro(unsigned long now);
 static void handleCalcSelectOp(unsigned long now);
 static void handleCalcResult(unsigned long now);
+static void handleCalcSelectMode(unsigned long now);
+static void handleCalcBigSelectOp(unsigned long now);
+static void handleCalcBigSelectBase(unsigned long now);
+static void handleCalcBigSelectN(unsigned long now);
+static void handleCalcBigRunning(unsigned long now);
+static void handleCalcBigResult(unsigned long now);
+static void calcBigJobTask(unsigned long now);
 
 //  Implementations
 
-// External references to shared state (defined in main sketch)
-extern rgb_lcd lcd;
-extern const byte COL_PINK[3];
-extern const byte COL_GREEN[3];
-extern unsigned long stateEnteredAt;
-extern int scrollOffset;
-extern unsigned long scrollTickAt;
-extern bool potHasMoved;
-extern int potValue;
-extern int remappedPotValue;
-extern unsigned long potLastMovedAt;
-extern byte celebFrame0[8];
-extern byte celebFrame1[8];
-extern byte celebFrame2[8];
-extern byte celebFrame3[8];
-extern byte celebFrame4[8];
-extern byte celebFrame5[8];
-extern byte celebFrame6[8];
-extern byte celebFrame7[8];
-extern const int CELEB_FRAME_COUNT;
-extern int celebFrameIdx;
-extern unsigned long celebTickAt;
-extern const int BUZZER_PIN;
-extern void tickCelebrationSound(unsigned long now);
-extern void enterAppState(int nextState);  // forward declaration; APP_PROGRAM_SELECT = 1
-
 void enterCalcState(CalcState next) {
   calcState      = next;
   stateEnteredAt = millis();
   scrollOffset   = 0;
   scrollTickAt   = millis();
   potHasMoved    = false;
-  if (next == CALC_RESULT) lcd.setRGB(COL_GREEN[0], COL_GREEN[1], COL_GREEN[2]);
-  else                     lcd.setRGB(COL_PINK[0],  COL_PINK[1],  COL_PINK[2]);
+  if (next == CALC_RESULT || next == CALC_BIG_RUNNING || next == CALC_BIG_RESULT)
+    setBacklight(COL_GREEN);
+  else
+    setBacklight(COL_PINK);
   lcd.clear();
+
+  if (next == CALC_RESULT) {
+    // The celebration goes right after the result when it fits
+    calcResult = calcEvaluate(calcA, calcOp, calcB);
+    char resultStr[CALC_EXACT_BYTES];
+    formatCalcExact(calcResult, resultStr);
+    int len = strlen(resultStr);
+    if (len <= 14) animPlay(&CELEB_GLYPH_CLIP, len + 1, 1);
+    animPlay(&CELEB_GLOW_CLIP);
+  }
+
+  taskCancel(bigTask);
+  if (next == CALC_BIG_RUNNING) {
+    progressBegin(1, 0, 11);
+    bigTask = taskAdd("bignum", calcBigJobTask, 0, TASK_PRIO_COMPUTE, BIG_SLICE_MICROS, TASK_GROUP_PROGRAM);
+  }
 }
 
 void handleCalculator(unsigned long now) {
@@ -97,6 +125,12 @@ void handleCalculator(unsigned long now) {
     case CALC_SELECT_OP_INTRO: handleCalcSelectOpIntro(now);  break;
     case CALC_SELECT_OP:       handleCalcSelectOp(now);       break;
     case CALC_RESULT:          handleCalcResult(now);         break;
+    case CALC_SELECT_MODE:     handleCalcSelectMode(now);     break;
+    case CALC_BIG_SELECT_OP:   handleCalcBigSelectOp(now);    break;
+    case CALC_BIG_SELECT_BASE: handleCalcBigSelectBase(now);  break;
+    case CALC_BIG_SELECT_N:    handleCalcBigSelectN(now);     break;
+    case CALC_BIG_RUNNING:     handleCalcBigRunning(now);     break;
+    case CALC_BIG_RESULT:      handleCalcBigResult(now);      break;
   }
 }
 
@@ -122,7 +156,22 @@ static void handleCalcIntro(unsigned long now) {
   lcd.print("+, -, *, or /");
 
   if (now - stateEnteredAt >= 3300UL) {
-    enterCalcState(CALC_SELECT_A_INTRO);
+    enterCalcState(CALC_SELECT_MODE);
+  }
+}
+
+// State 2b – "Choose mode:" / Basic or Big #s until slider static for 1.3 s.
+// Left half of the slider = Basic (+ - * /), right half = Big numbers.
+static void handleCalcSelectMode(unsigned long now) {
+  bool big = potValue >= 512;
+
+  lcd.setCursor(0, 0);
+  lcd.print("Choose mode:");
+  lcd.setCursor(0, 1);
+  lcd.print(big ? "Big #s  n!  a^n " : "Basic  + - * /  ");
+
+  if (potHasMoved && (now - potLastMovedAt >= 1300UL)) {
+    enterCalcState(big ? CALC_BIG_SELECT_OP : CALC_SELECT_A_INTRO);
   }
 }
 
@@ -212,22 +261,7 @@ static void handleCalcSelectOp(unsigned long now) {
 
 //  Result formatting helpers
 
-// Inserts commas into a string of digits with an optional leading '-'.
-// E.g. "1000000" -> "1,000,000", "-1000" -> "-1,000", "999" -> "999"
-static void addCommasToIntStr(const char* digits, char* out) {
-  int outIdx = 0;
-  int start = 0;
-  int len = strlen(digits);
-  if (len > 0 && digits[0] == '-') { out[outIdx++] = '-'; start = 1; len--; }
-  int first = (len % 3 == 0) ? 3 : len % 3;
-  for (int i = 0; i < first; i++) out[outIdx++] = digits[start + i];
-  for (int i = first; i < len; i++) {
-    if ((i - first) % 3 == 0) out[outIdx++] = ',';
-    out[outIdx++] = digits[start + i];
-  }
-  out[outIdx] = '\0';
-}
-
+// Legacy float formatter, kept as the reference path for runCalcBenchmark().
 // Formats a float result into out[] (must be ≥ 17 bytes):
 //   Integer: no decimal point, commas every 3 digits  e.g. "1,000,000"
 //   Non-integer: integer part with commas + '.' + as many decimal digits as
@@ -270,18 +304,6 @@ static void formatCalcResult(float result, char* out) {
 
 // State 9 – "A [op] B = / [result]" for 5 s, then back to program select.
 static void handleCalcResult(unsigned long now) {
-  // Compute result on first entry (or within first 10 ms of re-entry)
-  static bool computed = false;
-  if (!computed || (now - stateEnteredAt) < 10) {
-    computed = true;
-    switch (calcOp) {
-      case '+': calcResult = (float)calcA + calcB; break;
-      case '-': calcResult = (float)calcA - calcB; break;
-      case '*': calcResult = (float)calcA * calcB; break;
-      case '/': calcResult = (float)calcA / calcB; break;
-    }
-  }
-
   // Display "A [op] B =" on top line
   lcd.setCursor(0, 0);
   lcd.print(calcA);
@@ -293,8 +315,8 @@ static void handleCalcResult(unsigned long now) {
   lcd.print("        ");  // clear any leftover
 
   // Format result string
-  char resultStr[20];
-  formatCalcResult(calcResult, resultStr);
+  char resultStr[CALC_EXACT_BYTES];
+  formatCalcExact(calcResult, resultStr);
   int len = strlen(resultStr);
 
   // Display result on bottom line.
@@ -310,22 +332,7 @@ static void handleCalcResult(unsigned long now) {
     lcd.print("..");
   } else {
     lcd.print(resultStr);
-    lcd.print(" ");
-
-    // Celebration animation (pulse → spin → sparkle) in remaining space
-    if (celebTickAt < stateEnteredAt) {
-      celebFrameIdx = 0;
-      lcd.createChar(0, celebFrame0);
-      celebTickAt = stateEnteredAt + 200UL;
-    }
-    if (now >= celebTickAt) {
-      celebFrameIdx = (celebFrameIdx + 1) % CELEB_FRAME_COUNT;
-      byte* frames[8] = {celebFrame0, celebFrame1, celebFrame2, celebFrame3,
-                          celebFrame4, celebFrame5, celebFrame6, celebFrame7};
-      lcd.createChar(0, frames[celebFrameIdx]);
-      celebTickAt = now + 200UL;
-    }
-    lcd.write((uint8_t)0);  // celebration character right after result
+    lcd.print(" ");  // the celebration glyph follows (see enterCalcState)
   }
 
   // Celebration jingle
@@ -333,9 +340,235 @@ static void handleCalcResult(unsigned long now) {
 
   // Return to program select after 5 seconds
   if (now - stateEnteredAt >= 5000UL) {
-    computed = false;  // reset for next run
     enterAppState(1);  // APP_PROGRAM_SELECT = 1
   }
 }
 
+//  Big-number mode sub-handlers
+
+// Writes "n!" or "a^n" for the current selection into out[] (≥ 12 bytes)
+static void formatBigExpr(char* out) {
+  if (bigIsFactorial) snprintf(out, 12, "%d!", bigN);
+  else                snprintf(out, 12, "%d^%d", bigBase, bigN);
+}
+
+// Big state 1 – "Pick operation" / "n!" or "a^n" until slider static for 1.3 s.
+static void handleCalcBigSelectOp(unsigned long now) {
+  bool fact = potValue < 512;
+
+  lcd.setCursor(0, 0);
+  lcd.print("Pick operation");
+  lcd.setCursor(0, 1);
+  lcd.print(fact ? "       n!       " : "       a^n      ");
+
+  if (potHasMoved && (now - potLastMovedAt >= 1300UL)) {
+    bigIsFactorial = fact;
+    enterCalcState(fact ? CALC_BIG_SELECT_N : CALC_BIG_SELECT_BASE);
+  }
+}
+
+// Big state 2 – "a = [2-100]" until slider static for 2.5 s.
+static void handleCalcBigSelectBase(unsigned long now) {
+  int a = map(potValue, 0, 1023, 2, 100);
+
+  lcd.setCursor(0, 0);
+  lcd.print("a = ");
+  lcd.print(a);
+  lcd.print("     ");
+  lcd.setCursor(0, 1);
+  lcd.print("base for a^n");
+
+  if (potHasMoved && (now - potLastMovedAt >= 2500UL)) {
+    bigBase = a;
+    enterCalcState(CALC_BIG_SELECT_N);
+  }
+}
+
+// Big state 3 – "n = [1-1000]" until slider static for 2.5 s.
+static void handleCalcBigSelectN(unsigned long now) {
+  int n = map(potValue, 0, 1023, 1, 1000);
+
+  lcd.setCursor(0, 0);
+  lcd.print("n = ");
+  lcd.print(n);
+  lcd.print("     ");
+  lcd.setCursor(0, 1);
+  lcd.print(bigIsFactorial ? "compute n!" : "compute a^n");
+
+  if (potHasMoved && (now - potLastMovedAt >= 2500UL)) {
+    bigN = n;
+    bigJobStart(&bigJob, bigIsFactorial ? BIG_OP_FACTORIAL : BIG_OP_POWER,
+                (uint32_t)bigBase, (uint32_t)bigN);
+    enterCalcState(CALC_BIG_RUNNING);
+  }
+}
+
+// Big state 4 – "Computing [expr]" / progress bar + ETA.
+// The job itself is calcBigJobTask(); this only redraws the progress.
+static void handleCalcBigRunning(unsigned long now) {
+  char expr[12];
+  formatBigExpr(expr);
+
+  lcd.setCursor(0, 0);
+  lcd.print("Computing ");
+  lcd.print(expr);
+  if (bigJob.phase == BIG_PHASE_COMPUTE) {
+    progressUpdate(bigJob.stepsDone, bigJob.stepsTotal, now - stateEnteredAt);
+  } else {
+    lcd.setCursor(0, 1);
+    lcd.print("to decimal...   ");
+  }
+}
+
+// Background task – job steps for at most BIG_SLICE_MICROS per run, so the
+// display, pot sampling and audio keep running while 2^1000 or 500! is built.
+static void calcBigJobTask(unsigned long now) {
+  bool more = true;
+  while (more && taskHasBudget()) {
+    more = bigJobStep(&bigJob);
+  }
+  if (!more) {
+    enterCalcState(CALC_BIG_RESULT);
+  }
+}
+
+// Shifts the visible window left by one and pulls the next streamed digit.
+static void shiftBigWindow() {
+  memmove(bigWindow, bigWindow + 1, 15);
+  bigWindow[15] = bigJobNextDigit(&bigJob);
+  bigStreamDone = !bigJobHasDigits(&bigJob);
+}
+
+// Big state 5 – "[expr]: [d] dig" / streaming digits.
+// The bottom row is a 16-char window fed one digit per scroll step straight
+// from the base-10^9 chunks, so no decimal string is ever built.  Moving the
+// slider returns to program select; otherwise we leave 3 s after the last digit.
+static void handleCalcBigResult(unsigned long now) {
+  static unsigned long windowFilledFor = 0;   // stateEnteredAt of the last fill
+  if (windowFilledFor != stateEnteredAt) {
+    windowFilledFor = stateEnteredAt;
+    memset(bigWindow, ' ', 16);
+    bigWindow[16] = '\0';
+    for (int i = 0; i < 16 && bigJobHasDigits(&bigJob); i++) {
+      bigWindow[i] = bigJobNextDigit(&bigJob);
+    }
+    bigStreamDone = !bigJobHasDigits(&bigJob);
+    if (bigStreamDone) bigStreamDoneAt = now;
+    scrollTickAt = stateEnteredAt + SCROLL_START_DELAY;
+  }
+
+  char expr[12];
+  formatBigExpr(expr);
+  char top[32];
+  if (bigJob.phase == BIG_PHASE_OVERFLOW) snprintf(top, sizeof(top), "%s too big!", expr);
+  else                                    snprintf(top, sizeof(top), "%s: %lu dig", expr, (unsigned long)bigJob.digitCount);
+  if (strlen(top) > 16) snprintf(top, sizeof(top), "%s =", expr);
+  lcd.setCursor(0, 0);
+  lcd.print(top);
+
+  lcd.setCursor(0, 1);
+  if (bigJob.phase == BIG_PHASE_OVERFLOW) {
+    lcd.print("over 4096 bits  ");
+  } else {
+    if (!bigStreamDone && now >= scrollTickAt) {
+      shiftBigWindow();
+      if (bigStreamDone) bigStreamDoneAt = now;
+      // Twice the normal scroll rate – long results are mostly for show
+      scrollTickAt = now + (100UL + (unsigned long)(6 - scrollSpeed) * 50UL) / 2;
+    }
+    lcd.print(bigWindow);
+  }
+
+  if ((potHasMoved && now - stateEnteredAt >= 1000UL) ||
+      (bigStreamDone && now - bigStreamDoneAt >= 3000UL)) {
+    enterAppState(1);  // APP_PROGRAM_SELECT = 1
+  }
+}
+
+//  Float vs exact benchmark
+// Runs every operand pair 1-100 through all four operations on both paths,
+// timing each and counting results where the float string differs from the
+// correctly rounded exact string.  Output goes to Serial.
+static float calcEvaluateFloat(int a, char op, int b) {
+  switch (op) {
+    case '+': return (float)a + b;
+    case '-': return (float)a - b;
+    case '*': return (float)a * b;
+    case '/': return (float)a / b;
+  }
+  return 0.0;
+}
+
+void runCalcBenchmark() {
+  const char ops[4] = {'+', '-', '*', '/'};
+  char floatStr[24];
+  char exactStr[CALC_EXACT_BYTES];
+  unsigned long floatMicros = 0;
+  unsigned long exactMicros = 0;
+  long mismatches = 0;
+  long total = 0;
+
+  for (int o = 0; o < 4; o++) {
+    unsigned long opFloat = 0, opExact = 0;
+    long opMismatches = 0;
+    for (int a = 1; a <= 100; a++) {
+      for (int b = 1; b <= 100; b++) {
+        unsigned long t0 = micros();
+        formatCalcResult(calcEvaluateFloat(a, ops[o], b), floatStr);
+        unsigned long t1 = micros();
+        formatCalcExact(calcEvaluate(a, ops[o], b), exactStr);
+        unsigned long t2 = micros();
+        opFloat += t1 - t0;
+        opExact += t2 - t1;
+        if (strcmp(floatStr, exactStr) != 0) {
+          if (opMismatches == 0) {
+            Serial.print("  first mismatch: ");
+            Serial.print(a); Serial.print(' '); Serial.print(ops[o]); Serial.print(' '); Serial.print(b);
+            Serial.print("  float=");  Serial.print(floatStr);
+            Serial.print("  exact=");  Serial.println(exactStr);
+          }
+          opMismatches++;
+        }
+        total++;
+      }
+    }
+    Serial.print("calc ");
+    Serial.print(ops[o]);
+    Serial.print(": float ");
+    Serial.print(opFloat);
+    Serial.print(" us, exact ");
+    Serial.print(opExact);
+    Serial.print(" us, mismatches ");
+    Serial.print(opMismatches);
+    Serial.println("/10000");
+    floatMicros += opFloat;
+    exactMicros += opExact;
+    mismatches  += opMismatches;
+  }
+
+  Serial.print("calc total: float ");
+  Serial.print(floatMicros);
+  Serial.print(" us, exact ");
+  Serial.print(exactMicros);
+  Serial.print(" us, mismatches ");
+  Serial.print(mismatches);
+  Serial.print("/");
+  Serial.println(total);
+}
+
+//  Registry entry (see program_registry.h)
+static void calcEnter() { enterCalcState(CALC_TITLE); }
+static void calcExit()  { taskCancel(bigTask); }
+
+constexpr size_t CALC_STATIC_BYTES =
+  sizeof(bigA) + sizeof(bigB) + sizeof(bigScratch) + sizeof(bigJob) + sizeof(bigWindow);
+static_assert(CALC_STATIC_BYTES <= UINT16_MAX, "CALC_STATIC_BYTES does not fit ProgramInfo::staticBytes");
+
+constexpr ProgramInfo CALC_PROGRAM = {
+  "Calculator", calcEnter, handleCalculator, calcExit,
+  CALC_STATIC_BYTES,
+  CGRAM_CELEBRATION | CGRAM_PROGRESS_SLOTS,
+  NULL
+};
+
 #endif
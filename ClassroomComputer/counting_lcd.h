@@ -0,0 +1,41 @@
+#ifndef COUNTING_LCD_H
+#define COUNTING_LCD_H
+
+#include <Arduino.h>
+#include "rgb_lcd.h"
+
+//  Grove RGB LCD with an I2C byte counter
+// The rgb_lcd library has no hook on the bus, so the sketch's lcd is this
+// subclass, which adds up what each call it makes puts on the wire,
+// address byte included:
+//
+//   write, setCursor, clear, home   3   address, control, data
+//   createChar                      13  set-CGRAM command, then the 8 rows
+//                                       in one transmission
+//   setRGB                          9   three register writes
+//
+// print() goes through write(), so text is counted a character at a time.
+// begin() is not counted.  "trace" sessions report the bytes they sent
+// (pot_trace.h).
+
+#define LCD_I2C_COMMAND    3
+#define LCD_I2C_CREATECHAR (LCD_I2C_COMMAND + 10)
+#define LCD_I2C_SETRGB     (3 * 3)
+
+struct CountingLcd : rgb_lcd {
+  uint32_t i2cBytes = 0;   // since power-on
+
+  void clear()                               { i2cBytes += LCD_I2C_COMMAND; rgb_lcd::clear(); }
+  void home()                                { i2cBytes += LCD_I2C_COMMAND; rgb_lcd::home(); }
+  void setCursor(uint8_t col, uint8_t row)   { i2cBytes += LCD_I2C_COMMAND; rgb_lcd::setCursor(col, row); }
+  void createChar(uint8_t slot, byte* map)   { i2cBytes += LCD_I2C_CREATECHAR; rgb_lcd::createChar(slot, map); }
+  void setRGB(byte r, byte g, byte b)        { i2cBytes += LCD_I2C_SETRGB; rgb_lcd::setRGB(r, g, b); }
+
+  size_t write(uint8_t c) override {
+    i2cBytes += LCD_I2C_COMMAND;
+    return rgb_lcd::write(c);
+  }
+  using rgb_lcd::write;
+};
+
+#endif
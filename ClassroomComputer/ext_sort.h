@@ -0,0 +1,339 @@
+#ifndef EXT_SORT_H
+#define EXT_SORT_H
+
+#include <Arduino.h>
+
+//  External merge sort over Serial
+// Sorts more integers than the board could ever hold, with the computer on
+// the other end of the cable standing in for a disk.  The host streams the
+// input in "xsort put" lines; each time XSORT_RUN_MAX values (or run=N) have
+// arrived they are sorted in RAM and sent back as a run for the host to keep.
+// After "xsort end" the runs are merged up to `ways` at a time through a
+// small min-heap.  Every run being merged gets an equal window of the same
+// buffer, which the host refills on request.  While more than `ways` runs are
+// left, each merge writes one longer run back to the host; the last pass
+// streams the sorted result out.  Only the buffer and the heap live on the
+// board, and an input that fits in one run is sorted and sent out directly.
+//
+//   host   xsort begin [run=256] [ways=8]   start a sort (answered by xack)
+//   host   xsort put v v v ...              input values, or a requested slice
+//   host   xsort end                        no more input
+//   host   xsort [stop]                     status | abandon the sort
+//   board  xack                             send the next line
+//   board  xrun id v v v ...                append the values to stored run id
+//   board  xget id offset count             send values offset.. of run id, in put lines
+//   board  xout v v v ...                   the sorted output
+//   board  xdone n=.. runs=.. passes=.. ms=.. per_s=.. sorted=1
+//
+// The host sends one line per xack (or xget), so neither side needs flow
+// control.  Run ids count up from 0 across the passes; a run's length follows
+// from n, run and ways, so it is never sent.  passes counts run formation
+// plus every merge pass, and per_s is n over the whole exchange, Serial
+// included.  tools/xsort_peer.py plays the host, against the board or the
+// host build.
+
+#define XSORT_RUN_MAX      256   // values sorted in RAM at a time
+#define XSORT_WAYS_MAX     16
+#define XSORT_LINE_VALUES  10    // per xrun/xout line
+
+enum XsortPhase { XS_IDLE, XS_INPUT, XS_MERGE };
+
+//  One run being merged, read through its window of xsortBuf
+struct XsortWay {
+  uint32_t run;      // run id
+  uint32_t next;     // offset of the first value not yet fetched
+  uint32_t left;     // values not yet fetched
+  uint16_t base;     // window start in xsortBuf
+  uint16_t count;    // values requested for the window
+  uint16_t got;      // values received so far
+  uint16_t pos;      // next value to merge
+};
+
+//  Buffers
+static int      xsortBuf[XSORT_RUN_MAX];   // the run being formed, or the merge windows
+static int      xsortTmp[XSORT_RUN_MAX];   // mergeSortHelper scratch
+static XsortWay xsortWays[XSORT_WAYS_MAX];
+static uint8_t  xsortHeap[XSORT_WAYS_MAX]; // ways by their next value, smallest first
+static uint8_t  xsortHeapLen = 0;
+
+//  Sort state
+static XsortPhase    xsortPhase     = XS_IDLE;
+static int           xsortRun       = XSORT_RUN_MAX;
+static int           xsortFanIn     = 8;
+static uint32_t      xsortN         = 0;    // values received
+static int           xsortFill      = 0;    // values in the run being formed
+static uint32_t      xsortRuns      = 0;    // runs formed from the input
+static uint32_t      xsortNextId    = 0;    // id of the next run written
+static unsigned long xsortStartedAt = 0;
+
+//  Merge state
+static uint32_t xsortPassFirst = 0;    // id of the first run of this pass
+static uint32_t xsortPassRuns  = 0;
+static uint32_t xsortRunLen    = 0;    // length of this pass's runs (the last may be short)
+static uint32_t xsortGroup     = 0;    // runs xsortGroup·ways.. are being merged
+static uint8_t  xsortGroupWays = 0;
+static uint8_t  xsortFillNext  = 0;    // ways still to get their first window
+static int8_t   xsortWaiting   = -1;   // way whose window the host is sending
+static int      xsortPasses    = 0;
+static bool     xsortFinal     = false;
+
+//  Output
+static char     xsortLine[24 + XSORT_LINE_VALUES * 12];
+static int      xsortLineLen    = 0;
+static int      xsortLineValues = 0;
+static long     xsortOutRun     = -1;  // run id being written; -1 = xout
+static uint32_t xsortOut        = 0;   // values sent with xout
+static uint32_t xsortDescents   = 0;   // xout values smaller than the one before
+static int      xsortLast       = 0;
+
+//  Output lines
+
+static void xsortFlush() {
+  if (xsortLineValues == 0) return;
+  xsortLine[xsortLineLen++] = '\n';
+  xsortLine[xsortLineLen]   = '\0';
+  benchWrite(xsortLine);
+  xsortLineValues = 0;
+}
+
+static void xsortEmit(int v) {
+  if (xsortLineValues == 0) {
+    xsortLineLen = (xsortOutRun < 0) ? snprintf(xsortLine, sizeof(xsortLine), "xout")
+                                     : snprintf(xsortLine, sizeof(xsortLine), "xrun %ld", xsortOutRun);
+  }
+  xsortLineLen += snprintf(xsortLine + xsortLineLen, sizeof(xsortLine) - xsortLineLen, " %d", v);
+  if (++xsortLineValues == XSORT_LINE_VALUES) xsortFlush();
+
+  if (xsortOutRun < 0) {
+    if (xsortOut > 0 && v < xsortLast) xsortDescents++;
+    xsortLast = v;
+    xsortOut++;
+  }
+}
+
+//  Run formation
+
+// Sorts the values collected so far and writes them out as the next run.
+static void xsortSpill() {
+  mergeSortHelper(xsortBuf, xsortTmp, xsortFill);
+  xsortOutRun = xsortNextId++;
+  for (int i = 0; i < xsortFill; i++) xsortEmit(xsortBuf[i]);
+  xsortFlush();
+  xsortFill = 0;
+  xsortRuns++;
+}
+
+//  Merging
+
+static int xsortHead(uint8_t w) {
+  return xsortBuf[xsortWays[w].base + xsortWays[w].pos];
+}
+
+static void xsortSiftDown(uint8_t i) {
+  for (;;) {
+    uint8_t least = i, l = 2 * i + 1, r = l + 1;
+    if (l < xsortHeapLen && xsortHead(xsortHeap[l]) < xsortHead(xsortHeap[least])) least = l;
+    if (r < xsortHeapLen && xsortHead(xsortHeap[r]) < xsortHead(xsortHeap[least])) least = r;
+    if (least == i) return;
+    uint8_t t = xsortHeap[i]; xsortHeap[i] = xsortHeap[least]; xsortHeap[least] = t;
+    i = least;
+  }
+}
+
+static void xsortHeapPush(uint8_t w) {
+  uint8_t i = xsortHeapLen++;
+  xsortHeap[i] = w;
+  while (i > 0) {
+    uint8_t parent = (i - 1) / 2;
+    if (xsortHead(xsortHeap[parent]) <= xsortHead(xsortHeap[i])) return;
+    uint8_t t = xsortHeap[i]; xsortHeap[i] = xsortHeap[parent]; xsortHeap[parent] = t;
+    i = parent;
+  }
+}
+
+// Asks the host for the next window of way w's run.
+static void xsortRequest(uint8_t w) {
+  XsortWay& y = xsortWays[w];
+  uint16_t window = xsortRun / xsortGroupWays;
+  y.count = (y.left < window) ? (uint16_t)y.left : window;
+  y.got   = 0;
+  y.pos   = 0;
+  xsortWaiting = w;
+  benchPrintf("xget %lu %lu %u\n", (unsigned long)y.run, (unsigned long)y.next, y.count);
+}
+
+// Sets up the merge of group xsortGroup of the current pass.
+static void xsortStartGroup() {
+  uint32_t first = xsortGroup * xsortFanIn;
+  uint32_t left  = xsortPassRuns - first;
+  xsortGroupWays = (left < (uint32_t)xsortFanIn) ? (uint8_t)left : (uint8_t)xsortFanIn;
+  uint16_t window = xsortRun / xsortGroupWays;
+  for (uint8_t w = 0; w < xsortGroupWays; w++) {
+    uint32_t start = (first + w) * xsortRunLen;
+    XsortWay& y = xsortWays[w];
+    y.run   = xsortPassFirst + first + w;
+    y.next  = 0;
+    y.left  = (xsortN - start < xsortRunLen) ? xsortN - start : xsortRunLen;
+    y.base  = w * window;
+    y.count = y.got = y.pos = 0;
+  }
+  xsortHeapLen  = 0;
+  xsortFillNext = 0;
+  xsortOutRun   = xsortFinal ? -1 : (long)xsortNextId++;
+}
+
+static void xsortStartPass(uint32_t first, uint32_t runs, uint32_t runLen) {
+  xsortPassFirst = first;
+  xsortPassRuns  = runs;
+  xsortRunLen    = runLen;
+  xsortGroup     = 0;
+  xsortFinal     = (runs <= (uint32_t)xsortFanIn);
+  xsortPasses++;
+  xsortStartGroup();
+}
+
+static void xsortFinish() {
+  xsortFlush();
+  unsigned long ms = millis() - xsortStartedAt;
+  unsigned long perS = (unsigned long)((unsigned long long)xsortN * 1000ULL / (ms > 0 ? ms : 1));
+  benchPrintf("xdone n=%lu runs=%lu passes=%d ms=%lu per_s=%lu sorted=%d\n",
+              (unsigned long)xsortN, (unsigned long)xsortRuns, xsortPasses, ms, perS,
+              (xsortOut == xsortN && xsortDescents == 0) ? 1 : 0);
+  xsortPhase = XS_IDLE;
+}
+
+// Merges until a window needs the host or the sort is done.  At most one
+// buffer's worth of values goes out per call.
+static void xsortMerge() {
+  while (xsortWaiting < 0 && xsortPhase == XS_MERGE) {
+    if (xsortFillNext < xsortGroupWays) {
+      xsortRequest(xsortFillNext++);
+    } else if (xsortHeapLen > 0) {
+      uint8_t   w = xsortHeap[0];
+      XsortWay& y = xsortWays[w];
+      xsortEmit(xsortHead(w));
+      if (++y.pos == y.got) {
+        xsortHeap[0] = xsortHeap[--xsortHeapLen];
+        if (y.left > 0) xsortRequest(w);
+      }
+      xsortSiftDown(0);
+    } else {
+      //  Group merged: next group, next pass or done
+      xsortFlush();
+      xsortGroup++;
+      if (xsortGroup * xsortFanIn < xsortPassRuns) xsortStartGroup();
+      else if (xsortFinal)                          xsortFinish();
+      else xsortStartPass(xsortPassFirst + xsortPassRuns, xsortNextId - xsortPassFirst - xsortPassRuns,
+                          xsortRunLen * xsortFanIn);
+    }
+  }
+}
+
+//  Commands
+
+// "put": input values while XS_INPUT, the requested window while merging.
+static void xsortPut(char* args) {
+  char* tok = args ? strtok(args, " \t\r") : NULL;
+  if (xsortPhase == XS_INPUT) {
+    for (; tok; tok = strtok(NULL, " \t\r")) {
+      if (xsortFill == xsortRun) xsortSpill();   // only once more input arrives
+      xsortBuf[xsortFill++] = (int)strtol(tok, NULL, 10);
+      xsortN++;
+    }
+    benchWrite("xack\n");
+    return;
+  }
+  if (xsortPhase != XS_MERGE || xsortWaiting < 0) {
+    benchWrite("# xsort: no values expected\n");
+    return;
+  }
+  uint8_t   w = (uint8_t)xsortWaiting;
+  XsortWay& y = xsortWays[w];
+  for (; tok && y.got < y.count; tok = strtok(NULL, " \t\r")) {
+    xsortBuf[y.base + y.got++] = (int)strtol(tok, NULL, 10);
+  }
+  if (y.got < y.count) {
+    benchWrite("xack\n");
+    return;
+  }
+  y.next += y.count;
+  y.left -= y.count;
+  xsortWaiting = -1;
+  xsortHeapPush(w);
+  xsortMerge();
+}
+
+static void xsortEnd() {
+  if (xsortPhase != XS_INPUT) {
+    benchWrite("# xsort: not receiving input\n");
+    return;
+  }
+  xsortOut = xsortDescents = 0;
+  xsortPasses = 1;
+  if (xsortRuns == 0) {
+    //  Fits in RAM: one run, straight out
+    mergeSortHelper(xsortBuf, xsortTmp, xsortFill);
+    xsortRuns   = (xsortFill > 0) ? 1 : 0;
+    xsortOutRun = -1;
+    for (int i = 0; i < xsortFill; i++) xsortEmit(xsortBuf[i]);
+    xsortFinish();
+    return;
+  }
+  if (xsortFill > 0) xsortSpill();
+  xsortPhase = XS_MERGE;
+  xsortStartPass(0, xsortRuns, xsortRun);
+  xsortMerge();
+}
+
+static void xsortBegin(char* args) {
+  xsortRun   = XSORT_RUN_MAX;
+  xsortFanIn = 8;
+  for (char* tok = args ? strtok(args, " \t\r") : NULL; tok; tok = strtok(NULL, " \t\r")) {
+    if      (strncmp(tok, "run=", 4) == 0)  xsortRun   = atoi(tok + 4);
+    else if (strncmp(tok, "ways=", 5) == 0) xsortFanIn = atoi(tok + 5);
+    else benchPrintf("# ignoring '%s'\n", tok);
+  }
+  // Every way needs a window of at least two values
+  xsortFanIn = constrain(xsortFanIn, 2, XSORT_WAYS_MAX);
+  xsortRun   = constrain(xsortRun, 2 * xsortFanIn, XSORT_RUN_MAX);
+
+  xsortPhase      = XS_INPUT;
+  xsortN          = 0;
+  xsortFill       = 0;
+  xsortRuns       = 0;
+  xsortNextId     = 0;
+  xsortPasses     = 0;
+  xsortWaiting    = -1;
+  xsortLineValues = 0;
+  xsortStartedAt  = millis();
+  benchPrintf("# xsort: run=%d ways=%d\n", xsortRun, xsortFanIn);
+  benchWrite("xack\n");
+}
+
+static bool xsortBusy() {
+  return xsortPhase != XS_IDLE;
+}
+
+// args is the rest of the command line after "xsort" (may be NULL).
+static void xsortCommand(char* args) {
+  char* tok  = args ? strtok(args, " \t\r") : NULL;
+  char* rest = tok ? strtok(NULL, "") : NULL;
+  if (!tok) {
+    static const char* const PHASE_NAMES[] = { "idle", "input", "merge" };
+    benchPrintf("# xsort: %s n=%lu runs=%lu pass=%d\n", PHASE_NAMES[xsortPhase],
+                (unsigned long)xsortN, (unsigned long)xsortRuns, xsortPasses);
+  } else if (strcmp(tok, "begin") == 0) {
+    xsortBegin(rest);
+  } else if (strcmp(tok, "put") == 0) {
+    xsortPut(rest);
+  } else if (strcmp(tok, "end") == 0) {
+    xsortEnd();
+  } else if (strcmp(tok, "stop") == 0) {
+    if (xsortBusy()) benchPrintf("# xsort: stopped after %lu values\n", (unsigned long)xsortN);
+    xsortPhase = XS_IDLE;
+  } else {
+    benchPrintf("# xsort: unknown '%s'\n", tok);
+  }
+}
+
+#endif
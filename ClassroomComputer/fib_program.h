@@ -0,0 +1,319 @@
+#ifndef FIB_PROGRAM_H
+#define FIB_PROGRAM_H
+
+#include <Arduino.h>
+#include "fibonacci.h"
+#include "task_scheduler.h"
+#include "sketch_shared.h"
+#include "program_registry.h"
+
+//  Fibonacci Lab – the complexity companion of Sort Test.
+// Computes F(n) for a slider-chosen n five ways (see fibonacci.h) and shows
+// each method's time next to the number of steps it took.  The naive
+// recursion runs first, in time slices with a progress bar; once it has
+// used FIB_NAIVE_BUDGET_MS of processor time it is stopped and its total is
+// estimated from the calls still to go, which for n in the 40s and up is
+// where the gap becomes hours, years or more.  The other four methods are
+// timed by repeating them until FIB_MIN_TIME_US has passed.
+
+//  Fibonacci Lab states
+enum FibLabState {
+  FIB_TITLE,      // "Fibonacci Lab" for 1.75 s
+  FIB_QUESTION,   // "5 ways to F(n):" / "how do they grow?" for 2 s
+  FIB_SELECT_N,   // "Move slider to / choose n"
+  FIB_SHOW_N,     // "n = [n]" / F(n), until the slider is static for 1.3 s
+  FIB_CONFIRM_N,  // "Computing F(n) / for n = [n]" for 1.3 s
+  FIB_RUNNING,    // "Naive recursion / [progress] ETA", then the rest
+  FIB_RESULTS,    // one method per page, 2.5 s each
+  FIB_VALUE       // "F([n]) =" / the value, 4 s (7 s when it scrolls)
+};
+
+static const unsigned long FIB_SLICE_US        = 8000UL;
+static const unsigned long FIB_NAIVE_BUDGET_MS = 10000UL;  // then estimate
+static const uint32_t      FIB_NAIVE_CHUNK     = 256;      // calls between budget checks
+static const unsigned long FIB_MIN_TIME_US     = 2000UL;   // repeat fast methods until this long
+static const uint32_t      FIB_MAX_REPS        = 65536UL;
+static const unsigned long FIB_PAGE_MS         = 2500UL;
+
+static const char* const FIB_STEP_NAMES[FIB_METHOD_COUNT] = {
+  "calls", "entries", "loops", "products", "steps"
+};
+
+//  Naive job
+static FibNaiveJob fibJob;
+
+//  Fibonacci-specific state
+static FibLabState   fibState       = FIB_TITLE;
+static int           fibN           = 30;        // n locked in when leaving FIB_SHOW_N
+static int           fibTask        = -1;
+static int           fibStep        = 0;         // methods finished while FIB_RUNNING
+static unsigned long fibNaiveUs     = 0;         // processor time inside the naive job
+static float         fibNaiveTotal  = 0;         // calls the naive recursion needs
+static bool          fibEstimated   = false;     // naive stopped at the budget
+static float         fibNs[FIB_METHOD_COUNT];    // per evaluation
+static float         fibSteps[FIB_METHOD_COUNT];
+static uint64_t      fibValue[FIB_METHOD_COUNT];
+
+//  Forward declarations
+void enterFibState(FibLabState next);
+void handleFib(unsigned long now);
+static void fibRunTask(unsigned long now);
+static void fibReport();
+
+//  Helpers
+
+// A duration in nanoseconds as "123 ns", "4.5 µs", "2.31 s", "3.2 years"...
+static void fibFormatTime(char* out, size_t size, float ns) {
+  static const char* const UNITS[] = { "ns", "\x01s", "ms", "s", "min", "h", "days", "years" };
+  static const float SCALE[] = { 1e3f, 1e3f, 1e3f, 60.0f, 60.0f, 24.0f, 365.25f };
+  int u = 0;
+  while (u < 7 && ns >= SCALE[u]) ns /= SCALE[u++];
+  if (u == 7 && ns >= 1e4f) {
+    int exp = 0;
+    while (ns >= 10.0f) { ns /= 10.0f; exp++; }
+    snprintf(out, size, "%de%d years", (int)ns, exp);
+  } else if (ns < 10.0f && u > 0) {
+    snprintf(out, size, "%d.%02d %s", (int)ns, (int)(ns * 100.0f) % 100, UNITS[u]);
+  } else if (ns < 100.0f && u > 0) {
+    snprintf(out, size, "%d.%d %s", (int)ns, (int)(ns * 10.0f) % 10, UNITS[u]);
+  } else {
+    snprintf(out, size, "%d %s", (int)(ns + 0.5f), UNITS[u]);
+  }
+}
+
+// A step count as "39", "2692537" or, from 10^7 on, "3.9e19".
+static void fibFormatCount(char* out, size_t size, float count) {
+  if (count < 1e7f) {
+    snprintf(out, size, "%lu", (unsigned long)(count + 0.5f));
+  } else {
+    int exp = 0;
+    while (count >= 10.0f) { count /= 10.0f; exp++; }
+    snprintf(out, size, "%d.%de%d", (int)count, (int)(count * 10.0f) % 10, exp);
+  }
+}
+
+//  Implementations
+
+void enterFibState(FibLabState next) {
+  fibState       = next;
+  stateEnteredAt = millis();
+  scrollOffset   = 0;
+  scrollTickAt   = millis() + SCROLL_START_DELAY;   // F(n) rests before it scrolls
+  potHasMoved    = false;
+  setBacklight(next == FIB_RUNNING ? COL_GREEN : COL_PINK);
+  lcd.clear();
+
+  taskCancel(fibTask);
+  if (next == FIB_RUNNING) {
+    fibNaiveStart(&fibJob, fibN);
+    fibStep       = 0;
+    fibNaiveUs    = 0;
+    fibNaiveTotal = fibNaiveCalls(fibN);
+    fibEstimated  = false;
+    progressBegin(1, 0, 11);
+    fibTask = taskAdd("fib", fibRunTask, 0, TASK_PRIO_COMPUTE, FIB_SLICE_US, TASK_GROUP_PROGRAM);
+  }
+}
+
+void handleFib(unsigned long now) {
+  switch (fibState) {
+    case FIB_TITLE:
+      lcd.setCursor(0, 0);
+      lcd.print("Fibonacci Lab");
+      if (now - stateEnteredAt >= 1750UL) enterFibState(FIB_QUESTION);
+      break;
+
+    case FIB_QUESTION:
+      lcd.setCursor(0, 0);
+      lcd.print("5 ways to F(n):");
+      lcd.setCursor(0, 1);
+      lcd.print("how do they grow");
+      if (now - stateEnteredAt >= 2000UL) enterFibState(FIB_SELECT_N);
+      break;
+
+    case FIB_SELECT_N:
+      lcd.setCursor(0, 0);
+      lcd.print("Move slider to");
+      lcd.setCursor(0, 1);
+      lcd.print("choose n");
+      if (potHasMoved) enterFibState(FIB_SHOW_N);
+      break;
+
+    // n from the slider, with F(n) underneath (fast doubling is instant)
+    case FIB_SHOW_N: {
+      int n = map(potValue, 0, 1023, 1, FIB_MAX_N);
+      uint64_t steps;
+      char value[24], line[40];
+      fibFormatU64(value, fibDoubling(n, &steps));
+      snprintf(line, sizeof(line), "n = %-12d", n);
+      lcd.setCursor(0, 0);
+      lcd.print(line);
+      if (strlen(value) > 16) strcpy(value + 13, "...");
+      snprintf(line, sizeof(line), "%-16s", value);
+      lcd.setCursor(0, 1);
+      lcd.print(line);
+
+      if (potHasMoved && (now - potLastMovedAt >= 1300UL)) {
+        fibN = n;
+        bootRememberParam(fibN);
+        enterFibState(FIB_CONFIRM_N);
+      }
+      break;
+    }
+
+    case FIB_CONFIRM_N:
+      lcd.setCursor(0, 0);
+      lcd.print("Computing F(n)");
+      lcd.setCursor(0, 1);
+      lcd.print("for n = ");
+      lcd.print(fibN);
+      if (now - stateEnteredAt >= 1300UL) enterFibState(FIB_RUNNING);
+      break;
+
+    // The bar counts naive calls against the total, or the time budget when
+    // that runs out first
+    case FIB_RUNNING: {
+      lcd.setCursor(0, 0);
+      lcd.print("Naive recursion");
+      float done  = (float)fibJob.calls / fibNaiveTotal;
+      float spent = (float)fibNaiveUs / (FIB_NAIVE_BUDGET_MS * 1000.0f);
+      progressUpdate((unsigned long)(max(done, spent) * 100000.0f), 100000UL, now - stateEnteredAt);
+      break;
+    }
+
+    // One page per method: "naive    2.31 s" / "2692537 calls"
+    case FIB_RESULTS: {
+      int m = (int)((now - stateEnteredAt) / FIB_PAGE_MS);
+      if (m >= FIB_METHOD_COUNT) {
+        enterFibState(FIB_VALUE);
+        return;
+      }
+      char time[20], count[20], line[40];
+      bool guess = (m == FIB_NAIVE && fibEstimated);
+      time[0] = '~';
+      fibFormatTime(time + guess, sizeof(time) - 1, fibNs[m]);
+      snprintf(line, sizeof(line), "%-*s%s", 16 - (int)strlen(time), FIB_METHOD_NAMES[m], time);
+      line[16] = '\0';
+      lcd.setCursor(0, 0);
+      lcd.print(line);
+
+      fibFormatCount(count, sizeof(count), fibSteps[m]);
+      if (fibValue[m] != fibValue[FIB_DOUBLING] && !guess) snprintf(line, sizeof(line), "wrong result!   ");
+      else                                                 snprintf(line, sizeof(line), "%s %s%-16s", count, FIB_STEP_NAMES[m], guess ? " est" : "");
+      line[16] = '\0';
+      lcd.setCursor(0, 1);
+      lcd.print(line);
+      break;
+    }
+
+    case FIB_VALUE: {
+      char value[24], line[24];
+      snprintf(line, sizeof(line), "F(%d) =", fibN);
+      lcd.setCursor(0, 0);
+      lcd.print(line);
+      fibFormatU64(value, fibValue[FIB_DOUBLING]);
+      bool fits = strlen(value) <= 16;   // up to F(78)
+      if (fits) {
+        lcd.setCursor(0, 1);
+        lcd.print(value);
+      } else {
+        tickScroll(value, 1, now, 4, true);
+      }
+      if (now - stateEnteredAt >= (fits ? 4000UL : 7000UL)) enterAppState(1);  // APP_PROGRAM_SELECT
+      break;
+    }
+  }
+}
+
+// Background task.  Step 0 is the naive recursion, a chunk of calls at a
+// time until the slice's budget is spent; it is re-timed by repetition if
+// it finished too quickly to read, and stopped with an estimate once it has
+// had FIB_NAIVE_BUDGET_MS.  Steps 1-4 time one fast method each.
+static void fibRunTask(unsigned long now) {
+  if (fibStep == FIB_NAIVE) {
+    unsigned long t0 = micros();
+    bool more = true;
+    while (more && taskHasBudget()) more = fibNaiveStep(&fibJob, FIB_NAIVE_CHUNK);
+    fibNaiveUs += micros() - t0;
+
+    if (more && fibNaiveUs < FIB_NAIVE_BUDGET_MS * 1000UL) return;
+    fibValue[FIB_NAIVE] = fibJob.result;
+    fibSteps[FIB_NAIVE] = more ? fibNaiveTotal : (float)fibJob.calls;
+    if (more) {
+      fibEstimated    = true;
+      fibNs[FIB_NAIVE] = fibNaiveUs * 1000.0f * (fibNaiveTotal / (float)fibJob.calls);
+    } else if (fibNaiveUs >= FIB_MIN_TIME_US) {
+      fibNs[FIB_NAIVE] = fibNaiveUs * 1000.0f;
+    } else {
+      uint32_t reps = 0;
+      unsigned long t1 = micros(), us;
+      do {
+        fibNaiveStart(&fibJob, fibN);
+        while (fibNaiveStep(&fibJob, 0xFFFFFFFFUL)) {}
+        reps++;
+        us = micros() - t1;
+      } while (us < FIB_MIN_TIME_US && reps < FIB_MAX_REPS);
+      fibNs[FIB_NAIVE] = us * 1000.0f / reps;
+    }
+  } else {
+    uint64_t steps = 0;
+    uint32_t reps = 0;
+    unsigned long t0 = micros(), us;
+    do {
+      fibValue[fibStep] = fibCompute(fibStep, fibN, &steps);
+      reps++;
+      us = micros() - t0;
+    } while (us < FIB_MIN_TIME_US && reps < FIB_MAX_REPS);
+    fibNs[fibStep]    = us * 1000.0f / reps;
+    fibSteps[fibStep] = (float)steps;
+  }
+
+  fibStep++;
+  if (fibStep == FIB_METHOD_COUNT) {
+    fibReport();
+    enterFibState(FIB_RESULTS);
+  }
+}
+
+// Prints one line per method over Serial.
+static void fibReport() {
+  for (int m = 0; m < FIB_METHOD_COUNT; m++) {
+    char time[20], count[20], value[24];
+    fibFormatTime(time, sizeof(time), fibNs[m]);
+    fibFormatCount(count, sizeof(count), fibSteps[m]);
+    fibFormatU64(value, fibValue[m]);
+    Serial.print("fib: n=");
+    Serial.print(fibN);
+    Serial.print(" method=");
+    Serial.print(FIB_METHOD_NAMES[m]);
+    Serial.print(" time=");
+    char* mu = strchr(time, '\x01');
+    if (mu) *mu = 'u';  // the LCD's µ glyph
+    Serial.print(m == FIB_NAIVE && fibEstimated ? "~" : "");
+    Serial.print(time);
+    Serial.print(" steps=");
+    Serial.print(count);
+    Serial.print(" result=");
+    Serial.println(m == FIB_NAIVE && fibEstimated ? "-" : value);
+  }
+}
+
+//  Registry entry (see program_registry.h)
+static void fibEnter() { enterFibState(FIB_TITLE); }
+static void fibExit()  { taskCancel(fibTask); }
+static void fibResume(long n) {
+  fibN = constrain((int)n, 1, FIB_MAX_N);
+  enterFibState(FIB_CONFIRM_N);
+}
+
+constexpr size_t FIB_STATIC_BYTES = sizeof(fibJob);
+static_assert(FIB_STATIC_BYTES <= UINT16_MAX, "FIB_STATIC_BYTES does not fit ProgramInfo::staticBytes");
+
+constexpr ProgramInfo FIB_PROGRAM = {
+  "Fibonacci", fibEnter, handleFib, fibExit,
+  FIB_STATIC_BYTES,
+  CGRAM_PROGRESS_SLOTS,
+  fibResume
+};
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef FIBONACCI_H
+#define FIBONACCI_H
+
+#include <stdint.h>
+#include <string.h>
+
+//  Five ways to compute F(n), for the Fibonacci program and "fib" sweeps.
+// Results are 64-bit, which holds F(n) up to n = FIB_MAX_N.  Each method also
+// reports how many basic steps it took, so the growth can be compared
+// without a stopwatch:
+//
+//   naive     recursive calls        2·F(n+1) - 1      exponential (φ^n)
+//   memo      table entries filled   n - 1             linear, O(n) memory
+//   iter      loop iterations        n - 1             linear, O(1) memory
+//   matrix    2x2 products           ≤ 2·log2(n)       logarithmic
+//   doubling  doubling steps         log2(n) + 1       logarithmic
+//
+// The naive recursion runs as a job with its own stack of pending
+// arguments, so it can stop after any number of calls and carry on later;
+// that does exactly the calls the recursive definition makes, in the same
+// order.  Nothing here depends on Arduino, so it builds on the host as is.
+
+#define FIB_MAX_N 93   // F(93) = 12200160415121876738 < 2^64
+
+enum FibMethod { FIB_NAIVE, FIB_MEMO, FIB_ITER, FIB_MATRIX, FIB_DOUBLING, FIB_METHOD_COUNT };
+
+static const char* const FIB_METHOD_NAMES[FIB_METHOD_COUNT] = {
+  "naive", "memo", "iter", "matrix", "doubling"
+};
+
+//  Naive recursion, resumable
+struct FibNaiveJob {
+  uint8_t  stack[FIB_MAX_N + 1];   // arguments still to be called
+  uint8_t  sp;
+  uint64_t result;                 // sum of the leaves reached so far
+  uint64_t calls;
+};
+
+static void fibNaiveStart(FibNaiveJob* job, int n) {
+  job->stack[0] = (uint8_t)n;
+  job->sp       = 1;
+  job->result   = 0;
+  job->calls    = 0;
+}
+
+// Makes up to maxCalls calls; returns true while calls remain.
+static bool fibNaiveStep(FibNaiveJob* job, uint32_t maxCalls) {
+  while (job->sp > 0 && maxCalls-- > 0) {
+    uint8_t k = job->stack[--job->sp];
+    job->calls++;
+    if (k < 2) {
+      job->result += k;
+    } else {
+      job->stack[job->sp++] = k - 2;
+      job->stack[job->sp++] = k - 1;   // fib(k-1) first, as in fib(k-1) + fib(k-2)
+    }
+  }
+  return job->sp > 0;
+}
+
+//  Memoised: a table of every F(i) up to n, filled bottom-up (top-down
+// recursion would also need n stack frames).  The table is on the stack, so
+// its O(n) memory is only taken while the method runs, and the "mem"
+// command's stack peak for the Fibonacci screen shows it.
+static uint64_t fibMemo(int n, uint64_t* steps) {
+  uint64_t table[FIB_MAX_N + 1];
+  table[0] = 0;
+  table[1] = 1;
+  for (int i = 2; i <= n; i++) table[i] = table[i - 1] + table[i - 2];
+  *steps = (n > 1) ? n - 1 : 0;
+  return table[n];
+}
+
+//  Iterative: the last two values only
+static uint64_t fibIterative(int n, uint64_t* steps) {
+  uint64_t a = 0, b = 1;
+  for (int i = 0; i < n; i++) {
+    uint64_t t = a + b;
+    a = b;
+    b = t;
+  }
+  *steps = (n > 1) ? n - 1 : 0;
+  return a;
+}
+
+//  Matrix power: [[1,1],[1,0]]^n = [[F(n+1),F(n)],[F(n),F(n-1)]], by
+// squaring.  Entries past F(n) may wrap for n = FIB_MAX_N; F(n) itself never
+// does, since unsigned wrap-around is arithmetic mod 2^64.
+struct FibMatrix { uint64_t a, b, c, d; };
+
+static FibMatrix fibMatMul(const FibMatrix& x, const FibMatrix& y) {
+  FibMatrix r = { x.a * y.a + x.b * y.c, x.a * y.b + x.b * y.d,
+                  x.c * y.a + x.d * y.c, x.c * y.b + x.d * y.d };
+  return r;
+}
+
+static uint64_t fibMatrix(int n, uint64_t* steps) {
+  FibMatrix result = { 1, 0, 0, 1 };
+  FibMatrix base   = { 1, 1, 1, 0 };
+  uint64_t products = 0;
+  for (unsigned k = n; k > 0; k >>= 1) {
+    if (k & 1) { result = fibMatMul(result, base); products++; }
+    if (k > 1) { base = fibMatMul(base, base);     products++; }
+  }
+  *steps = products;
+  return result.b;
+}
+
+//  Fast doubling: F(2k) = F(k)·(2F(k+1) - F(k)),  F(2k+1) = F(k)² + F(k+1)²,
+// from the top bit of n down
+static uint64_t fibDoubling(int n, uint64_t* steps) {
+  uint64_t a = 0, b = 1;   // F(k), F(k+1); k = 0
+  uint64_t count = 0;
+  int bit = 0;
+  while ((n >> bit) > 1) bit++;
+  for (; n > 0 && bit >= 0; bit--) {
+    uint64_t c = a * (2 * b - a);   // F(2k)
+    uint64_t d = a * a + b * b;     // F(2k+1)
+    if ((n >> bit) & 1) { a = d; b = c + d; }
+    else                { a = c; b = d; }
+    count++;
+  }
+  *steps = count;
+  return a;
+}
+
+// Any method but naive, by number.
+static uint64_t fibCompute(uint8_t method, int n, uint64_t* steps) {
+  switch (method) {
+    case FIB_MEMO:   return fibMemo(n, steps);
+    case FIB_ITER:   return fibIterative(n, steps);
+    case FIB_MATRIX: return fibMatrix(n, steps);
+    default:         return fibDoubling(n, steps);
+  }
+}
+
+// Calls the naive recursion makes for F(n): 2·F(n+1) - 1.  As a float, since
+// it passes 2^64 at n = 93.
+static float fibNaiveCalls(int n) {
+  uint64_t steps;
+  float next = (n < FIB_MAX_N) ? (float)fibDoubling(n + 1, &steps)
+                               : (float)fibDoubling(FIB_MAX_N, &steps) * 1.618034f;  // F(94) > 2^64
+  return 2.0f * next - 1.0f;
+}
+
+// Decimal digits of v into out (at least 21 bytes).
+static void fibFormatU64(char* out, uint64_t v) {
+  char tmp[21];
+  int len = 0;
+  do { tmp[len++] = (char)('0' + v % 10); v /= 10; } while (v > 0);
+  for (int i = 0; i < len; i++) out[i] = tmp[len - 1 - i];
+  out[len] = '\0';
+}
+
+#endif
@@ -0,0 +1,326 @@
+#ifndef KV_STORE_H
+#define KV_STORE_H
+
+#include <Arduino.h>
+
+//  Persistent key/value store
+// A small log-structured store in the Uno R4's data flash, reached through
+// the EEPROM emulation library.  The region is split into two banks; records
+// are only ever appended to the active bank, so rewriting the same key (a
+// high score, a memoized prime) walks across the bank instead of wearing out
+// one location.  When the active bank is full the latest record of every key
+// is copied into the other bank, which then becomes active; the banks take
+// turns, so every byte of the region sees about the same number of writes.
+//
+// Bank layout:   'K' 'V' seqLo seqHi | record | record | ... | 0xFF (free)
+// Record layout: len crc key0 key1 key2 key3 value[len]
+//
+// A record's len byte is written last, so a record cut short by a power loss
+// still reads as free space.  The bank with the newer sequence number wins,
+// so an interrupted compaction leaves the old bank in charge.
+//
+// Memoized primes and sort timings are only a cache of things that can be
+// worked out again, and there are more of them than a bank holds.  A
+// compaction keeps the newest KV_CACHE_KEEP of each and drops the older
+// ones, so the cache never crowds out settings and scores.  When even a
+// compaction could not make room, kvPut() fails without rewriting the bank.
+//
+// Host builds (no ARDUINO define) keep the same image in a file instead.
+
+#define KV_REGION_BYTES 4096
+#define KV_BANK_BYTES   (KV_REGION_BYTES / 2)
+#define KV_HEADER_BYTES 4
+#define KV_RECORD_HDR   6
+#define KV_MAX_VALUE    32
+#define KV_FREE         0xFF
+#define KV_CACHE_KEEP   32    // records a compaction keeps per cache namespace
+
+//  Key namespaces – one byte of namespace, three bytes of id
+#define KV_NS_PRIME  1   // id = N, value = p_N (uint32)
+#define KV_NS_SORT   2   // id = N, value = SortRecord
+#define KV_NS_SCORE  3   // id = game, value = best score (int32)
+#define KV_NS_VM     4   // id 0 = code length (uint16), id 1.. = 32-byte code chunks
+#define KV_NS_PI     5   // id = x step of the pi(x) mode, value = {x, pi(x)} (uint32 pair)
+#define KV_NS_BENCH  6   // id = micro case, value = {n, baseline ns} (uint32 pair)
+#define KV_NS_BOOT   7   // id 0 = resume on/off (uint8), id 1 = last program (BootRecord)
+#define KV_NS_COUNT  8
+#define KV_KEY(ns, id) (((uint32_t)(ns) << 24) | ((uint32_t)(id) & 0xFFFFFFUL))
+
+#define KV_SCORE_PADDLE    1
+#define KV_SCORE_ASTEROIDS 2
+
+//  Backend: byte access to the region
+#ifdef ARDUINO
+#include <EEPROM.h>
+
+static void kvBackendOpen() {}
+static uint8_t kvRead(uint16_t addr)            { return EEPROM.read(addr); }
+static void    kvWrite(uint16_t addr, uint8_t v) { EEPROM.update(addr, v); }
+
+#else
+#include <stdio.h>
+
+#ifndef KV_HOST_FILE
+#define KV_HOST_FILE "classroom_kv.bin"
+#endif
+
+static uint8_t kvImage[KV_REGION_BYTES];
+static FILE*   kvFile = NULL;
+
+static void kvBackendOpen() {
+  memset(kvImage, KV_FREE, sizeof(kvImage));
+  kvFile = fopen(KV_HOST_FILE, "r+b");
+  if (kvFile) {
+    size_t got = fread(kvImage, 1, sizeof(kvImage), kvFile);
+    (void)got;  // a short file just leaves the tail erased
+  } else {
+    kvFile = fopen(KV_HOST_FILE, "w+b");
+    if (kvFile) fwrite(kvImage, 1, sizeof(kvImage), kvFile);
+  }
+  if (kvFile) fflush(kvFile);
+}
+
+static uint8_t kvRead(uint16_t addr) { return kvImage[addr]; }
+
+static void kvWrite(uint16_t addr, uint8_t v) {
+  if (kvImage[addr] == v) return;
+  kvImage[addr] = v;
+  if (kvFile) {
+    fseek(kvFile, addr, SEEK_SET);
+    fputc(v, kvFile);
+    fflush(kvFile);
+  }
+}
+#endif
+
+//  Store state
+static bool     kvReady = false;
+static uint8_t  kvBank  = 0;    // active bank (0 or 1)
+static uint16_t kvSeq   = 0;    // active bank's sequence number
+static uint16_t kvTail  = 0;    // offset of the first free byte in the active bank
+
+static uint16_t kvBankBase(uint8_t bank) { return (uint16_t)bank * KV_BANK_BYTES; }
+
+static uint8_t kvCrc8(uint32_t key, const uint8_t* data, uint8_t len) {
+  uint8_t crc = 0;
+  uint8_t keyBytes[4] = { (uint8_t)key, (uint8_t)(key >> 8), (uint8_t)(key >> 16), (uint8_t)(key >> 24) };
+  for (int i = 0; i < 4 + len; i++) {
+    crc ^= (i < 4) ? keyBytes[i] : data[i - 4];
+    for (int b = 0; b < 8; b++) crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+// Returns true and the sequence number if the bank carries a valid header.
+static bool kvBankHeader(uint8_t bank, uint16_t* seq) {
+  uint16_t base = kvBankBase(bank);
+  if (kvRead(base) != 'K' || kvRead(base + 1) != 'V') return false;
+  *seq = (uint16_t)(kvRead(base + 2) | (kvRead(base + 3) << 8));
+  return true;
+}
+
+static uint32_t kvRecordKey(uint16_t addr) {
+  return (uint32_t)kvRead(addr + 2) | ((uint32_t)kvRead(addr + 3) << 8) |
+         ((uint32_t)kvRead(addr + 4) << 16) | ((uint32_t)kvRead(addr + 5) << 24);
+}
+
+// Length of the record at bank offset off, or -1 where the log ends (free
+// space, or a damaged length byte).
+static int kvRecordLen(uint8_t bank, uint16_t off) {
+  if (off + KV_RECORD_HDR > KV_BANK_BYTES) return -1;
+  uint8_t len = kvRead(kvBankBase(bank) + off);
+  if (len == KV_FREE || len > KV_MAX_VALUE || off + KV_RECORD_HDR + len > KV_BANK_BYTES) return -1;
+  return len;
+}
+
+static bool kvRecordValid(uint16_t addr, uint8_t len) {
+  uint8_t buf[KV_MAX_VALUE];
+  for (uint8_t i = 0; i < len; i++) buf[i] = kvRead(addr + KV_RECORD_HDR + i);
+  return kvRead(addr + 1) == kvCrc8(kvRecordKey(addr), buf, len);
+}
+
+// Writes a bank header; the magic goes last so a half-written bank never
+// looks valid.
+static void kvStampHeader(uint8_t bank, uint16_t seq) {
+  uint16_t base = kvBankBase(bank);
+  kvWrite(base + 2, (uint8_t)seq);
+  kvWrite(base + 3, (uint8_t)(seq >> 8));
+  kvWrite(base + 1, 'V');
+  kvWrite(base,     'K');
+}
+
+// Erases a bank, header first.
+static void kvEraseBank(uint8_t bank) {
+  uint16_t base = kvBankBase(bank);
+  for (uint16_t i = 0; i < KV_BANK_BYTES; i++) kvWrite(base + i, KV_FREE);
+}
+
+// Appends one record at bank offset `off`; the len byte goes last.
+static void kvAppendAt(uint8_t bank, uint16_t off, uint32_t key, const uint8_t* val, uint8_t len) {
+  uint16_t addr = kvBankBase(bank) + off;
+  kvWrite(addr + 1, kvCrc8(key, val, len));
+  for (int i = 0; i < 4; i++) kvWrite(addr + 2 + i, (uint8_t)(key >> (8 * i)));
+  for (uint8_t i = 0; i < len; i++) kvWrite(addr + KV_RECORD_HDR + i, val[i]);
+  kvWrite(addr, len);
+}
+
+static void kvBegin() {
+  if (kvReady) return;
+  kvBackendOpen();
+
+  uint16_t seq0 = 0, seq1 = 0;
+  bool ok0 = kvBankHeader(0, &seq0);
+  bool ok1 = kvBankHeader(1, &seq1);
+  if (!ok0 && !ok1) {
+    kvEraseBank(0);
+    kvStampHeader(0, 1);
+    kvBank = 0; kvSeq = 1;
+  } else if (ok0 && ok1) {
+    // Sequence numbers wrap; the newer bank is the one ahead by < 32768
+    bool oneNewer = (int16_t)(seq1 - seq0) > 0;
+    kvBank = oneNewer ? 1 : 0;
+    kvSeq  = oneNewer ? seq1 : seq0;
+  } else {
+    kvBank = ok0 ? 0 : 1;
+    kvSeq  = ok0 ? seq0 : seq1;
+  }
+  int len;
+  kvTail = KV_HEADER_BYTES;
+  while ((len = kvRecordLen(kvBank, kvTail)) >= 0) kvTail += KV_RECORD_HDR + len;
+  kvReady = true;
+}
+
+// Cached results (p_N, sort timings); the primes' id 0 is the search
+// checkpoint, which is kept.
+static bool kvIsCache(uint32_t key) {
+  uint8_t ns = (uint8_t)(key >> 24);
+  return (ns == KV_NS_PRIME && (key & 0xFFFFFFUL) != 0) || ns == KV_NS_SORT;
+}
+
+// True if the record at bank offset off is valid and no later valid record
+// of the same key replaces it.
+static bool kvRecordLatest(uint8_t bank, uint16_t off, int len) {
+  uint16_t base = kvBankBase(bank);
+  if (!kvRecordValid(base + off, len)) return false;
+  uint32_t key = kvRecordKey(base + off);
+  int laterLen;
+  for (uint16_t later = off + KV_RECORD_HDR + len; (laterLen = kvRecordLen(bank, later)) >= 0;
+       later += KV_RECORD_HDR + laterLen) {
+    if (kvRecordKey(base + later) == key && kvRecordValid(base + later, laterLen)) return false;
+  }
+  return true;
+}
+
+// Walks the records a compaction keeps: the latest of every key, oldest
+// first, less the oldest cache records past KV_CACHE_KEEP per namespace.
+// Copies them into the other bank if copy is set; returns the bank offset
+// just past them either way.  Quadratic in the record count, which a 2 KB
+// bank keeps small.
+static uint16_t kvGatherLive(bool copy) {
+  uint8_t  src = kvBank, dst = kvBank ^ 1;
+  uint16_t srcBase = kvBankBase(src);
+  int      drop[KV_NS_COUNT] = { 0 };
+  int      len;
+
+  for (uint16_t off = KV_HEADER_BYTES; (len = kvRecordLen(src, off)) >= 0; off += KV_RECORD_HDR + len) {
+    uint32_t key = kvRecordKey(srcBase + off);
+    if (kvIsCache(key) && kvRecordLatest(src, off, len)) drop[key >> 24]++;
+  }
+  for (int ns = 0; ns < KV_NS_COUNT; ns++) drop[ns] -= KV_CACHE_KEEP;
+
+  uint16_t out = KV_HEADER_BYTES;
+  for (uint16_t off = KV_HEADER_BYTES; (len = kvRecordLen(src, off)) >= 0; off += KV_RECORD_HDR + len) {
+    if (!kvRecordLatest(src, off, len)) continue;
+    uint32_t key = kvRecordKey(srcBase + off);
+    if (kvIsCache(key) && drop[key >> 24] > 0) {
+      drop[key >> 24]--;
+      continue;
+    }
+    if (copy) {
+      uint8_t buf[KV_MAX_VALUE];
+      for (int i = 0; i < len; i++) buf[i] = kvRead(srcBase + off + KV_RECORD_HDR + i);
+      kvAppendAt(dst, out, key, buf, len);
+    }
+    out += KV_RECORD_HDR + len;
+  }
+  return out;
+}
+
+// Copies the records worth keeping into the other bank and makes it active.
+static void kvCompact() {
+  uint8_t dst = kvBank ^ 1;
+  kvEraseBank(dst);
+  uint16_t out = kvGatherLive(true);
+  kvStampHeader(dst, kvSeq + 1);
+
+  kvBank = dst;
+  kvSeq  = kvSeq + 1;
+  kvTail = out;
+}
+
+// Offset of the latest valid record for key in the active bank, or 0.
+static uint16_t kvFind(uint32_t key, uint8_t* foundLen) {
+  uint16_t base  = kvBankBase(kvBank);
+  uint16_t found = 0;
+  int len;
+  for (uint16_t off = KV_HEADER_BYTES; (len = kvRecordLen(kvBank, off)) >= 0; off += KV_RECORD_HDR + len) {
+    if (kvRecordKey(base + off) == key && kvRecordValid(base + off, len)) {
+      found = off;
+      *foundLen = (uint8_t)len;
+    }
+  }
+  return found;
+}
+
+// Looks up the latest value stored under key.  Returns false if the key is
+// absent or was stored with a different length.
+static bool kvGet(uint32_t key, void* out, uint8_t len) {
+  kvBegin();
+  uint8_t  foundLen = 0;
+  uint16_t off = kvFind(key, &foundLen);
+  if (off == 0 || foundLen != len) return false;
+  uint16_t addr = kvBankBase(kvBank) + off + KV_RECORD_HDR;
+  uint8_t* dst = (uint8_t*)out;
+  for (uint8_t i = 0; i < len; i++) dst[i] = kvRead(addr + i);
+  return true;
+}
+
+// Stores value under key.  Writing the value that is already stored costs
+// nothing; a full bank is compacted first.  Returns false if the value
+// cannot fit even after compaction, in which case nothing is written.
+static bool kvPut(uint32_t key, const void* value, uint8_t len) {
+  if (len > KV_MAX_VALUE) return false;
+  kvBegin();
+
+  uint8_t current[KV_MAX_VALUE];
+  if (kvGet(key, current, len) && memcmp(current, value, len) == 0) return true;
+
+  uint16_t need = KV_RECORD_HDR + len;
+  if (kvTail + need > KV_BANK_BYTES) {
+    // A compaction rewrites a whole bank, so only run one that makes room
+    if (kvGatherLive(false) + need > KV_BANK_BYTES) return false;
+    kvCompact();
+  }
+
+  kvAppendAt(kvBank, kvTail, key, (const uint8_t*)value, len);
+  kvTail += KV_RECORD_HDR + len;
+  return true;
+}
+
+//  High-score helpers
+// Returns the stored best for a game (0 if none).
+static long kvBestScore(uint8_t game) {
+  int32_t best = 0;
+  if (!kvGet(KV_KEY(KV_NS_SCORE, game), &best, sizeof(best))) return 0;
+  return best;
+}
+
+// Records score if it beats the stored best; returns true for a new best
+// that was stored.
+static bool kvRecordScore(uint8_t game, long score) {
+  if (score <= kvBestScore(game)) return false;
+  int32_t best = (int32_t)score;
+  return kvPut(KV_KEY(KV_NS_SCORE, game), &best, sizeof(best));
+}
+
+#endif
@@ -0,0 +1,329 @@
+#ifndef LIFE_PROGRAM_H
+#define LIFE_PROGRAM_H
+
+#include <Arduino.h>
+#include "pixel_canvas.h"
+#include "sketch_shared.h"
+#include "program_registry.h"
+
+//  Conway's Game of Life on the whole 80x16 pixel display.
+// The field lives in the canvas bitmap (pixel_canvas.h) and wraps around at
+// the edges.  Each generation is computed 32 cells at a time: a row word is
+// shifted left and right to line up the neighbours, and a network of
+// bit-sliced full adders counts all eight neighbours of 32 cells in a couple
+// of dozen word operations, with no per-cell loop.  The compositor then
+// uploads only the tiles and cells that changed.
+//
+// The slider sets the target generation rate; moving it shows the target
+// (or, at "max", the measured rate) over the top row for a moment.  A run
+// ends when the field dies out, settles into a still life or a period-2
+// oscillator, or after LIFE_RUN_MS.
+
+//  Life states
+enum LifeState {
+  LIFE_TITLE,    // "Game of Life" / "Slider = speed" for 2 s
+  LIFE_RUNNING,  // Random soup evolving until it settles or time runs out
+  LIFE_RESULT    // How it ended and the speed reached, for 4 s
+};
+
+enum LifeEnd { LIFE_END_DIED, LIFE_END_STILL, LIFE_END_BLINKING, LIFE_END_TIME };
+
+//  Rates selectable with the slider, generations per second; 0 = flat out
+static const int           LIFE_RATES[]      = {1, 2, 5, 10, 20, 0};
+static const int           LIFE_RATE_COUNT   = sizeof(LIFE_RATES) / sizeof(LIFE_RATES[0]);
+static const unsigned long LIFE_RATE_SHOW_MS = 1500;   // rate overlay after a slider move
+static const unsigned long LIFE_RUN_MS       = 90000;
+static const int           LIFE_SOUP_PERCENT = 35;     // initial live cells
+
+//  A glider, dropped into the soup on a cleared patch (canvasBlit rows,
+// pixel 0 = bit 31)
+static const uint32_t LIFE_GLIDER[3] = { 0x40000000UL, 0x20000000UL, 0xE0000000UL };
+
+//  Generation buffers (canvasRows holds the current generation)
+static uint32_t lifeNext[CANVAS_H][CANVAS_WORDS];
+static uint32_t lifePrev[CANVAS_H][CANVAS_WORDS];    // for period-2 detection
+static uint32_t lifeSum[CANVAS_H][CANVAS_WORDS];     // per row: left ^ centre ^ right
+static uint32_t lifeCarry[CANVAS_H][CANVAS_WORDS];   // per row: majority of the three
+
+//  Life-specific state
+static LifeState     lifeState      = LIFE_TITLE;
+static LifeEnd       lifeEnd        = LIFE_END_TIME;
+static unsigned long lifeGen        = 0;
+static int           lifeRateIdx    = -1;
+static unsigned long lifeNextGenAt  = 0;
+static unsigned long lifeRateShownAt = 0;
+static bool          lifeOverlay    = false;
+static char          lifeOverlayText[40];
+
+//  Speed stats
+static unsigned long lifeStepUsSum    = 0;
+static unsigned long lifeRenderUsSum  = 0;
+static unsigned long lifeFrames       = 0;
+static unsigned long lifeWindowAt     = 0;   // start of the current 1 s window
+static unsigned long lifeWindowGens   = 0;
+static unsigned long lifeMeasuredRate = 0;   // generations in the last window
+static unsigned long lifeRunMs        = 0;
+
+//  Forward declarations
+void enterLifeState(LifeState next);
+void handleLife(unsigned long now);
+
+//  Simulation helpers
+static void lifeSeed();
+static int  lifeStep();
+static void lifeReport();
+
+//  State handler forward declarations
+static void handleLifeTitle(unsigned long now);
+static void handleLifeRunning(unsigned long now);
+static void handleLifeResult(unsigned long now);
+
+//  Implementations
+
+void enterLifeState(LifeState next) {
+  lifeState      = next;
+  stateEnteredAt = millis();
+  potHasMoved    = false;
+  setUiFrameMs(UI_FRAME_MS);
+  setBacklight(next == LIFE_RESULT ? COL_GREEN : COL_PINK);
+  lcd.clear();
+
+  if (next == LIFE_RUNNING) {
+    canvasSlotMask = CGRAM_CELEBRATION | CGRAM_PROGRESS_SLOTS;
+    canvasReset();
+    lifeSeed();
+    lifeGen         = 0;
+    lifeRateIdx     = -1;
+    lifeNextGenAt   = millis();
+    lifeRateShownAt = 0;
+    lifeOverlay     = false;
+    lifeStepUsSum   = 0;
+    lifeRenderUsSum = 0;
+    lifeFrames      = 0;
+    lifeWindowAt    = millis();
+    lifeWindowGens  = 0;
+    lifeMeasuredRate = 0;
+  }
+}
+
+void handleLife(unsigned long now) {
+  switch (lifeState) {
+    case LIFE_TITLE:   handleLifeTitle(now);   break;
+    case LIFE_RUNNING: handleLifeRunning(now); break;
+    case LIFE_RESULT:  handleLifeResult(now);  break;
+  }
+}
+
+//  Simulation helper implementations
+
+// Random soup at LIFE_SOUP_PERCENT density, with a glider on a cleared 5x5
+// patch somewhere in it.
+static void lifeSeed() {
+  randomSeed(micros());
+  canvasClear();
+  for (int y = 0; y < CANVAS_H; y++) {
+    for (int x = 0; x < CANVAS_W; x++) {
+      if (random(100) < LIFE_SOUP_PERCENT) canvasSetPixel(x, y, true);
+    }
+  }
+  int gx = random(1, CANVAS_W - 3), gy = random(1, CANVAS_H - 3);
+  canvasFillRect(gx - 1, gy - 1, 5, 5, false);
+  canvasBlit(LIFE_GLIDER, 3, gx, gy);
+  memcpy(lifePrev, canvasRows, sizeof(lifePrev));
+}
+
+// Lines up the west and east neighbours of row word w: bit i of *west is the
+// cell left of bit i, and likewise for *east.  Column 0 and column 79 are
+// neighbours, and the 16 unused bits of the last word stay clear.
+static void lifeNeighbourWords(const uint32_t* row, int w, uint32_t* west, uint32_t* east) {
+  const uint32_t LAST_MASK = 0xFFFF0000UL;   // pixels 64-79
+  uint32_t prevWord = (w > 0) ? row[w - 1] : (row[CANVAS_WORDS - 1] >> 16) & 1;  // pixel 79
+  uint32_t nextBit  = (w < CANVAS_WORDS - 1) ? row[w + 1] >> 31 : 0;
+  *west = (row[w] >> 1) | (prevWord << 31);
+  *east = (row[w] << 1) | nextBit;
+  if (w == CANVAS_WORDS - 1) {
+    *east |= (row[0] >> 31) << 16;                       // pixel 0 beside pixel 79
+    *west &= LAST_MASK;
+    *east &= LAST_MASK;
+  }
+}
+
+// Computes the next generation into canvasRows.  A cell's eight neighbours
+// are the three cells above, the three below and the two beside it; the
+// three-cell row sums are shared by the rows above and below, so each is
+// computed once.  Returns the live-cell count, or -1 when the field repeats
+// (lifeEnd says how).
+static int lifeStep() {
+  for (int r = 0; r < CANVAS_H; r++) {
+    for (int w = 0; w < CANVAS_WORDS; w++) {
+      uint32_t west, east, mid = canvasRows[r][w];
+      lifeNeighbourWords(canvasRows[r], w, &west, &east);
+      lifeSum[r][w]   = west ^ mid ^ east;
+      lifeCarry[r][w] = (west & mid) | (east & (west ^ mid));
+    }
+  }
+
+  int  population = 0;
+  bool still = true, blinking = true;
+  for (int r = 0; r < CANVAS_H; r++) {
+    int up = (r + CANVAS_H - 1) % CANVAS_H;
+    int dn = (r + 1) % CANVAS_H;
+    for (int w = 0; w < CANVAS_WORDS; w++) {
+      uint32_t west, east, alive = canvasRows[r][w];
+      lifeNeighbourWords(canvasRows[r], w, &west, &east);
+
+      // Ones: row above + row below + the pair beside (each weight 1)
+      uint32_t a = lifeSum[up][w], b = lifeSum[dn][w], c = west ^ east;
+      uint32_t ones  = a ^ b ^ c;
+      uint32_t carry = (a & b) | (c & (a ^ b));                 // weight 2
+      // Twos: the carries of the rows above and below, of the pair beside
+      // and of the ones sum (each weight 2)
+      uint32_t d = lifeCarry[up][w], e = lifeCarry[dn][w], f = west & east;
+      uint32_t twos  = d ^ e ^ f;
+      uint32_t fours = (d & e) | (f & (d ^ e));                 // two of d, e, f
+      uint32_t oneTwo = (twos ^ carry) & ~fours;                // exactly one two
+
+      // Alive next: 3 neighbours (one two + one), or 2 and alive now
+      uint32_t next = oneTwo & (ones | alive);
+      lifeNext[r][w] = next;
+      population += __builtin_popcount(next);
+      if (next != alive)          still    = false;
+      if (next != lifePrev[r][w]) blinking = false;
+    }
+  }
+
+  memcpy(lifePrev, canvasRows, sizeof(lifePrev));
+  memcpy(canvasRows, lifeNext, sizeof(lifeNext));
+  if (population == 0) { lifeEnd = LIFE_END_DIED;     return -1; }
+  if (still)           { lifeEnd = LIFE_END_STILL;    return -1; }
+  if (blinking)        { lifeEnd = LIFE_END_BLINKING; return -1; }
+  return population;
+}
+
+// Prints the run's stats over Serial.
+static void lifeReport() {
+  Serial.print("life: gens=");
+  Serial.print(lifeGen);
+  Serial.print(" ms=");
+  Serial.print(lifeRunMs);
+  Serial.print(" step_us=");
+  Serial.print(lifeGen ? lifeStepUsSum / lifeGen : 0UL);
+  Serial.print(" render_us=");
+  Serial.print(lifeFrames ? lifeRenderUsSum / lifeFrames : 0UL);
+  Serial.print(" overflow_frames=");
+  Serial.println(canvasStats.overflowFrames);
+}
+
+//  State handlers
+
+static void handleLifeTitle(unsigned long now) {
+  lcd.setCursor(0, 0);
+  lcd.print("Game of Life");
+  lcd.setCursor(0, 1);
+  lcd.print("Slider = speed");
+
+  if (now - stateEnteredAt >= 2000UL) {
+    enterLifeState(LIFE_RUNNING);
+  }
+}
+
+static void handleLifeRunning(unsigned long now) {
+  //  Rate from the slider; the UI frame follows it so slow rates sleep
+  int idx = (int)((long)potValue * LIFE_RATE_COUNT / 1024);
+  if (idx != lifeRateIdx) {
+    if (lifeRateIdx >= 0) lifeRateShownAt = now;   // not on the first frame
+    lifeRateIdx = idx;
+    setUiFrameMs(LIFE_RATES[idx] == 0 ? 1 : UI_FRAME_MS);
+    lifeNextGenAt    = now;
+    lifeWindowAt     = now;   // measure the new rate from scratch
+    lifeWindowGens   = 0;
+    lifeMeasuredRate = 0;
+  }
+  int rate = LIFE_RATES[lifeRateIdx];
+
+  bool stepped = false;
+  if (rate == 0 || (long)(now - lifeNextGenAt) >= 0) {
+    unsigned long t0 = micros();
+    int population = lifeStep();
+    lifeStepUsSum += micros() - t0;
+    lifeGen++;
+    lifeWindowGens++;
+    stepped = true;
+    if (rate > 0) {
+      lifeNextGenAt += 1000UL / rate;
+      if ((long)(now - lifeNextGenAt) >= 0) lifeNextGenAt = now + 1000UL / rate;  // fell behind
+    }
+    if (population < 0 || now - stateEnteredAt >= LIFE_RUN_MS) {
+      if (population >= 0) lifeEnd = LIFE_END_TIME;
+      lifeRunMs = now - stateEnteredAt;
+      lifeReport();
+      enterLifeState(LIFE_RESULT);
+      return;
+    }
+  }
+  if (now - lifeWindowAt >= 1000UL) {
+    lifeMeasuredRate = lifeWindowGens * 1000UL / (now - lifeWindowAt);
+    lifeWindowAt     = now;
+    lifeWindowGens   = 0;
+  }
+
+  //  Rate overlay on the top row
+  bool overlay = lifeRateShownAt != 0 && now - lifeRateShownAt < LIFE_RATE_SHOW_MS;
+  if (overlay) {
+    char text[40];
+    if (rate > 0)                   snprintf(text, sizeof(text), "Speed: %2d gen/s ", rate);
+    else if (lifeMeasuredRate == 0) snprintf(text, sizeof(text), "Speed: max      ");
+    else                            snprintf(text, sizeof(text), "Max: %3lu gen/s  ", lifeMeasuredRate);
+    if (!lifeOverlay || strcmp(text, lifeOverlayText) != 0) {
+      canvasTextRows |= 1;
+      lcd.setCursor(0, 0);
+      lcd.print(text);
+      strcpy(lifeOverlayText, text);
+    }
+  } else if (lifeOverlay) {
+    canvasReleaseRow(0);
+    stepped = true;
+  }
+  lifeOverlay = overlay;
+
+  if (stepped || canvasStats.deferredCells > 0 || lifeFrames == 0) {
+    unsigned long t0 = micros();
+    canvasCompose();
+    lifeRenderUsSum += micros() - t0;
+    lifeFrames++;
+  }
+}
+
+static void handleLifeResult(unsigned long now) {
+  lcd.setCursor(0, 0);
+  if      (lifeEnd == LIFE_END_DIED)     lcd.print("Died out");
+  else if (lifeEnd == LIFE_END_STILL)    lcd.print("Still life");
+  else if (lifeEnd == LIFE_END_BLINKING) lcd.print("Oscillating");
+  else                                   lcd.print("Time's up");
+
+  char line[32];
+  unsigned long perSec10 = lifeRunMs ? lifeGen * 10000UL / lifeRunMs : 0;
+  snprintf(line, sizeof(line), "%lu gen %lu.%lu/s", lifeGen, perSec10 / 10, perSec10 % 10);
+  lcd.setCursor(0, 1);
+  lcd.print(line);
+
+  if (now - stateEnteredAt >= 4000UL) {
+    enterAppState(1);  // APP_PROGRAM_SELECT
+  }
+}
+
+//  Registry entry (see program_registry.h)
+static void lifeEnter() { enterLifeState(LIFE_TITLE); }
+
+constexpr size_t LIFE_STATIC_BYTES =
+  sizeof(lifeNext) + sizeof(lifePrev) + sizeof(lifeSum) + sizeof(lifeCarry);
+static_assert(LIFE_STATIC_BYTES <= UINT16_MAX, "LIFE_STATIC_BYTES does not fit ProgramInfo::staticBytes");
+
+constexpr ProgramInfo LIFE_PROGRAM = {
+  "Life", lifeEnter, handleLife, NULL,
+  LIFE_STATIC_BYTES,
+  CGRAM_CELEBRATION | CGRAM_PROGRESS_SLOTS,
+  NULL
+};
+
+#endif
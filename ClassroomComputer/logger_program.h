@@ -0,0 +1,314 @@
+#ifndef LOGGER_PROGRAM_H
+#define LOGGER_PROGRAM_H
+
+#include <Arduino.h>
+#include "sensor_stats.h"
+#include "task_scheduler.h"
+#include "sketch_shared.h"
+#include "program_registry.h"
+
+//  Sensor Logger – the temperature sensor on TEMP_PIN, sampled on a fixed
+// timer (adapted from snippets/Temp_with_LCD.txt).  A periodic task takes
+// one sample per release, converts it with the table in sensor_stats.h and
+// pushes it into a SENSOR_WINDOW-sample window, so a sample costs the same
+// few microseconds at every rate and the screen never waits on it.  The
+// screen redraws four times a second:
+//
+//   row 0   current temperature, sample rate, sparkline of the window
+//   row 1   window min/max, then mean/standard deviation, alternating
+//
+// The sparkline is five custom characters (slots 0 and 4-7), 25 bars each
+// showing the mean of 1/25 of the window, scaled between its min and max.
+// The backlight follows the window mean: blue up to 68 °F, green up to
+// 71 °F, red above, as in the snippet.
+//
+// The slider picks the rate; parking it at the far left for 2 s ends the
+// run.  Changing the rate starts a new window.
+//
+// Serial: "logger" prints the window statistics, "logger dump" the window
+// itself, "logger run" starts the program and "logger synth on|off" swaps
+// the sensor for a synthetic signal (a triangle wave between ADC counts 480
+// and 560 with a little pseudo-random noise) so host builds and boards
+// without the sensor produce known numbers.
+
+//  Logger states
+enum LoggerState {
+  LOGGER_TITLE,    // "Sensor Logger" / "Slider = rate" for 1.5 s
+  LOGGER_RUNNING,  // sampling until the slider is held at the far left
+  LOGGER_SUMMARY   // samples taken and the session's range, 3 s
+};
+
+static const int           LOGGER_RATES_HZ[]  = {1, 10, 100, 1000};
+static const int           LOGGER_RATE_COUNT  = sizeof(LOGGER_RATES_HZ) / sizeof(LOGGER_RATES_HZ[0]);
+static const int           LOGGER_EXIT_MAX    = 153;     // ≤ 15%: hold to exit
+static const unsigned long LOGGER_EXIT_HOLD   = 2000;
+static const unsigned long LOGGER_DRAW_MS     = 250;
+static const unsigned long LOGGER_PAGE_MS     = 2000;    // row 1 alternates
+static const int           LOGGER_SPARK_CELLS = 5;
+static const int           LOGGER_SPARK_BARS  = LOGGER_SPARK_CELLS * 5;
+static const uint8_t       LOGGER_SPARK_SLOT[LOGGER_SPARK_CELLS] = {0, 4, 5, 6, 7};
+
+static const int LOGGER_COOL_TENTHS = 680;   // ≤ 68.0 °F: blue
+static const int LOGGER_WARM_TENTHS = 710;   // ≤ 71.0 °F: green, above: red
+static const byte LOGGER_COL_COOL[3] = {  0,   0, 255};
+static const byte LOGGER_COL_MILD[3] = {  0, 255,   0};
+static const byte LOGGER_COL_WARM[3] = {255,   0,   0};
+
+//  Sample window (sensor_stats.h)
+static SensorWindow loggerWin;
+
+//  Logger-specific state
+static LoggerState   loggerState      = LOGGER_TITLE;
+static int           loggerTask       = -1;
+static int           loggerRateIdx    = -1;
+static bool          loggerSynth      = false;
+static uint32_t      loggerSynthN     = 0;       // synthetic signal phase
+static uint32_t      loggerSynthSeed  = 1;
+static uint32_t      loggerDrawnCount = 0;       // loggerWin.count at the last redraw
+static unsigned long loggerDrawnAt    = 0;
+static unsigned long loggerExitSince  = 0;       // 0 = slider not in the exit zone
+static bool          loggerExitShown  = false;
+static const byte*   loggerColour     = NULL;
+
+//  Whole session (across rate changes)
+static unsigned long loggerSamples    = 0;
+static int16_t       loggerSessionMin = 0;
+static int16_t       loggerSessionMax = 0;
+
+//  Forward declarations
+void enterLoggerState(LoggerState next);
+void handleLogger(unsigned long now);
+static void loggerSampleRun(unsigned long now);
+
+//  Helpers
+
+// Triangle wave over 400 samples between counts 480 and 560, plus 0-3
+// counts of xorshift noise.
+static int loggerSynthAdc() {
+  uint32_t phase = loggerSynthN++ % 400;
+  int tri = (phase < 200) ? (int)phase : 400 - (int)phase;
+  loggerSynthSeed ^= loggerSynthSeed << 13;
+  loggerSynthSeed ^= loggerSynthSeed >> 17;
+  loggerSynthSeed ^= loggerSynthSeed << 5;
+  return 480 + tri * 80 / 200 + (int)(loggerSynthSeed & 3);
+}
+
+// Tenths of a degree as "-12.3" / "72.4", right-aligned in width columns.
+static void loggerFormatTenths(char* out, size_t size, int16_t tenths, int width) {
+  char num[16];
+  unsigned mag = (tenths < 0) ? -tenths : tenths;
+  snprintf(num, sizeof(num), "%s%u.%u", tenths < 0 ? "-" : "", mag / 10, mag % 10);
+  snprintf(out, size, "%*s", width, num);
+}
+
+static void loggerStartWindow(int rateIdx) {
+  loggerRateIdx = rateIdx;
+  sensorReset(&loggerWin);
+  loggerDrawnCount = 0;
+  taskCancel(loggerTask);
+  loggerTask = taskAdd("logger", loggerSampleRun, 1000UL / LOGGER_RATES_HZ[rateIdx],
+                       TASK_PRIO_INPUT, 0, TASK_GROUP_PROGRAM);
+}
+
+// Redefines the sparkline glyphs and prints them at columns 11-15 of row 0.
+static void loggerDrawSparkline() {
+  int n = sensorCount(&loggerWin);
+  int lo = sensorMin(&loggerWin), span = sensorMax(&loggerWin) - lo;
+  uint8_t height[LOGGER_SPARK_BARS];
+  for (int b = 0; b < LOGGER_SPARK_BARS; b++) {
+    int from = (long)b * n / LOGGER_SPARK_BARS, to = (long)(b + 1) * n / LOGGER_SPARK_BARS;
+    if (to <= from) { height[b] = 0; continue; }            // fewer samples than bars
+    long sum = 0;
+    for (int i = from; i < to; i++) sum += sensorAt(&loggerWin, i);
+    long mean = sum / (to - from);
+    height[b] = (span == 0) ? 4 : (uint8_t)(1 + (mean - lo) * 7 / span);
+  }
+  for (int c = 0; c < LOGGER_SPARK_CELLS; c++) {
+    byte glyph[8];
+    for (int r = 0; r < 8; r++) {
+      byte bits = 0;
+      for (int k = 0; k < 5; k++) {
+        if (height[c * 5 + k] >= 8 - r) bits |= 0x10 >> k;
+      }
+      glyph[r] = bits;
+    }
+    lcd.createChar(LOGGER_SPARK_SLOT[c], glyph);
+  }
+  lcd.setCursor(16 - LOGGER_SPARK_CELLS, 0);
+  for (int c = 0; c < LOGGER_SPARK_CELLS; c++) lcd.write(LOGGER_SPARK_SLOT[c]);
+}
+
+static void loggerReport() {
+  char lo[16], hi[16];
+  loggerFormatTenths(lo, sizeof(lo), loggerSessionMin, 0);
+  loggerFormatTenths(hi, sizeof(hi), loggerSessionMax, 0);
+  benchPrintf("logger: samples=%lu source=%s min_f=%s max_f=%s\n",
+              loggerSamples, loggerSynth ? "synth" : "sensor", lo, hi);
+}
+
+//  Implementations
+
+void enterLoggerState(LoggerState next) {
+  loggerState    = next;
+  stateEnteredAt = millis();
+  potHasMoved    = false;
+  setUiFrameMs(UI_FRAME_MS);
+  setBacklight(next == LOGGER_SUMMARY ? COL_GREEN : COL_PINK);
+  lcd.clear();
+
+  taskCancel(loggerTask);
+  loggerTask = -1;
+  if (next == LOGGER_RUNNING) {
+    loggerRateIdx   = -1;
+    loggerSamples   = 0;
+    loggerExitSince = 0;
+    loggerExitShown = false;
+    loggerDrawnAt   = 0;
+    loggerColour    = NULL;
+  }
+  if (next == LOGGER_SUMMARY) loggerReport();
+}
+
+void handleLogger(unsigned long now) {
+  switch (loggerState) {
+    case LOGGER_TITLE:
+      lcd.setCursor(0, 0);
+      lcd.print("Sensor Logger");
+      lcd.setCursor(0, 1);
+      lcd.print("Slider = rate");
+      if (now - stateEnteredAt >= 1500UL) enterLoggerState(LOGGER_RUNNING);
+      break;
+
+    case LOGGER_RUNNING: {
+      //  Rate from the slider; the far left is the exit zone
+      if (potHasMoved && potValue <= LOGGER_EXIT_MAX && loggerRateIdx >= 0) {
+        if (loggerExitSince == 0) loggerExitSince = now;
+        if (now - loggerExitSince >= LOGGER_EXIT_HOLD) { enterLoggerState(LOGGER_SUMMARY); return; }
+      } else {
+        loggerExitSince = 0;
+        int idx = (int)((long)(max(potValue, LOGGER_EXIT_MAX + 1) - LOGGER_EXIT_MAX - 1) * LOGGER_RATE_COUNT
+                        / (1024 - LOGGER_EXIT_MAX - 1));
+        if (idx != loggerRateIdx) loggerStartWindow(idx);
+      }
+
+      bool exiting = (loggerExitSince != 0);
+      if (loggerWin.count == 0 || now - loggerDrawnAt < LOGGER_DRAW_MS) break;
+      if (loggerWin.count == loggerDrawnCount && exiting == loggerExitShown) break;
+      loggerDrawnAt    = now;
+      loggerDrawnCount = loggerWin.count;
+      loggerExitShown  = exiting;
+
+      //  Row 0: latest sample and rate, then the sparkline
+      char line[40], a[16], b[16], rate[16];
+      int hz = LOGGER_RATES_HZ[loggerRateIdx];
+      loggerFormatTenths(a, sizeof(a), sensorAt(&loggerWin, sensorCount(&loggerWin) - 1), 0);
+      strcat(a, "F");
+      if (hz >= 1000) snprintf(rate, sizeof(rate), "%dk/s", hz / 1000);
+      else            snprintf(rate, sizeof(rate), "%d/s", hz);
+      snprintf(line, sizeof(line), "%-6s%5s", a, rate);
+      lcd.setCursor(0, 0);
+      lcd.print(line);
+      loggerDrawSparkline();
+
+      //  Row 1: min/max or mean/sd, or the exit countdown
+      float mean = sensorMean(&loggerWin);
+      if (exiting) {
+        snprintf(line, sizeof(line), "Hold to exit... ");
+      } else if ((now - stateEnteredAt) / LOGGER_PAGE_MS % 2 == 0) {
+        loggerFormatTenths(a, sizeof(a), sensorMin(&loggerWin), 5);
+        loggerFormatTenths(b, sizeof(b), sensorMax(&loggerWin), 5);
+        snprintf(line, sizeof(line), "lo%s hi%s ", a, b);
+      } else {
+        unsigned long sd100 = (unsigned long)(sqrtf(sensorVariance(&loggerWin)) * 10.0f + 0.5f);
+        loggerFormatTenths(a, sizeof(a), lround(mean), 5);
+        snprintf(line, sizeof(line), "av%s sd%2u.%02u", a, (unsigned)(sd100 / 100), (unsigned)(sd100 % 100));
+      }
+      lcd.setCursor(0, 1);
+      lcd.print(line);
+
+      //  Backlight from the window mean
+      const byte* colour = (mean <= LOGGER_COOL_TENTHS) ? LOGGER_COL_COOL
+                         : (mean <= LOGGER_WARM_TENTHS) ? LOGGER_COL_MILD : LOGGER_COL_WARM;
+      if (colour != loggerColour) {
+        setBacklight(colour);
+        loggerColour = colour;
+      }
+      break;
+    }
+
+    case LOGGER_SUMMARY: {
+      char line[40], a[16], b[16];
+      snprintf(line, sizeof(line), "%lu samples", loggerSamples);
+      lcd.setCursor(0, 0);
+      lcd.print(line);
+      if (loggerSamples > 0) {
+        loggerFormatTenths(a, sizeof(a), loggerSessionMin, 5);
+        loggerFormatTenths(b, sizeof(b), loggerSessionMax, 5);
+        snprintf(line, sizeof(line), "lo%s hi%s", a, b);
+        lcd.setCursor(0, 1);
+        lcd.print(line);
+      }
+      if (now - stateEnteredAt >= 3000UL) enterAppState(1);  // APP_PROGRAM_SELECT
+      break;
+    }
+  }
+}
+
+// Periodic task – one sample per release.
+static void loggerSampleRun(unsigned long now) {
+  int adc = loggerSynth ? loggerSynthAdc() : analogRead(TEMP_PIN);
+  int16_t t = thermistorTenthsF(adc);
+  sensorPush(&loggerWin, t);
+  if (loggerSamples == 0 || t < loggerSessionMin) loggerSessionMin = t;
+  if (loggerSamples == 0 || t > loggerSessionMax) loggerSessionMax = t;
+  loggerSamples++;
+}
+
+//  Serial commands: logger [run | dump | synth on|off]
+// args is the rest of the command line after "logger" (may be NULL).
+static void loggerCommand(char* args) {
+  char* sub = args ? strtok(args, " \t\r") : NULL;
+
+  if (sub && strcmp(sub, "run") == 0) {
+    enterProgramNamed("Logger");
+  } else if (sub && strcmp(sub, "synth") == 0) {
+    char* arg = strtok(NULL, " \t\r");
+    loggerSynth     = arg && strcmp(arg, "on") == 0;
+    loggerSynthN    = 0;
+    loggerSynthSeed = 1;
+    benchPrintf("# logger: source=%s\n", loggerSynth ? "synth" : "sensor");
+  } else if (sub && strcmp(sub, "dump") == 0) {
+    benchWrite("i,tenths_f\n");
+    int n = (loggerWin.count > 0) ? sensorCount(&loggerWin) : 0;
+    for (int i = 0; i < n; i++) benchPrintf("%d,%d\n", i, sensorAt(&loggerWin, i));
+  } else if (sub) {
+    benchWrite("# logger [run|dump|synth on|off]\n");
+  } else if (loggerWin.count == 0) {
+    benchWrite("# logger: no samples\n");
+  } else {
+    char lo[16], hi[16], mean[16];
+    unsigned long sd100 = (unsigned long)(sqrtf(sensorVariance(&loggerWin)) * 10.0f + 0.5f);
+    loggerFormatTenths(lo, sizeof(lo), sensorMin(&loggerWin), 0);
+    loggerFormatTenths(hi, sizeof(hi), sensorMax(&loggerWin), 0);
+    loggerFormatTenths(mean, sizeof(mean), lround(sensorMean(&loggerWin)), 0);
+    benchPrintf("# logger: rate_hz=%d source=%s samples=%lu n=%d min_f=%s max_f=%s mean_f=%s sd_f=%lu.%02lu\n",
+                loggerRateIdx >= 0 ? LOGGER_RATES_HZ[loggerRateIdx] : 0, loggerSynth ? "synth" : "sensor",
+                loggerSamples, sensorCount(&loggerWin), lo, hi, mean, sd100 / 100, sd100 % 100);
+  }
+}
+
+//  Registry entry (see program_registry.h)
+static void loggerEnter() { enterLoggerState(LOGGER_TITLE); }
+static void loggerExit()  { taskCancel(loggerTask); }
+
+constexpr size_t LOGGER_STATIC_BYTES = sizeof(loggerWin);
+static_assert(LOGGER_STATIC_BYTES <= UINT16_MAX, "LOGGER_STATIC_BYTES does not fit ProgramInfo::staticBytes");
+
+constexpr ProgramInfo LOGGER_PROGRAM = {
+  "Logger", loggerEnter, handleLogger, loggerExit,
+  LOGGER_STATIC_BYTES,
+  CGRAM_CELEBRATION | CGRAM_PROGRESS_SLOTS,
+  NULL
+};
+
+#endif
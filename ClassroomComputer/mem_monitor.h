@@ -0,0 +1,101 @@
+#ifndef MEM_MONITOR_H
+#define MEM_MONITOR_H
+
+#include <Arduino.h>
+
+//  RAM and stack monitor
+// memBegin() paints the unused part of the stack with MEM_PAINT at boot;
+// memStackPeak() then scans up from the stack limit for the first word that
+// is no longer painted, which is the deepest the stack has reached.
+// memResetPeak() repaints everything below the caller's frame so that the
+// next peak belongs to whatever runs from then on (the sketch does this once
+// per top-level state).
+//
+// Host builds (no ARDUINO define) cannot paint below the stack pointer, so
+// they track the lowest frame address through -finstrument-functions hooks
+// instead; make -C host sketch-mem builds host/build/sketch-mem with that
+// flag.  Without it the peak is the lowest frame seen by memSample().
+
+#define MEM_PAINT          0xA5A5A5A5UL
+#define MEM_PAINT_MARGIN   64      // bytes left unpainted below the caller (ISR frames)
+
+#ifdef ARDUINO
+#include <malloc.h>
+
+// Linker script symbols (Renesas FSP fsp.ld)
+extern uint32_t __StackLimit;
+extern uint32_t __StackTop;
+extern uint32_t __HeapBase;
+extern uint32_t __HeapLimit;
+extern uint32_t __data_start__;
+extern uint32_t __bss_end__;
+extern "C" void* _sbrk(int incr);
+
+static unsigned long memStackSize()   { return (uintptr_t)&__StackTop - (uintptr_t)&__StackLimit; }
+static unsigned long memStaticBytes() { return (uintptr_t)&__bss_end__ - (uintptr_t)&__data_start__; }
+static unsigned long memHeapUsed()    { return mallinfo().uordblks; }
+static unsigned long memHeapFree()    { return (uintptr_t)&__HeapLimit - (uintptr_t)_sbrk(0); }
+
+static void memResetPeak() {
+  uint32_t here;
+  uint32_t* end = (uint32_t*)((uintptr_t)&here - MEM_PAINT_MARGIN);
+  noInterrupts();
+  for (uint32_t* p = &__StackLimit; p < end; p++) *p = MEM_PAINT;
+  interrupts();
+}
+
+static void memBegin() { memResetPeak(); }
+
+static unsigned long memStackPeak() {
+  uint32_t* p = &__StackLimit;
+  while (p < &__StackTop && *p == MEM_PAINT) p++;
+  return (uintptr_t)&__StackTop - (uintptr_t)p;
+}
+
+static void memSample() {}  // the painted stack records every call
+
+#else
+#include <malloc.h>
+#include <sys/resource.h>
+
+extern char __data_start[];  // GNU ld, start of .data
+extern char _end[];          // GNU ld, end of .bss
+
+static uintptr_t memTop    = 0;               // frame address in memBegin(), just below setup()
+static uintptr_t memLowest = (uintptr_t)-1;   // lowest frame address since the last reset
+
+extern "C" {
+__attribute__((no_instrument_function)) void __cyg_profile_func_enter(void*, void*) {
+  uintptr_t fp = (uintptr_t)__builtin_frame_address(0);
+  if (fp < memLowest) memLowest = fp;
+}
+__attribute__((no_instrument_function)) void __cyg_profile_func_exit(void*, void*) {}
+}
+
+static unsigned long memStackSize() {
+  struct rlimit rl;
+  getrlimit(RLIMIT_STACK, &rl);
+  return (rl.rlim_cur == RLIM_INFINITY) ? 8UL << 20 : (unsigned long)rl.rlim_cur;
+}
+static unsigned long memStaticBytes() { return (unsigned long)(_end - __data_start); }
+static unsigned long memHeapUsed()    { return mallinfo2().uordblks; }
+static unsigned long memHeapFree()    { return mallinfo2().fordblks; }
+
+__attribute__((no_instrument_function)) static void memSample() {
+  uintptr_t fp = (uintptr_t)__builtin_frame_address(0);
+  if (fp < memLowest) memLowest = fp;
+}
+
+__attribute__((no_instrument_function)) static void memResetPeak() {
+  memLowest = (uintptr_t)__builtin_frame_address(0);
+}
+
+__attribute__((no_instrument_function)) static void memBegin() {
+  memTop = (uintptr_t)__builtin_frame_address(0);
+  memResetPeak();
+}
+
+static unsigned long memStackPeak() { return (memLowest < memTop) ? memTop - memLowest : 0; }
+#endif
+
+#endif
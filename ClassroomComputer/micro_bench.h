@@ -0,0 +1,265 @@
+#ifndef MICRO_BENCH_H
+#define MICRO_BENCH_H
+
+#include <Arduino.h>
+#include "kv_store.h"
+#include "task_scheduler.h"
+#include "sketch_shared.h"
+#include "sensor_stats.h"
+
+//  Kernel microbenchmarks
+// "micro" times each small kernel the programs are built from over a few
+// input sizes and prints the results as one JSON object:
+//
+//   {"suite":"micro","platform":"uno-r4","threshold_pct":10,"results":[
+//   {"kernel":"isPrime","n":1009,"calls":4096,"reps":5,"ns_min":...,"ns_mean":...,
+//    "baseline_ns":...,"delta_pct":...,"status":"ok"},
+//   ...
+//   ],"regressions":0}
+//
+// Each case first doubles its call count until one repetition takes
+// MICRO_REP_US (which also warms it up), then times MICRO_REPS repetitions of
+// that many calls; ns_* are per call.  "micro save" runs the suite and
+// stores ns_min of every case as the baseline (KV_NS_BENCH, so it survives a
+// power-off, and host builds keep it in their KV file).  Later runs compare
+// against it and mark a case "regression" when ns_min is more than
+// threshold_pct slower.  The same list runs on the board and on the host
+// (echo "micro" | host/build/sketch), so the two sets of numbers line up case
+// by case.  The host's reference numbers are checked in as
+// host/micro_baseline.json; make -C host micro-check compares a fresh run
+// against them with tools/micro_compare.py and fails on a regression.
+//
+// One case runs per scheduler pass, like the sweeps in bench_serial.h.  The
+// sorts work in their own MICRO_SORT_MAX buffers, so "micro" can run while
+// the Sort Test or a sort sweep holds sortBuf and mergeTmp.
+// tickScroll draws on row 0 for its case; the screen redraws on its next frame.
+// sensorPush fills a window of its own, so a running Logger keeps its samples.
+//
+//   micro [pct=N]        run and compare (default threshold 10 %)
+//   micro save           run and store the results as the new baseline
+//   micro stop
+
+#define MICRO_REPS            5
+#define MICRO_REP_US          2000UL  // shortest timed repetition
+#define MICRO_MAX_CALLS       1048576UL
+#define MICRO_THRESHOLD_PCT   10
+#define MICRO_SORT_MAX        64      // items in the private sort buffers
+
+enum MicroKernel { MK_IS_PRIME, MK_BUBBLE, MK_MERGE, MK_FORMAT, MK_COMMAS, MK_ORDINAL, MK_SCROLL, MK_SENSOR };
+
+static const char* const MICRO_KERNEL_NAMES[] = {
+  "isPrime", "bubbleSort", "mergeSortHelper", "formatCalcResult",
+  "addCommasToIntStr", "ordinalSuffix", "tickScroll", "sensorPush"
+};
+
+struct MicroCase {
+  uint8_t kernel;
+  long    n;        // input size: the number tested, items sorted, digits, string length
+};
+
+static constexpr MicroCase MICRO_CASES[] = {
+  { MK_IS_PRIME, 1009 },      // primes, so every divisor is tried
+  { MK_IS_PRIME, 100003 },
+  { MK_IS_PRIME, 10000019 },
+  { MK_BUBBLE,   10 },
+  { MK_BUBBLE,   32 },
+  { MK_BUBBLE,   64 },
+  { MK_MERGE,    10 },
+  { MK_MERGE,    32 },
+  { MK_MERGE,    64 },
+  { MK_FORMAT,   100 },       // formats (n + i) / 7
+  { MK_FORMAT,   1000000 },
+  { MK_COMMAS,   3 },         // digit count
+  { MK_COMMAS,   10 },
+  { MK_ORDINAL,  100 },       // ordinalSuffix(1..100) per call
+  { MK_SCROLL,   20 },        // string length
+  { MK_SCROLL,   60 },
+  { MK_SENSOR,   1000 }       // samples converted and pushed per call
+};
+static constexpr int MICRO_CASE_COUNT = sizeof(MICRO_CASES) / sizeof(MICRO_CASES[0]);
+
+//  Sort cases must fit the private buffers
+constexpr bool microIsSort(const MicroCase& c) { return c.kernel == MK_BUBBLE || c.kernel == MK_MERGE; }
+constexpr bool microSortsFit(int i = 0) {
+  return i == MICRO_CASE_COUNT ||
+         ((!microIsSort(MICRO_CASES[i]) || MICRO_CASES[i].n <= MICRO_SORT_MAX) && microSortsFit(i + 1));
+}
+static_assert(microSortsFit(), "a sort case is larger than MICRO_SORT_MAX");
+
+static int microSortBuf[MICRO_SORT_MAX];
+static int microSortTmp[MICRO_SORT_MAX];
+static SensorWindow microSensorWin;   // the sensorPush case's, not the Logger's
+
+//  Run in progress
+static int           microTask        = -1;
+static int           microNext        = 0;     // next case
+static bool          microSaving      = false;
+static int           microThreshold   = MICRO_THRESHOLD_PCT;
+static int           microRegressions = 0;
+static volatile long microSink        = 0;     // keeps results live
+
+static void microTaskRun(unsigned long now);
+
+// Untimed set-up of the sort input for one call
+static void microFillSort(long n) {
+  for (long i = 0; i < n; i++) microSortBuf[i] = random(10000);
+}
+
+// One timed repetition of `calls` calls of case c; returns microseconds spent
+// inside the kernel.
+static unsigned long microRep(const MicroCase& c, unsigned long calls) {
+  unsigned long us = 0;
+  unsigned long t0;
+  char in[24], out[32];
+
+  switch (c.kernel) {
+    case MK_IS_PRIME:
+      t0 = micros();
+      for (unsigned long i = 0; i < calls; i++) microSink += isPrime(c.n);
+      us = micros() - t0;
+      break;
+
+    case MK_BUBBLE:
+    case MK_MERGE:
+      for (unsigned long i = 0; i < calls; i++) {
+        microFillSort(c.n);
+        t0 = micros();
+        if (c.kernel == MK_BUBBLE) bubbleSort(microSortBuf, (int)c.n);
+        else                       mergeSortHelper(microSortBuf, microSortTmp, (int)c.n);
+        us += micros() - t0;
+      }
+      microSink += microSortBuf[0];
+      break;
+
+    case MK_FORMAT:
+      t0 = micros();
+      for (unsigned long i = 0; i < calls; i++) {
+        formatCalcResult((float)(c.n + i) / 7.0f, out);
+        microSink += out[0];
+      }
+      us = micros() - t0;
+      break;
+
+    case MK_COMMAS:
+      for (long i = 0; i < c.n; i++) in[i] = (char)('1' + i % 9);
+      in[c.n] = '\0';
+      t0 = micros();
+      for (unsigned long i = 0; i < calls; i++) {
+        addCommasToIntStr(in, out);
+        microSink += out[1];
+      }
+      us = micros() - t0;
+      break;
+
+    case MK_ORDINAL:
+      t0 = micros();
+      for (unsigned long i = 0; i < calls; i++) {
+        for (long k = 1; k <= c.n; k++) microSink += ordinalSuffix((int)k)[0];
+      }
+      us = micros() - t0;
+      break;
+
+    case MK_SCROLL: {
+      char text[64];
+      for (long i = 0; i < c.n; i++) text[i] = (char)('A' + i % 26);
+      text[c.n] = '\0';
+      int           savedOffset = scrollOffset;
+      unsigned long savedTickAt = scrollTickAt;
+      t0 = micros();
+      for (unsigned long i = 0; i < calls; i++) {
+        scrollTickAt = 0;  // every call advances and redraws
+        tickScroll(text, 0, millis(), 4, true);
+      }
+      us = micros() - t0;
+      scrollOffset = savedOffset;
+      scrollTickAt = savedTickAt;
+      break;
+    }
+
+    case MK_SENSOR:
+      sensorReset(&microSensorWin);
+      t0 = micros();
+      for (unsigned long i = 0; i < calls; i++) {
+        for (long k = 0; k < c.n; k++) sensorPush(&microSensorWin, thermistorTenthsF((int)((k * 37 + i) & 1023)));
+      }
+      us = micros() - t0;
+      microSink += microSensorWin.sum;
+      break;
+  }
+  return us;
+}
+
+static void microRunCase(int idx) {
+  const MicroCase& c = MICRO_CASES[idx];
+  unsigned long calls = 1;
+  while (calls < MICRO_MAX_CALLS && microRep(c, calls) < MICRO_REP_US) calls *= 2;
+
+  unsigned long minUs = 0xFFFFFFFFUL, totalUs = 0;
+  for (int r = 0; r < MICRO_REPS; r++) {
+    unsigned long us = microRep(c, calls);
+    if (us < minUs) minUs = us;
+    totalUs += us;
+  }
+  unsigned long nsMin  = (unsigned long)((unsigned long long)minUs * 1000ULL / calls);
+  unsigned long nsMean = (unsigned long)((unsigned long long)totalUs * 1000ULL / (calls * MICRO_REPS));
+
+  benchPrintf("%s{\"kernel\":\"%s\",\"n\":%ld,\"calls\":%lu,\"reps\":%d,\"ns_min\":%lu,\"ns_mean\":%lu",
+              idx > 0 ? "," : "", MICRO_KERNEL_NAMES[c.kernel], c.n, calls, MICRO_REPS, nsMin, nsMean);
+
+  uint32_t record[2] = { (uint32_t)c.n, (uint32_t)nsMin };
+  uint32_t base[2];
+  if (microSaving) {
+    kvPut(KV_KEY(KV_NS_BENCH, idx), record, sizeof(record));
+    benchWrite(",\"status\":\"saved\"}\n");
+  } else if (kvGet(KV_KEY(KV_NS_BENCH, idx), base, sizeof(base)) && base[0] == (uint32_t)c.n && base[1] > 0) {
+    long delta = (long)(((long long)nsMin - (long long)base[1]) * 100 / (long long)base[1]);
+    bool slower = delta > microThreshold;
+    if (slower) microRegressions++;
+    benchPrintf(",\"baseline_ns\":%lu,\"delta_pct\":%ld,\"status\":\"%s\"}\n",
+                (unsigned long)base[1], delta, slower ? "regression" : "ok");
+  } else {
+    benchWrite(",\"status\":\"new\"}\n");
+  }
+}
+
+static void microTaskRun(unsigned long now) {
+  microRunCase(microNext++);
+  if (microNext < MICRO_CASE_COUNT) return;
+  benchPrintf("],\"regressions\":%d}\n", microRegressions);
+  taskCancel(microTask);
+  microTask = -1;
+}
+
+// args is the rest of the command line after "micro" (may be NULL).
+static void microCommand(char* args) {
+  char* tok = args ? strtok(args, " \t\r") : NULL;
+  if (tok && strcmp(tok, "stop") == 0) {
+    if (microTask >= 0) benchPrintf("],\"stopped\":true,\"regressions\":%d}\n", microRegressions);
+    taskCancel(microTask);
+    microTask = -1;
+    return;
+  }
+  if (microTask >= 0) { benchWrite("# micro: already running\n"); return; }
+
+  microSaving    = false;
+  microThreshold = MICRO_THRESHOLD_PCT;
+  for (; tok; tok = strtok(NULL, " \t\r")) {
+    if (strcmp(tok, "save") == 0)             microSaving = true;
+    else if (strncmp(tok, "pct=", 4) == 0)    microThreshold = constrain(atoi(tok + 4), 0, 1000);
+    else benchPrintf("# ignoring '%s'\n", tok);
+  }
+
+  randomSeed(1);  // same sort inputs on every run
+  microNext        = 0;
+  microRegressions = 0;
+#ifdef ARDUINO
+  const char* platform = "uno-r4";
+#else
+  const char* platform = "host";
+#endif
+  benchPrintf("{\"suite\":\"micro\",\"platform\":\"%s\",\"threshold_pct\":%d,\"results\":[\n",
+              platform, microThreshold);
+  microTask = taskAdd("micro", microTaskRun, 0, TASK_PRIO_SERIAL, 0, TASK_GROUP_SYSTEM);
+}
+
+#endif
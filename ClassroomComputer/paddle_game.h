@@ -2,6 +2,10 @@
 #define PADDLE_GAME_H
 
 #include <Arduino.h>
+#include "kv_store.h"
+#include "sketch_shared.h"
+#include "program_registry.h"
+#include "anim_timeline.h"
 
 //  Paddle Game states
 enum PaddleGameState {
@@ -14,21 +18,77 @@ enum PaddleGameState {
 };
 
 //  Level speed table (10 levels, each ~20% faster than previous)
-// Delays in ms: level 1 = 350ms, each subsequent level = prev / 1.20
+// Time in ms for the ball to cross one character cell horizontally:
+// level 1 = 350ms, each subsequent level = prev / 1.20
 static const unsigned long LEVEL_DELAYS[10] = {350, 292, 243, 203, 169, 141, 117, 98, 82, 68};
 static const int NUM_LEVELS = 10;
 static const int HITS_PER_LEVEL = 3;   // paddle hits needed to advance one level
 
+//  Pixel playfield
+// The 16x2 display is treated as 80x16 pixels (5x8 per cell).  Column 15 is
+// the paddle, so the ball lives in pixel columns 0-74.  Positions and
+// velocities are Q8.8 fixed point (256 = one pixel).
+static const int  FIELD_W        = 75;   // ball pixel columns (cells 0-14)
+static const int  FIELD_H        = 16;   // pixel rows
+static const int  BALL_SIZE      = 2;    // ball is a 2x2 pixel square
+static const long FX_ONE         = 256;  // 1.0 in Q8.8
+
+//  Fixed-timestep loop
+// Physics advances in SIM_STEP_MS ticks regardless of how often loop() runs;
+// rendering happens at most every RENDER_INTERVAL_MS and only when the ball's
+// pixel position or the paddle changed.  At most MAX_SIM_STEPS ticks are
+// caught up per loop() so a long stall cannot snowball.
+static const unsigned long SIM_STEP_MS        = 10;  // 100 Hz physics
+static const unsigned long RENDER_INTERVAL_MS = 33;  // ~30 fps cap
+static const int           MAX_SIM_STEPS      = 5;
+
+//  CGRAM slots for the ball: it can straddle up to 2x2 cells.  Slots 1-3 hold
+// µ and the menu arrows and must survive; slot 0 is rebuilt by the result
+// screen's celebration, so it is free while playing.  Slot 5 is the paddle.
+static const uint8_t BALL_SLOTS[4] = {4, 6, 7, 0};
+
 //  Game-specific state
 static PaddleGameState gameState = GAME_TITLE;
-static int ballX = 1, ballY = 0;       // Ball position (X: 0-14, Y: 0-1)
-static int ballDX = 1, ballDY = 1;     // Ball velocity (-1 or +1)
+static long ballX = 0, ballY = 0;      // Ball top-left in Q8.8 pixels
+static long ballVX = 0, ballVY = 0;    // Ball velocity in Q8.8 pixels per tick
 static int paddlePos = 0;              // 0=row0, 2=row1 (no middle position)
 static int score = 0;                  // Number of successful paddle hits
 static int finalScore = 0;             // Saved score for display
+static long bestScore = 0;             // High score from the KV store
+static bool newBest = false;           // finalScore beat the stored high score
 static int level = 1;                  // Current difficulty level (1-10)
-static unsigned long ballDelay = 350;  // ms between ball moves (set from LEVEL_DELAYS)
-static unsigned long lastBallMove = 0; // timestamp of last ball movement
+static unsigned long simClock = 0;     // millis() up to which physics has run
+
+//  Paddle input: the row flips when the filtered pot crosses 512 by more
+// than PADDLE_HYSTERESIS, so ADC noise at the midpoint cannot make it flicker.
+static const int PADDLE_HYSTERESIS = 6;
+
+//  Frame-time and input-latency stats (reset each game, reported on Game
+// Over and Serial).  Input latency runs from the first pot sample that puts
+// the paddle in a new row to the moment the redrawn paddle has been sent to
+// the LCD; the previous sample time bounds when the crossing really happened.
+struct PaddleFrameStats {
+  unsigned long firstFrameAt;   // micros() of first rendered frame
+  unsigned long lastFrameAt;    // micros() of most recent rendered frame
+  unsigned long frames;         // rendered frames
+  unsigned long simSteps;       // physics ticks
+  unsigned long maxIntervalUs;  // longest gap between frames
+  double        sumIntervalMs;  // for mean frame time
+  double        sumSqIntervalMs;// for jitter (standard deviation)
+  unsigned long inputEvents;    // paddle row changes
+  unsigned long sumLatencyUs;   // sample → paddle drawn
+  unsigned long maxLatencyUs;
+  unsigned long maxBoundUs;     // previous sample → paddle drawn (upper bound)
+};
+static PaddleFrameStats frameStats;
+
+//  Render cache: what is currently on screen / in the ball CGRAM slots
+static int  drawnCellCount = 0;
+static int  drawnCellX[4], drawnCellY[4];
+static byte drawnGlyph[4][8];
+static int  drawnPaddlePos = -1;
+static unsigned long paddleChangedAt     = 0;  // micros() of sample that moved the paddle
+static unsigned long paddleChangedBound  = 0;  // micros() of the sample before it
 
 //  Forward declarations
 void enterGameState(PaddleGameState next);
@@ -38,6 +98,11 @@ void handlePaddleGame(unsigned long now);
 static void moveBall();
 static void updatePaddleFromPot();
 static void drawGameScreen();
+static void drawPaddle();
+static void tickGameOverSound(unsigned long now);
+static void setBallSpeedForLevel(bool randomizeAngle);
+static void recordFrame(unsigned long us);
+static void reportFrameStats();
 
 //  State handler forward declarations
 static void handleGameTitle(unsigned long now);
@@ -49,40 +114,7 @@ static void handleGameResult(unsigned long now);
 
 //  Implementations
 
-// External references (defined in main sketch)
-extern rgb_lcd lcd;
-extern const byte COL_PINK[3];
-extern const byte COL_GREEN[3];
-extern unsigned long stateEnteredAt;
-extern bool potHasMoved;
-extern int potValue;
-extern byte celebFrame0[8];
-extern byte celebFrame1[8];
-extern byte celebFrame2[8];
-extern byte celebFrame3[8];
-extern byte celebFrame4[8];
-extern byte celebFrame5[8];
-extern byte celebFrame6[8];
-extern byte celebFrame7[8];
-extern const int CELEB_FRAME_COUNT;
-extern int celebFrameIdx;
-extern unsigned long celebTickAt;
-extern const int BUZZER_PIN;
-extern void tickCelebrationSound(unsigned long now);
-extern void enterAppState(int nextState);
-
 // Custom character definitions (created on entry to GAME_PLAYING)
-byte ballChar[8] = {
-  0b00000,
-  0b01110,
-  0b11111,
-  0b11111,
-  0b11111,
-  0b01110,
-  0b00000,
-  0b00000
-};
-
 byte paddleChar[8] = {
   0b11111,
   0b11111,
@@ -98,31 +130,45 @@ void enterGameState(PaddleGameState next) {
   gameState = next;
   stateEnteredAt = millis();
   potHasMoved = false;
+  setUiFrameMs(next == GAME_PLAYING ? 1 : UI_FRAME_MS);
 
   if (next == GAME_PLAYING) {
-    lcd.setRGB(COL_PINK[0], COL_PINK[1], COL_PINK[2]);
+    setBacklight(COL_PINK);
     // Seed RNG from timing jitter so each game plays differently
     randomSeed(micros());
     // Reset game state
-    ballX = 1;
-    ballY = random(0, 2);           // random starting row
-    ballDX = 1;
-    ballDY = (random(0, 2) == 0) ? 1 : -1;  // random starting vertical direction
+    ballX = 5 * FX_ONE;
+    ballY = random(0, FIELD_H - BALL_SIZE + 1) * FX_ONE;  // random starting height
     paddlePos = 0;
     score = 0;
     level = 1;
-    ballDelay = LEVEL_DELAYS[0];
-    lastBallMove = millis();
-    // Define custom characters for ball and paddle
-    lcd.createChar(4, ballChar);
+    setBallSpeedForLevel(true);
+    if (random(0, 2) == 0) ballVY = -ballVY;  // random starting vertical direction
+    simClock = millis();
+    memset(&frameStats, 0, sizeof(frameStats));
+    drawnCellCount = 0;   // screen is cleared below; force a full redraw
+    drawnPaddlePos = -1;
+    paddleChangedAt = 0;
+    // Ball glyphs are generated per frame; only the paddle is static
     lcd.createChar(5, paddleChar);
   } else if (next == GAME_RESULT) {
-    lcd.setRGB(COL_GREEN[0], COL_GREEN[1], COL_GREEN[2]);
+    setBacklight(COL_GREEN);
   } else {
-    lcd.setRGB(COL_PINK[0], COL_PINK[1], COL_PINK[2]);
+    setBacklight(COL_PINK);
   }
 
+  if (next == GAME_TITLE) bestScore = kvBestScore(KV_SCORE_PADDLE);
+
   lcd.clear();
+
+  if (next == GAME_RESULT) {
+    if (finalScore >= 5) {
+      animPlay(&CELEB_GLYPH_CLIP, 11, 0);   // after "Great job! "
+      animPlay(&CELEB_GLOW_CLIP);
+    }
+    char hits[12];
+    if (newBest) animPlay(&BLINK_CLIP, snprintf(hits, sizeof(hits), "Hits: %d  ", finalScore), 1, "Best!");
+  }
 }
 
 void handlePaddleGame(unsigned long now) {
@@ -138,54 +184,64 @@ void handlePaddleGame(unsigned long now) {
 
 //  Game helper implementations
 
+// Sets |ballVX| from the level table and picks a vertical speed between
+// 0.5x and 1.6x of it.  LEVEL_DELAYS is ms per 5-pixel cell, so the
+// horizontal speed is 5 * SIM_STEP_MS / delay pixels per tick.
+static void setBallSpeedForLevel(bool randomizeAngle) {
+  long vx = (5L * SIM_STEP_MS * FX_ONE) / (long)LEVEL_DELAYS[level - 1];
+  ballVX = (ballVX < 0) ? -vx : vx;
+  if (randomizeAngle || ballVY == 0) {
+    long vy = vx * random(8, 26) / 16;
+    ballVY = (ballVY < 0) ? -vy : vy;
+  }
+}
+
+// Advances the ball by one physics tick.
 static void moveBall() {
-  // Calculate new position
-  int newX = ballX + ballDX;
-  int newY = ballY + ballDY;
+  long newX = ballX + ballVX;
+  long newY = ballY + ballVY;
+  const long maxY = (long)(FIELD_H - BALL_SIZE) * FX_ONE;
 
-  // Bounce off top/bottom walls
+  // Bounce off top/bottom walls (reflect the overshoot)
   if (newY < 0) {
-    ballDY = 1;
-    newY = 0;
+    newY = -newY;
+    ballVY = -ballVY;
     tone(BUZZER_PIN, 300, 50);
-  } else if (newY > 1) {
-    ballDY = -1;
-    newY = 1;
+  } else if (newY > maxY) {
+    newY = 2 * maxY - newY;
+    ballVY = -ballVY;
     tone(BUZZER_PIN, 300, 50);
   }
 
-  // Bounce off left wall — randomize vertical direction to break predictable pattern
+  // Bounce off left wall — randomize the angle to break predictable patterns
   if (newX < 0) {
-    ballDX = 1;
-    newX = 0;
-    // 50% chance to keep current Y direction, 50% chance to flip it
-    if (random(0, 2) == 0) {
-      ballDY = -ballDY;
-    }
-    // Clamp: if random flip would send ball out of bounds, correct it
-    if (newY <= 0) ballDY = 1;
-    if (newY >= 1) ballDY = -1;
+    newX = -newX;
+    ballVX = -ballVX;
+    // 50% chance to flip vertical direction as well
+    if (random(0, 2) == 0) ballVY = -ballVY;
+    setBallSpeedForLevel(true);
     tone(BUZZER_PIN, 300, 50);
   }
 
-  // Check right edge (paddle at column 15)
-  if (newX >= 15) {
-    // Check against ballY (the row the player last saw) rather than newY.
-    // The ball moves diagonally, so newY may differ from ballY; using newY would
-    // cause the paddle to miss even when visually aligned with the ball's approach.
-    bool paddleHit = false;
-    if (paddlePos == 0 && ballY == 0) paddleHit = true;
-    if (paddlePos == 2 && ballY == 1) paddleHit = true;
+  // Check right edge (paddle face at pixel column FIELD_W)
+  const long faceX = (long)(FIELD_W - BALL_SIZE) * FX_ONE;
+  if (newX >= faceX) {
+    // The paddle covers pixel rows 0-7 (upper) or 8-15 (lower); any overlap
+    // with the ball counts, matching what the player sees.
+    int top    = (int)(ballY >> 8);
+    int bottom = top + BALL_SIZE - 1;
+    int padTop = (paddlePos == 0) ? 0 : 8;
+    bool paddleHit = (bottom >= padTop && top <= padTop + 7);
 
     if (paddleHit) {
-      ballDX = -1;
-      newX = 14;  // keep ball at column 14
+      newX = 2 * faceX - newX;
+      ballVX = -ballVX;
       score++;
       tone(BUZZER_PIN, 600, 80);
 
       // 40% chance to randomize Y direction on paddle hit for extra unpredictability
       if (random(0, 5) < 2) {
-        ballDY = -ballDY;
+        ballVY = -ballVY;
       }
 
       // Advance level every HITS_PER_LEVEL hits (up to NUM_LEVELS)
@@ -193,16 +249,13 @@ static void moveBall() {
       if (newLevel > NUM_LEVELS) newLevel = NUM_LEVELS;
       if (newLevel != level) {
         level = newLevel;
-        ballDelay = LEVEL_DELAYS[level - 1];
+        setBallSpeedForLevel(false);
       }
     } else {
-      // Miss! Play game-over sound and transition
-      tone(BUZZER_PIN, 400, 200);
-      delay(220);
-      tone(BUZZER_PIN, 300, 200);
-      delay(220);
-      tone(BUZZER_PIN, 200, 300);
+      // Miss! The game-over sound plays from GAME_OVER without blocking
       finalScore = score;
+      newBest    = kvRecordScore(KV_SCORE_PADDLE, finalScore);
+      reportFrameStats();
       enterGameState(GAME_OVER);
       return;
     }
@@ -212,53 +265,183 @@ static void moveBall() {
   ballY = newY;
 }
 
+// Samples the pot afresh and maps the filtered value to a paddle row, so the
+// paddle follows the newest reading rather than the one taken at the top of
+// loop().  Row changes are time-stamped for the latency stats.
 static void updatePaddleFromPot() {
-  // Map pot to paddle position (no debounce - immediate response needed)
+  samplePot(millis());
+
   // Only two positions: commit to upper or lower row
-  if (potValue < 512) {
-    paddlePos = 0;  // row 0 only (upper)
-  } else {
-    paddlePos = 2;  // row 1 only (lower)
+  int next = paddlePos;
+  if (paddlePos == 0 && potFiltered >= 512 + PADDLE_HYSTERESIS) next = 2;  // row 1 (lower)
+  if (paddlePos == 2 && potFiltered <  512 - PADDLE_HYSTERESIS) next = 0;  // row 0 (upper)
+
+  if (next != paddlePos) {
+    paddlePos          = next;
+    paddleChangedAt    = potSampledAt;
+    paddleChangedBound = potPrevSampledAt;
   }
 }
 
+// Renders the ball at pixel resolution by generating one custom character
+// per cell it overlaps (up to 4).  Glyphs are only re-uploaded when their
+// bitmap changed, and cells the ball left are blanked.
 static void drawGameScreen() {
-  static int prevBallX = -1, prevBallY = -1;
-  static int prevPaddlePos = -1;
+  if (gameState != GAME_PLAYING) return;  // moveBall() may have ended the game
+
+  int px = (int)(ballX >> 8);
+  int py = (int)(ballY >> 8);
+
+  // Build glyphs for every cell the ball touches
+  int  cellCount = 0;
+  int  cellX[4], cellY[4];
+  byte glyph[4][8];
+  for (int cy = py / 8; cy <= (py + BALL_SIZE - 1) / 8; cy++) {
+    for (int cx = px / 5; cx <= (px + BALL_SIZE - 1) / 5; cx++) {
+      byte* g = glyph[cellCount];
+      memset(g, 0, 8);
+      for (int y = py; y < py + BALL_SIZE; y++) {
+        if (y / 8 != cy) continue;
+        for (int x = px; x < px + BALL_SIZE; x++) {
+          if (x / 5 != cx) continue;
+          g[y - cy * 8] |= (byte)(0x10 >> (x - cx * 5));
+        }
+      }
+      cellX[cellCount] = cx;
+      cellY[cellCount] = cy;
+      cellCount++;
+    }
+  }
 
-  // Clear previous ball position
-  if (prevBallX >= 0 && (prevBallX != ballX || prevBallY != ballY)) {
-    lcd.setCursor(prevBallX, prevBallY);
-    lcd.print(" ");
+  // Blank cells the ball has left
+  for (int i = 0; i < drawnCellCount; i++) {
+    bool stillUsed = false;
+    for (int j = 0; j < cellCount; j++) {
+      if (cellX[j] == drawnCellX[i] && cellY[j] == drawnCellY[i]) stillUsed = true;
+    }
+    if (!stillUsed) {
+      lcd.setCursor(drawnCellX[i], drawnCellY[i]);
+      lcd.print(" ");
+    }
   }
 
-  // Draw ball
-  lcd.setCursor(ballX, ballY);
-  lcd.write((uint8_t)4);
+  // Upload changed glyphs, then place them (createChar moves the cursor)
+  bool moved = (cellCount != drawnCellCount);
+  for (int i = 0; i < cellCount; i++) {
+    if (i >= drawnCellCount || memcmp(glyph[i], drawnGlyph[i], 8) != 0) {
+      lcd.createChar(BALL_SLOTS[i], glyph[i]);
+      memcpy(drawnGlyph[i], glyph[i], 8);
+      moved = true;
+    }
+    if (i >= drawnCellCount || cellX[i] != drawnCellX[i] || cellY[i] != drawnCellY[i]) moved = true;
+  }
+  if (moved) {
+    for (int i = 0; i < cellCount; i++) {
+      lcd.setCursor(cellX[i], cellY[i]);
+      lcd.write(BALL_SLOTS[i]);
+      drawnCellX[i] = cellX[i];
+      drawnCellY[i] = cellY[i];
+    }
+    drawnCellCount = cellCount;
+  }
+}
+
+// Redraws the paddle if its row changed and records input-to-display latency.
+// Called every loop(), independent of the ball's render rate.
+static void drawPaddle() {
+  if (drawnPaddlePos == paddlePos) return;
+
+  // Clear old paddle
+  lcd.setCursor(15, 0);
+  lcd.print(" ");
+  lcd.setCursor(15, 1);
+  lcd.print(" ");
 
-  // Update paddle if position changed
-  if (prevPaddlePos != paddlePos) {
-    // Clear old paddle
+  // Draw new paddle
+  if (paddlePos == 0) {
     lcd.setCursor(15, 0);
-    lcd.print(" ");
+    lcd.write((uint8_t)5);
+  }
+  if (paddlePos == 2) {
     lcd.setCursor(15, 1);
-    lcd.print(" ");
+    lcd.write((uint8_t)5);
+  }
 
-    // Draw new paddle
-    if (paddlePos == 0) {
-      lcd.setCursor(15, 0);
-      lcd.write((uint8_t)5);
-    }
-    if (paddlePos == 2) {
-      lcd.setCursor(15, 1);
-      lcd.write((uint8_t)5);
-    }
+  // The first draw of a game is not a response to input
+  if (drawnPaddlePos >= 0 && paddleChangedAt != 0) {
+    unsigned long drawnAt = micros();
+    unsigned long latency = drawnAt - paddleChangedAt;
+    unsigned long bound   = drawnAt - paddleChangedBound;
+    frameStats.inputEvents++;
+    frameStats.sumLatencyUs += latency;
+    if (latency > frameStats.maxLatencyUs) frameStats.maxLatencyUs = latency;
+    if (bound   > frameStats.maxBoundUs)   frameStats.maxBoundUs   = bound;
+  }
+  drawnPaddlePos = paddlePos;
+}
 
-    prevPaddlePos = paddlePos;
+// Accumulates frame-interval statistics for the fps / jitter report.
+static void recordFrame(unsigned long us) {
+  if (frameStats.frames == 0) {
+    frameStats.firstFrameAt = us;
+  } else {
+    unsigned long interval = us - frameStats.lastFrameAt;
+    double ms = interval / 1000.0;
+    frameStats.sumIntervalMs   += ms;
+    frameStats.sumSqIntervalMs += ms * ms;
+    if (interval > frameStats.maxIntervalUs) frameStats.maxIntervalUs = interval;
   }
+  frameStats.lastFrameAt = us;
+  frameStats.frames++;
+}
 
-  prevBallX = ballX;
-  prevBallY = ballY;
+static double frameStatsMeanLatencyMs() {
+  return frameStats.inputEvents ? frameStats.sumLatencyUs / 1000.0 / frameStats.inputEvents : 0.0;
+}
+
+static double frameStatsFps() {
+  if (frameStats.frames < 2) return 0.0;
+  unsigned long span = frameStats.lastFrameAt - frameStats.firstFrameAt;
+  return span ? (frameStats.frames - 1) * 1000000.0 / span : 0.0;
+}
+
+// Prints achieved fps and frame-time jitter (std. deviation of the interval
+// between rendered frames) over Serial.
+static void reportFrameStats() {
+  unsigned long n = (frameStats.frames > 1) ? frameStats.frames - 1 : 0;
+  double mean = n ? frameStats.sumIntervalMs / n : 0.0;
+  double var  = n ? frameStats.sumSqIntervalMs / n - mean * mean : 0.0;
+  Serial.print("paddle: fps=");
+  Serial.print(frameStatsFps(), 1);
+  Serial.print(" frame_ms=");
+  Serial.print(mean, 2);
+  Serial.print(" jitter_ms=");
+  Serial.print(var > 0.0 ? sqrt(var) : 0.0, 2);
+  Serial.print(" max_ms=");
+  Serial.print(frameStats.maxIntervalUs / 1000.0, 2);
+  Serial.print(" sim_steps=");
+  Serial.print(frameStats.simSteps);
+  Serial.print(" input_events=");
+  Serial.print(frameStats.inputEvents);
+  Serial.print(" input_latency_ms=");
+  Serial.print(frameStatsMeanLatencyMs(), 2);
+  Serial.print(" max=");
+  Serial.print(frameStats.maxLatencyUs / 1000.0, 2);
+  Serial.print(" bound=");
+  Serial.println(frameStats.maxBoundUs / 1000.0, 2);
+}
+
+// Non-blocking game-over sound: 400 → 300 → 200 Hz, same spacing as the old
+// tone()+delay() sequence but driven from GAME_OVER so loop() never stalls.
+static void tickGameOverSound(unsigned long now) {
+  static unsigned long lastStateStart = 0;
+  static int noteIdx = -1;
+  if (lastStateStart != stateEnteredAt) { lastStateStart = stateEnteredAt; noteIdx = -1; }
+
+  unsigned long e = now - stateEnteredAt;
+  if      (noteIdx < 0)                 { tone(BUZZER_PIN, 400, 200); noteIdx = 0; }
+  else if (noteIdx == 0 && e >= 220UL) { tone(BUZZER_PIN, 300, 200); noteIdx = 1; }
+  else if (noteIdx == 1 && e >= 440UL) { tone(BUZZER_PIN, 200, 300); noteIdx = 2; }
 }
 
 //  State handlers
@@ -266,6 +449,11 @@ static void drawGameScreen() {
 static void handleGameTitle(unsigned long now) {
   lcd.setCursor(0, 0);
   lcd.print("Paddle Ball");
+  if (bestScore > 0) {
+    lcd.setCursor(0, 1);
+    lcd.print("Best: ");
+    lcd.print(bestScore);
+  }
 
   if (now - stateEnteredAt >= 1500UL) {
     enterGameState(GAME_INSTRUCTIONS);
@@ -301,36 +489,64 @@ static void handleGameReady(unsigned long now) {
 }
 
 static void handleGamePlaying(unsigned long now) {
-  // Update paddle position from pot (immediate response)
-  updatePaddleFromPot();
-
-  // Move ball at fixed intervals
-  if (now - lastBallMove >= ballDelay) {
+  static unsigned long lastRenderAt = 0;
+
+  // Run every physics tick that is due, dropping time beyond MAX_SIM_STEPS.
+  // The paddle is re-read before each tick so a hit test never uses a stale row.
+  int steps = 0;
+  while (now - simClock >= SIM_STEP_MS && gameState == GAME_PLAYING) {
+    if (steps == MAX_SIM_STEPS) { simClock = now; break; }
+    updatePaddleFromPot();
     moveBall();
-    lastBallMove = now;
+    simClock += SIM_STEP_MS;
+    frameStats.simSteps++;
+    steps++;
   }
+  if (gameState != GAME_PLAYING) return;
+
+  // Paddle responds on every loop() from the freshest sample
+  updatePaddleFromPot();
+  drawPaddle();
 
-  // Render game screen
-  drawGameScreen();
+  // Render at a capped rate, decoupled from the physics tick
+  if (frameStats.frames == 0 || now - lastRenderAt >= RENDER_INTERVAL_MS) {
+    lastRenderAt = now;
+    drawGameScreen();
+    recordFrame(micros());
+  }
 }
 
 static void handleGameOver(unsigned long now) {
   lcd.setCursor(0, 0);
   lcd.print("Game Over!");
+  // Achieved frame rate in the spare columns, e.g. "Game Over! 31fps"
+  int fps = (int)(frameStatsFps() + 0.5);
+  lcd.setCursor(fps >= 100 ? 10 : (fps >= 10 ? 11 : 12), 0);
+  lcd.print(fps);
+  lcd.print("fps");
+  // "Score: 7 lag12ms" – mean input-to-display latency when it fits
+  char bottom[24];
+  int lagMs = (int)(frameStatsMeanLatencyMs() + 0.5);
+  snprintf(bottom, sizeof(bottom), "Score: %d lag%dms", finalScore, lagMs);
+  if (frameStats.inputEvents == 0 || strlen(bottom) > 16) {
+    snprintf(bottom, sizeof(bottom), "Score: %d", finalScore);
+  }
   lcd.setCursor(0, 1);
-  lcd.print("Score: ");
-  lcd.print(finalScore);
+  lcd.print(bottom);
   lcd.print("     ");  // clear leftover digits
 
+  tickGameOverSound(now);
+
   if (now - stateEnteredAt >= 3000UL) {
     enterGameState(GAME_RESULT);
   }
 }
 
 static void handleGameResult(unsigned long now) {
-  if (celebTickAt < stateEnteredAt) {
-    celebFrameIdx = 0;
-    lcd.createChar(0, celebFrame0);
+  // Static text once; the celebration and "Best!" are played by enterGameState
+  static unsigned long drawnFor = 0;   // stateEnteredAt of the last draw
+  if (drawnFor != stateEnteredAt) {
+    drawnFor = stateEnteredAt;
     lcd.setCursor(0, 0);
     if (finalScore < 5) {
       lcd.print("Oh well :/      ");
@@ -340,22 +556,6 @@ static void handleGameResult(unsigned long now) {
     lcd.setCursor(0, 1);
     lcd.print("Hits: ");
     lcd.print(finalScore);
-    lcd.print("   ");  // clear leftover
-    celebTickAt = stateEnteredAt + 200UL;
-  }
-
-  if (finalScore >= 5) {
-    // Advance animation frame
-    if (now >= celebTickAt) {
-      celebFrameIdx = (celebFrameIdx + 1) % CELEB_FRAME_COUNT;
-      byte* frames[8] = {celebFrame0, celebFrame1, celebFrame2, celebFrame3,
-                          celebFrame4, celebFrame5, celebFrame6, celebFrame7};
-      lcd.createChar(0, frames[celebFrameIdx]);
-      celebTickAt = now + 200UL;
-    }
-    // Draw celebration character after "job! "
-    lcd.setCursor(11, 0);
-    lcd.write((uint8_t)0);
   }
 
   // Celebration sound
@@ -366,4 +566,18 @@ static void handleGameResult(unsigned long now) {
   }
 }
 
+//  Registry entry (see program_registry.h)
+static void paddleEnter() { enterGameState(GAME_TITLE); }
+static void paddleExit()  { noTone(BUZZER_PIN); }
+
+constexpr size_t PADDLE_STATIC_BYTES = sizeof(drawnCellX) + sizeof(drawnCellY) + sizeof(drawnGlyph);
+static_assert(PADDLE_STATIC_BYTES <= UINT16_MAX, "PADDLE_STATIC_BYTES does not fit ProgramInfo::staticBytes");
+
+constexpr ProgramInfo PADDLE_PROGRAM = {
+  "Game", paddleEnter, handlePaddleGame, paddleExit,
+  PADDLE_STATIC_BYTES,
+  CGRAM_CELEBRATION | CGRAM_SLOT(4) | CGRAM_SLOT(5) | CGRAM_SLOT(6) | CGRAM_SLOT(7),
+  NULL
+};
+
 #endif
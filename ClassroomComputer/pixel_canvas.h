@@ -0,0 +1,279 @@
+#ifndef PIXEL_CANVAS_H
+#define PIXEL_CANVAS_H
+
+#include <Arduino.h>
+#include "counting_lcd.h"
+
+//  Virtual 80x16 pixel canvas
+// Programs draw into a 1-bit bitmap covering the whole display (16x2 cells
+// of 5x8 pixels) and call canvasCompose() once per frame.  The compositor
+// cuts the bitmap into 32 tiles, maps blank tiles to ' ' and solid tiles to
+// the ROM block (0xFF), deduplicates the rest and packs them into the CGRAM
+// slots the program allows.  Only slots whose bitmap changed are uploaded
+// and only cells whose character changed are written, within a per-frame
+// I2C byte budget counted like CountingLcd (counting_lcd.h); uploads and
+// writes over budget are carried to the next frame.
+// An LCD row marked in canvasTextRows is skipped, so a program can print a
+// status line over half of the picture and give it back with
+// canvasReleaseRow().
+//
+// Rows are stored MSB-first in 32-bit words (pixel x = 0 is bit 31 of word
+// 0), so blits, fills and tile cuts are word-wide shifts and masks.
+
+#define CANVAS_W     80
+#define CANVAS_H     16
+#define CANVAS_WORDS 3     // 96 bits per row, 80 used
+#define CANVAS_COLS  16
+#define CANVAS_ROWS  2
+#define CANVAS_CELLS (CANVAS_COLS * CANVAS_ROWS)
+
+static uint32_t canvasRows[CANVAS_H][CANVAS_WORDS];
+
+extern CountingLcd lcd;
+
+//  Per-frame results of canvasCompose()
+struct CanvasStats {
+  uint8_t       uniqueTiles;     // distinct non-blank, non-solid tiles this frame
+  uint8_t       overflowTiles;   // tiles that did not get a slot of their own
+  uint8_t       glyphUploads;    // createChar() calls this frame
+  uint8_t       cellWrites;      // characters written this frame
+  uint8_t       deferredCells;   // changed cells left for the next frame (budget or upload)
+  uint16_t      i2cBytes;        // bytes on the bus this frame
+  unsigned long frames;          // frames composed since canvasReset()
+  unsigned long overflowFrames;  // frames that needed more than the free slots
+};
+static CanvasStats canvasStats;
+
+//  Configuration (set by the program before its first frame)
+static uint8_t  canvasSlotMask   = 0xF1;  // slots 0, 4-7; 1-3 hold µ and arrows
+static uint16_t canvasByteBudget = 320;   // ≈ 26 ms at 100 kHz
+static uint8_t  canvasTextRows   = 0;     // bit r set = LCD row r shows text; left alone
+
+//  What the LCD currently shows, so each frame only sends the difference
+static uint8_t  canvasShown[CANVAS_ROWS][CANVAS_COLS];
+static uint64_t canvasSlotTile[8];
+static uint8_t  canvasSlotLoaded = 0;     // bit s set = slot s content known
+
+//  Drawing
+
+static void canvasClear() {
+  memset(canvasRows, 0, sizeof(canvasRows));
+}
+
+static void canvasSetPixel(int x, int y, bool on) {
+  if (x < 0 || x >= CANVAS_W || y < 0 || y >= CANVAS_H) return;
+  uint32_t bit = 0x80000000UL >> (x & 31);
+  if (on) canvasRows[y][x >> 5] |=  bit;
+  else    canvasRows[y][x >> 5] &= ~bit;
+}
+
+// ORs (or XORs) a sprite into the canvas.  Each sprite row is up to 32
+// pixels, left-aligned (pixel 0 = bit 31).  One row costs at most two
+// shifted word operations regardless of the sprite width.
+static void canvasBlit(const uint32_t* rows, int h, int x, int y, bool xorMode = false) {
+  for (int r = 0; r < h; r++) {
+    int yy = y + r;
+    if (yy < 0 || yy >= CANVAS_H || rows[r] == 0) continue;
+    uint32_t bits = rows[r];
+    int xx = x;
+    if (xx < 0) {                      // clip on the left
+      if (xx <= -32) continue;
+      bits <<= -xx;
+      xx = 0;
+    }
+    if (xx >= CANVAS_W) continue;
+    int w   = xx >> 5;
+    int off = xx & 31;
+    uint32_t lo = bits >> off;
+    uint32_t hi = off ? bits << (32 - off) : 0;
+    if (xorMode) {
+      canvasRows[yy][w] ^= lo;
+      if (w + 1 < CANVAS_WORDS) canvasRows[yy][w + 1] ^= hi;
+    } else {
+      canvasRows[yy][w] |= lo;
+      if (w + 1 < CANVAS_WORDS) canvasRows[yy][w + 1] |= hi;
+    }
+    canvasRows[yy][CANVAS_WORDS - 1] &= 0xFFFF0000UL;  // pixels 80-95 don't exist
+  }
+}
+
+// Sets or clears a rectangle using whole-word masks.
+static void canvasFillRect(int x, int y, int w, int h, bool on) {
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > CANVAS_W) w = CANVAS_W - x;
+  if (y + h > CANVAS_H) h = CANVAS_H - y;
+  if (w <= 0 || h <= 0) return;
+  for (int word = 0; word < CANVAS_WORDS; word++) {
+    int start = word * 32, end = start + 32;
+    int a = (x > start) ? x : start;
+    int b = (x + w < end) ? x + w : end;
+    if (a >= b) continue;
+    uint32_t mask = 0xFFFFFFFFUL >> (a - start);
+    if (b - start < 32) mask &= ~(0xFFFFFFFFUL >> (b - start));
+    for (int r = y; r < y + h; r++) {
+      if (on) canvasRows[r][word] |= mask;
+      else    canvasRows[r][word] &= ~mask;
+    }
+  }
+}
+
+//  Compositing
+
+// Five pixels of row y starting at pixel x, as a glyph row (bit 4 = left).
+static uint8_t canvasBits5(int y, int x) {
+  int w = x >> 5, off = x & 31;
+  uint64_t pair = ((uint64_t)canvasRows[y][w] << 32) |
+                  ((w + 1 < CANVAS_WORDS) ? canvasRows[y][w + 1] : 0);
+  return (uint8_t)((pair >> (64 - 5 - off)) & 0x1F);
+}
+
+// Packs the 8x5 tile of a cell into 40 bits (row 0 in the top bits).
+static uint64_t canvasTileKey(int cx, int cy) {
+  uint64_t key = 0;
+  for (int r = 0; r < 8; r++) key = (key << 5) | canvasBits5(cy * 8 + r, cx * 5);
+  return key;
+}
+
+static void canvasKeyToGlyph(uint64_t key, byte* glyph) {
+  for (int r = 7; r >= 0; r--) { glyph[r] = (byte)(key & 0x1F); key >>= 5; }
+}
+
+static int canvasHamming(uint64_t a, uint64_t b) {
+  uint64_t x = a ^ b;
+  int n = 0;
+  while (x) { x &= x - 1; n++; }
+  return n;
+}
+
+// Forgets what is on the LCD; call after lcd.clear() or when another screen
+// has used the CGRAM slots.
+static void canvasReset() {
+  memset(canvasShown, ' ', sizeof(canvasShown));
+  canvasSlotLoaded = 0;
+  canvasTextRows   = 0;
+  memset(&canvasStats, 0, sizeof(canvasStats));
+}
+
+// Hands an LCD row back to the canvas after the program printed text on it;
+// the next frame redraws every cell of the row.
+static void canvasReleaseRow(uint8_t row) {
+  canvasTextRows &= (uint8_t)~(1 << row);
+  memset(canvasShown[row], 0xFE, CANVAS_COLS);  // matches no character code
+}
+
+// Maps the canvas to characters and sends the minimal update to the LCD.
+// Returns the number of distinct custom tiles the frame needed; more than
+// the free slots means some tiles were drawn with their nearest neighbour
+// (reported in canvasStats.overflowTiles / overflowFrames).
+static int canvasCompose() {
+  const uint64_t FULL = 0xFFFFFFFFFFULL;   // 40 set bits
+
+  uint64_t tiles[CANVAS_CELLS];
+  uint8_t  tileCount = 0;
+  uint8_t  cellTile[CANVAS_CELLS];           // index into tiles[], 0xFE blank, 0xFF solid
+
+  for (int c = 0; c < CANVAS_CELLS; c++) {
+    if (canvasTextRows & (1 << (c / CANVAS_COLS))) { cellTile[c] = 0xFE; continue; }
+    uint64_t key = canvasTileKey(c % CANVAS_COLS, c / CANVAS_COLS);
+    if (key == 0)    { cellTile[c] = 0xFE; continue; }
+    if (key == FULL) { cellTile[c] = 0xFF; continue; }
+    int t = 0;
+    while (t < tileCount && tiles[t] != key) t++;
+    if (t == tileCount) tiles[tileCount++] = key;
+    cellTile[c] = (uint8_t)t;
+  }
+
+  // Slot assignment: keep tiles that are already loaded, then fill free slots
+  int8_t tileSlot[CANVAS_CELLS];
+  uint8_t used = 0;
+  for (int t = 0; t < tileCount; t++) {
+    tileSlot[t] = -1;
+    for (int s = 0; s < 8; s++) {
+      if ((canvasSlotMask & (1 << s)) && (canvasSlotLoaded & (1 << s)) &&
+          !(used & (1 << s)) && canvasSlotTile[s] == tiles[t]) {
+        tileSlot[t] = (int8_t)s;
+        used |= (uint8_t)(1 << s);
+        break;
+      }
+    }
+  }
+
+  // Uploads over the byte budget wait for the next frame (0x7E); their
+  // cells keep what they show until then
+  uint16_t bytes = 0;
+  uint8_t  uploads = 0, overflow = 0;
+  for (int t = 0; t < tileCount; t++) {
+    if (tileSlot[t] >= 0) continue;
+    int s = 0;
+    while (s < 8 && (!(canvasSlotMask & (1 << s)) || (used & (1 << s)))) s++;
+    if (s < 8 && bytes + LCD_I2C_CREATECHAR > canvasByteBudget) {
+      tileSlot[t] = 0x7E;
+    } else if (s < 8) {
+      byte glyph[8];
+      canvasKeyToGlyph(tiles[t], glyph);
+      lcd.createChar((uint8_t)s, glyph);
+      canvasSlotTile[s] = tiles[t];
+      canvasSlotLoaded |= (uint8_t)(1 << s);
+      used |= (uint8_t)(1 << s);
+      tileSlot[t] = (int8_t)s;
+      uploads++;
+      bytes += LCD_I2C_CREATECHAR;
+    } else {
+      overflow++;
+    }
+  }
+
+  // Tiles without a slot borrow the closest assigned tile
+  for (int t = 0; t < tileCount && overflow; t++) {
+    if (tileSlot[t] >= 0) continue;
+    int best = -1, bestDist = 41;
+    for (int u = 0; u < tileCount; u++) {
+      if (u == t || tileSlot[u] < 0 || (tileSlot[u] & 0x40)) continue;
+      int d = canvasHamming(tiles[t], tiles[u]);
+      if (d < bestDist) { bestDist = d; best = u; }
+    }
+    // 0x40 marks a borrowed slot so borrowing never chains; 0x7F means the
+    // program left no slots at all
+    tileSlot[t] = (best >= 0) ? (int8_t)(tileSlot[best] | 0x40) : (int8_t)0x7F;
+  }
+
+  // Cell writes, in runs, until the byte budget is spent
+  uint8_t writes = 0, deferred = 0;
+  for (int row = 0; row < CANVAS_ROWS; row++) {
+    if (canvasTextRows & (1 << row)) continue;
+    int col = 0;
+    bool cursorValid = false;
+    while (col < CANVAS_COLS) {
+      int c = row * CANVAS_COLS + col;
+      uint8_t code;
+      if      (cellTile[c] == 0xFE) code = ' ';
+      else if (cellTile[c] == 0xFF) code = 0xFF;
+      else if (tileSlot[cellTile[c]] == 0x7E) { deferred++; col++; cursorValid = false; continue; }
+      else if (tileSlot[cellTile[c]] == 0x7F) code = '#';   // nothing to borrow
+      else    code = (uint8_t)(tileSlot[cellTile[c]] & 0x07);
+
+      if (code == canvasShown[row][col]) { col++; cursorValid = false; continue; }
+      uint16_t cost = LCD_I2C_COMMAND + (cursorValid ? 0 : LCD_I2C_COMMAND);   // write, setCursor
+      if (bytes + cost > canvasByteBudget) { deferred++; col++; cursorValid = false; continue; }
+      if (!cursorValid) { lcd.setCursor(col, row); cursorValid = true; }
+      lcd.write(code);
+      canvasShown[row][col] = code;
+      bytes += cost;
+      writes++;
+      col++;
+    }
+  }
+
+  canvasStats.uniqueTiles   = tileCount;
+  canvasStats.overflowTiles = overflow;
+  canvasStats.glyphUploads  = uploads;
+  canvasStats.cellWrites    = writes;
+  canvasStats.deferredCells = deferred;
+  canvasStats.i2cBytes      = bytes;
+  canvasStats.frames++;
+  if (overflow) canvasStats.overflowFrames++;
+  return tileCount;
+}
+
+#endif
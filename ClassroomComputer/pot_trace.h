@@ -0,0 +1,222 @@
+#ifndef POT_TRACE_H
+#define POT_TRACE_H
+
+#include <Arduino.h>
+#include "sketch_shared.h"
+
+//  Slider trace recording and replay
+// "trace rec" restarts the menu and logs every slider change as
+// (ms since the previous change, change in ADC value), each a LEB128
+// varint with the value change zigzag-encoded, so a slow drag costs about two
+// bytes per event.  "trace play" restarts the menu and feeds the same values
+// back through samplePot() at the same offsets, so two builds can be driven
+// through an identical session and their loop timings compared.
+// Changes below TRACE_MIN_DELTA are not recorded, so a replay reproduces the
+// recorded session to within ADC noise and every replay of a trace is exact.
+//
+// "trace dump" prints the trace as "trace load <hex>" lines that can be sent
+// back verbatim (after "trace clear") to reload it on another build.  Both
+// sessions end with a one-line report of loop count, loop latency and the
+// I2C bytes sent to the LCD (counting_lcd.h).
+
+#define TRACE_BYTES     1536
+#define TRACE_MIN_DELTA 2      // smaller ADC changes are noise, not movement
+#define TRACE_SEED      1      // random() sequence for recorded/replayed runs
+
+enum TraceMode { TRACE_OFF, TRACE_RECORDING, TRACE_REPLAYING };
+
+static uint8_t       traceBuf[TRACE_BYTES];
+static uint16_t      traceLen     = 0;      // bytes of trace held
+static TraceMode     traceMode    = TRACE_OFF;
+static unsigned long traceStartMs = 0;      // millis() when the session began
+
+//  Recorder / player cursor
+static uint16_t      tracePos       = 0;    // replay read offset
+static int           traceValue     = 0;    // last recorded or replayed value
+static unsigned long traceEventAt   = 0;    // session ms of the last event
+static unsigned long traceNextAt    = 0;    // session ms of the next replay event
+static long          traceNextDelta = 0;
+static bool          traceHaveNext  = false;
+
+//  Session stats
+static unsigned long traceLoops     = 0;
+static unsigned long traceLoopUsSum = 0;
+static unsigned long traceLoopUsMax = 0;
+static unsigned long traceEvents    = 0;
+static uint32_t      traceI2cStart  = 0;   // lcd.i2cBytes when the session began
+
+//  Encoding
+
+static bool tracePutVarint(unsigned long v) {
+  do {
+    if (traceLen >= TRACE_BYTES) return false;
+    uint8_t b = v & 0x7F;
+    v >>= 7;
+    traceBuf[traceLen++] = v ? (b | 0x80) : b;
+  } while (v);
+  return true;
+}
+
+static bool traceGetVarint(unsigned long* v) {
+  *v = 0;
+  for (int shift = 0; tracePos < traceLen && shift < 32; shift += 7) {
+    uint8_t b = traceBuf[tracePos++];
+    *v |= (unsigned long)(b & 0x7F) << shift;
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
+
+static unsigned long traceZigzag(long d)         { return (d < 0) ? ((unsigned long)(-d) << 1) - 1 : (unsigned long)d << 1; }
+static long          traceUnzigzag(unsigned long z) { return (z & 1) ? -(long)((z + 1) >> 1) : (long)(z >> 1); }
+
+// Reads the next (time, delta) event of the replay into traceNextAt/Delta.
+static void traceFetchNext() {
+  unsigned long dt, z;
+  traceHaveNext = traceGetVarint(&dt) && traceGetVarint(&z);
+  if (traceHaveNext) {
+    traceNextAt   = traceEventAt + dt;
+    traceNextDelta = traceUnzigzag(z);
+  }
+}
+
+//  Sessions
+
+static void traceReport(const char* what) {
+  unsigned long ms = millis() - traceStartMs;
+  benchPrintf("# trace %s: events=%lu bytes=%u ms=%lu loops=%lu mean_loop_us=%lu max_loop_us=%lu i2c_bytes=%lu\n",
+              what, traceEvents, traceLen, ms, traceLoops,
+              traceLoops ? traceLoopUsSum / traceLoops : 0UL, traceLoopUsMax,
+              (unsigned long)(lcd.i2cBytes - traceI2cStart));
+}
+
+static void traceBegin(TraceMode mode, int startValue) {
+  traceMode      = mode;
+  traceStartMs   = millis();
+  traceEventAt   = 0;
+  traceValue     = startValue;
+  traceLoops     = 0;
+  traceLoopUsSum = 0;
+  traceLoopUsMax = 0;
+  traceEvents    = 0;
+  traceI2cStart  = lcd.i2cBytes;
+  // Same starting point for every session: menu page 1, same random() stream
+  potValuePrev = startValue;
+  potFiltered  = startValue;
+  randomSeed(TRACE_SEED);
+  enterAppState(1);  // APP_PROGRAM_SELECT
+}
+
+static void traceStartRecording(int raw) {
+  traceLen = 0;
+  tracePutVarint(0);                   // first event: the starting position
+  tracePutVarint(traceZigzag(raw));
+  traceBegin(TRACE_RECORDING, raw);
+}
+
+static void traceStartReplay() {
+  if (traceLen == 0) { benchWrite("# trace: nothing recorded or loaded\n"); return; }
+  tracePos     = 0;
+  traceEventAt = 0;
+  traceFetchNext();                    // the starting position
+  int start = (int)traceNextDelta;
+  traceBegin(TRACE_REPLAYING, start);
+  traceFetchNext();
+}
+
+static void traceStop() {
+  if (traceMode == TRACE_RECORDING) {
+    // Closing no-change event so a replay lasts as long as the recording
+    unsigned long t = millis() - traceStartMs;
+    uint16_t mark = traceLen;
+    if (!tracePutVarint(t - traceEventAt) || !tracePutVarint(0)) traceLen = mark;
+    traceReport("recorded");
+  }
+  if (traceMode == TRACE_REPLAYING) traceReport("replay stopped");
+  traceMode = TRACE_OFF;
+}
+
+//  Input hook – samplePot() passes every ADC reading through here.  Returns
+// the value the sketch should use.
+static int traceInput(int raw, unsigned long now) {
+  if (traceMode == TRACE_OFF) return raw;
+  unsigned long t = now - traceStartMs;
+
+  if (traceMode == TRACE_RECORDING) {
+    if (abs(raw - traceValue) >= TRACE_MIN_DELTA) {
+      uint16_t mark = traceLen;
+      if (!tracePutVarint(t - traceEventAt) || !tracePutVarint(traceZigzag(raw - traceValue))) {
+        traceLen = mark;               // drop the partial event
+        traceReport("full, recorded");
+        traceMode = TRACE_OFF;
+        return raw;
+      }
+      traceEventAt = t;
+      traceValue   = raw;
+      traceEvents++;
+    }
+    return raw;
+  }
+
+  // Replaying: apply every event that is due
+  while (traceHaveNext && t >= traceNextAt) {
+    traceValue  += traceNextDelta;
+    traceEventAt = traceNextAt;
+    traceEvents++;
+    traceFetchNext();
+  }
+  if (!traceHaveNext) {
+    traceReport("replayed");
+    traceMode = TRACE_OFF;
+  }
+  return traceValue;
+}
+
+// Loop-latency sample from loop(), counted while a session is running.
+static void traceNoteLoop(unsigned long us) {
+  if (traceMode == TRACE_OFF) return;
+  traceLoops++;
+  traceLoopUsSum += us;
+  if (us > traceLoopUsMax) traceLoopUsMax = us;
+}
+
+//  Serial commands: trace rec | play | stop | dump | clear | load <hex>
+// args is the rest of the command line after "trace" (may be NULL).
+static void traceCommand(char* args) {
+  char* sub = args ? strtok(args, " \t\r") : NULL;
+  if (!sub) { benchWrite("# trace rec|play|stop|dump|clear|load <hex>\n"); return; }
+
+  if (strcmp(sub, "rec") == 0) {
+    traceStartRecording(potValue);
+    benchWrite("# trace: recording\n");
+  } else if (strcmp(sub, "play") == 0) {
+    traceStartReplay();
+  } else if (strcmp(sub, "stop") == 0) {
+    traceStop();
+  } else if (strcmp(sub, "clear") == 0) {
+    traceStop();
+    traceLen = 0;
+  } else if (strcmp(sub, "dump") == 0) {
+    char line[16 + 2 * 32];
+    for (uint16_t i = 0; i < traceLen; i += 32) {
+      int n = 0;
+      n += snprintf(line + n, sizeof(line) - n, "trace load ");
+      for (uint16_t j = i; j < traceLen && j < i + 32; j++) {
+        n += snprintf(line + n, sizeof(line) - n, "%02X", traceBuf[j]);
+      }
+      benchPrintf("%s\n", line);
+    }
+    benchPrintf("# trace: %u bytes\n", traceLen);
+  } else if (strcmp(sub, "load") == 0) {
+    const char* hex = strtok(NULL, " \t\r");
+    while (hex && hex[0] && hex[1] && traceLen < TRACE_BYTES) {
+      char pair[3] = { hex[0], hex[1], '\0' };
+      traceBuf[traceLen++] = (uint8_t)strtoul(pair, NULL, 16);
+      hex += 2;
+    }
+  } else {
+    benchPrintf("# trace: unknown '%s'\n", sub);
+  }
+}
+
+#endif
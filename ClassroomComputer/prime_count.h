@@ -0,0 +1,280 @@
+#ifndef PRIME_COUNT_H
+#define PRIME_COUNT_H
+
+#include <stdint.h>
+#include <string.h>
+
+//  Prime counting: pi(x) for any 32-bit x by Meissel's formula
+//   pi(x) = phi(x, a) + a - 1 - P2(x, a),   a = pi(cbrt x)
+// phi(x, a) counts the numbers up to x with no prime factor among the first
+// a primes, and P2(x, a) those that are a product of two primes above p_a.
+//
+// phi expands as phi(x, a) = phi(x, 5) - sum phi(x / p_i, i - 1), 5 < i <= a.
+// phi(x, 5) comes from a memo table over one turn of the 2·3·5·7·11 = 2310
+// wheel, and every term with p_i² > x is exactly 1, so it is counted rather
+// than expanded.  Each level divides x by at least 13, which keeps the
+// explicit stack a few frames deep.
+//
+// P2 needs pi(x / p) for the primes p in (cbrt x, sqrt x].  A segmented sieve
+// of odd numbers sweeps upwards to x^(2/3) and answers those queries in
+// increasing order as it passes them, so no prime table bigger than the
+// sieving primes is ever stored.
+//
+// A PiJob runs one bounded step at a time like a BigJob.  No heap, no Arduino
+// dependencies (builds on host unchanged).
+
+#define PI_WHEEL_PRIMES   5
+#define PI_WHEEL          2310UL   // 2·3·5·7·11
+#define PI_WHEEL_PHI      480      // numbers in 1..2310 coprime to the wheel
+#define PI_WHEEL_WORDS    ((PI_WHEEL + 31) / 32)
+#define PI_SMALL_LIMIT    1626     // > cbrt(2^32); sieving primes lie below this
+#define PI_SMALL_MAX      260      // room for the 257 primes below PI_SMALL_LIMIT
+#define PI_SEGMENT_WORDS  256      // 1 KB of odd-number bits per segment
+#define PI_SEGMENT_SPAN   (PI_SEGMENT_WORDS * 64UL)
+#define PI_SIEVE_MAX      ((uint32_t)PI_SMALL_LIMIT * PI_SMALL_LIMIT - 1)  // largest x for piSieveCount()
+#define PI_STACK_DEPTH    10
+#define PI_PHI_NODES      64       // phi stack steps per piJobStep()
+#define PI_P2_CANDIDATES  256      // P2 candidates tested per piJobStep()
+#define PI_PHI_SHARE      800      // progress per mille given to phi (most of the time for large x)
+
+enum PiPhase { PI_PHASE_PHI, PI_PHASE_P2, PI_PHASE_DONE };
+
+struct PiFrame {
+  uint32_t x;
+  uint16_t a;       // children are phi(x / p_i, i - 1) for i up to a
+  uint16_t i;       // next child
+  int8_t   sign;
+};
+
+struct PiJob {
+  PiPhase  phase;
+  uint32_t x;
+  uint32_t cbrtX;
+  uint32_t sqrtX;
+  uint16_t a;            // pi(cbrtX)
+  int64_t  phi;          // phi(x, a) so far
+  PiFrame  stack[PI_STACK_DEPTH];
+  uint8_t  sp;
+  uint32_t top;          // largest x / p the sweep needs
+  uint32_t lo;           // current segment is [lo, lo + PI_SEGMENT_SPAN)
+  bool     sieved;
+  uint32_t below;        // primes below lo
+  uint16_t scanWord;     // pi(y) cursor within the segment
+  uint32_t scanCount;
+  uint32_t p;            // next P2 candidate, counting down from sqrtX
+  uint32_t p2Primes;     // primes in (cbrtX, sqrtX] so far
+  uint64_t p2Sum;        // sum of pi(x / p) over them
+  uint32_t result;
+  uint32_t stepsDone;
+  uint32_t stepsTotal;   // for progress display
+};
+
+static uint32_t piSegment[PI_SEGMENT_WORDS];
+static uint16_t piPrimes[PI_SMALL_MAX];
+static uint16_t piPrimeCount = 0;  // 0 until piTablesInit()
+static uint32_t piWheelBits[PI_WHEEL_WORDS];  // bit r: r coprime to the wheel
+static uint16_t piWheelBase[PI_WHEEL_WORDS];  // set bits in the words before
+
+//  Tables: the sieving primes (sieved in piSegment) and the wheel memo
+static void piTablesInit() {
+  if (piPrimeCount > 0) return;
+  memset(piSegment, 0, sizeof(piSegment));  // bit n set = n composite
+  for (uint32_t n = 2; n < PI_SMALL_LIMIT; n++) {
+    if (piSegment[n >> 5] & (1UL << (n & 31))) continue;
+    piPrimes[piPrimeCount++] = (uint16_t)n;
+    for (uint32_t m = n * n; m < PI_SMALL_LIMIT; m += n) piSegment[m >> 5] |= 1UL << (m & 31);
+  }
+
+  memset(piWheelBits, 0, sizeof(piWheelBits));
+  for (uint32_t r = 1; r < PI_WHEEL; r++) {
+    bool coprime = true;
+    for (int k = 0; k < PI_WHEEL_PRIMES; k++) if (r % piPrimes[k] == 0) coprime = false;
+    if (coprime) piWheelBits[r >> 5] |= 1UL << (r & 31);
+  }
+  uint16_t count = 0;
+  for (int w = 0; w < (int)PI_WHEEL_WORDS; w++) {
+    piWheelBase[w] = count;
+    count += __builtin_popcount(piWheelBits[w]);
+  }
+}
+
+// Set bits of word at positions 0..b
+static uint32_t piCountBits(uint32_t word, uint32_t b) {
+  return __builtin_popcount(word & (0xFFFFFFFFUL >> (31 - b)));
+}
+
+//  phi(x, 5): numbers in 1..x with no factor 2, 3, 5, 7 or 11
+static uint32_t piPhiWheel(uint32_t x) {
+  uint32_t r = x % PI_WHEEL;
+  return (x / PI_WHEEL) * PI_WHEEL_PHI + piWheelBase[r >> 5] + piCountBits(piWheelBits[r >> 5], r & 31);
+}
+
+//  Trial division by the sieving primes; exact for n < PI_SMALL_LIMIT²
+static bool piIsPrime(uint32_t n) {
+  if (n < 2) return false;
+  for (uint16_t k = 0; k < piPrimeCount; k++) {
+    uint32_t q = piPrimes[k];
+    if (q * q > n) return true;
+    if (n % q == 0) return false;
+  }
+  return true;
+}
+
+static uint32_t piRoot(uint32_t x, int k) {  // floor of the square (k = 2) or cube root
+  uint32_t r = 0;
+  for (uint32_t bit = 1UL << 16; bit > 0; bit >>= 1) {
+    uint64_t t = r | bit;
+    uint64_t v = (k == 2) ? t * t : t * t * t;
+    if (v <= x) r |= bit;
+  }
+  return r;
+}
+
+//  Sieves the odd numbers of [lo, lo + 64·words) into bits; bit j stands for
+// lo + 2j + 1 and is set if that is prime.  lo must be even; the bits are
+// exact below PI_SMALL_LIMIT².  Needs piTablesInit().
+static void piSieveInto(uint32_t* bits, uint16_t words, uint32_t lo) {
+  memset(bits, 0xFF, words * sizeof(uint32_t));
+  if (lo == 0) bits[0] &= ~1UL;  // 1 is not prime
+  uint32_t half = words * 32UL;
+  uint32_t hi   = lo + 2 * half;
+  for (uint16_t k = 1; k < piPrimeCount; k++) {
+    uint32_t q = piPrimes[k];
+    if (q * q >= hi) break;
+    uint32_t m = (lo + q - 1) / q * q;
+    if (m < q * q) m = q * q;
+    if (!(m & 1)) m += q;
+    for (uint32_t j = (m - lo) >> 1; j < half; j += q) bits[j >> 5] &= ~(1UL << (j & 31));
+  }
+}
+
+static void piSieveSegment(uint32_t lo) {
+  piSieveInto(piSegment, PI_SEGMENT_WORDS, lo);
+}
+
+//  Odd primes in the segment at lo (a multiple of PI_SEGMENT_SPAN, <= x)
+// that are <= x; x <= PI_SIEVE_MAX.  Sieves piSegment.  Adding it up over
+// the segments from 0, plus one for 2, is the reference count that checks
+// piJob results.
+static uint32_t piSieveCount(uint32_t lo, uint32_t x) {
+  piSieveSegment(lo);
+  uint32_t last = (x - lo < PI_SEGMENT_SPAN) ? x - lo : PI_SEGMENT_SPAN - 1;
+  if (last == 0) return 0;
+  uint32_t t = (last - 1) >> 1;  // last odd bit within x
+  uint32_t count = 0;
+  for (uint32_t w = 0; w < (t >> 5); w++) count += __builtin_popcount(piSegment[w]);
+  return count + piCountBits(piSegment[t >> 5], t & 31);
+}
+
+static void piJobStart(PiJob* job, uint32_t x) {
+  piTablesInit();
+  job->x          = x;
+  job->cbrtX      = piRoot(x, 3);
+  job->sqrtX      = piRoot(x, 2);
+  job->stepsDone  = 0;
+  job->stepsTotal = 1000;
+  job->a = 0;
+  while (job->a < piPrimeCount && piPrimes[job->a] <= job->cbrtX) job->a++;
+
+  if (x < PI_SMALL_LIMIT) {  // answer straight from the table
+    job->result = 0;
+    while (job->result < piPrimeCount && piPrimes[job->result] <= x) job->result++;
+    job->phase     = PI_PHASE_DONE;
+    job->stepsDone = job->stepsTotal;
+    return;
+  }
+
+  job->phase    = PI_PHASE_PHI;
+  job->phi      = piPhiWheel(x);
+  job->stack[0] = { x, job->a, PI_WHEEL_PRIMES + 1, 1 };
+  job->sp       = 1;
+
+  job->top       = x / (job->cbrtX + 1);
+  job->lo        = 0;
+  job->sieved    = false;
+  job->below     = 1;  // 2, which the odd-only segments skip
+  job->p         = job->sqrtX;
+  job->p2Primes  = 0;
+  job->p2Sum     = 0;
+}
+
+//  pi(y) for lo <= y < lo + PI_SEGMENT_SPAN; y must not decrease between calls
+// within a segment.
+static uint32_t piCountTo(PiJob* job, uint32_t y) {
+  if (y == job->lo) return job->below;  // lo is even
+  uint32_t t = (y - job->lo - 1) >> 1;
+  while (job->scanWord < (t >> 5)) job->scanCount += __builtin_popcount(piSegment[job->scanWord++]);
+  return job->below + job->scanCount + piCountBits(piSegment[t >> 5], t & 31);
+}
+
+static void piJobFinish(PiJob* job) {
+  uint64_t k  = job->p2Primes;
+  uint64_t p2 = job->p2Sum - (k * job->a + k * (k - 1) / 2);  // minus sum of pi(p) - 1
+  job->result    = (uint32_t)(job->phi + job->a - 1 - (int64_t)p2);
+  job->phase     = PI_PHASE_DONE;
+  job->stepsDone = job->stepsTotal;
+}
+
+//  Performs one bounded unit of work; returns true while more remain.
+// phi: up to PI_PHI_NODES stack steps.  P2: sieving one segment, or testing up
+// to PI_P2_CANDIDATES values of p against it.
+static bool piJobStep(PiJob* job) {
+  if (job->phase == PI_PHASE_PHI) {
+    for (int n = 0; n < PI_PHI_NODES && job->sp > 0; n++) {
+      PiFrame* f = &job->stack[job->sp - 1];
+      uint32_t p = (f->i <= f->a) ? piPrimes[f->i - 1] : 0;
+      if (p == 0 || p * p > f->x) {
+        if (p) job->phi -= f->sign * (int32_t)(f->a - f->i + 1);  // the rest are all 1
+        job->sp--;
+        continue;
+      }
+      PiFrame* c = f + 1;
+      c->x    = f->x / p;
+      c->a    = f->i - 1;
+      c->i    = PI_WHEEL_PRIMES + 1;
+      c->sign = -f->sign;
+      f->i++;
+      job->phi += c->sign * (int64_t)piPhiWheel(c->x);
+      job->sp++;
+    }
+    // The root's children cost roughly the same each
+    const PiFrame& root = job->stack[0];
+    job->stepsDone = (job->sp == 0 || job->a <= PI_WHEEL_PRIMES) ? PI_PHI_SHARE :
+      (uint32_t)PI_PHI_SHARE * (root.i - PI_WHEEL_PRIMES - 1) / (job->a - PI_WHEEL_PRIMES);
+    if (job->sp == 0) job->phase = PI_PHASE_P2;
+    return true;
+  }
+
+  if (job->phase == PI_PHASE_P2) {
+    if (!job->sieved) {
+      piSieveSegment(job->lo);
+      job->sieved    = true;
+      job->scanWord  = 0;
+      job->scanCount = 0;
+      return true;
+    }
+    uint32_t hi = job->lo + PI_SEGMENT_SPAN;
+    for (int n = 0; n < PI_P2_CANDIDATES; n++) {
+      if (job->p <= job->cbrtX) { piJobFinish(job); return false; }
+      uint32_t y = job->x / job->p;
+      if (y >= hi) {  // next segment
+        while (job->scanWord < PI_SEGMENT_WORDS) job->scanCount += __builtin_popcount(piSegment[job->scanWord++]);
+        job->below += job->scanCount;
+        job->lo     = hi;
+        job->sieved = false;
+        job->stepsDone = PI_PHI_SHARE + (uint32_t)((uint64_t)(1000 - PI_PHI_SHARE) * job->lo / (job->top + 1));
+        return true;
+      }
+      if ((job->p & 1) && piIsPrime(job->p)) {
+        job->p2Sum += piCountTo(job, y);
+        job->p2Primes++;
+      }
+      job->p--;
+    }
+    return true;
+  }
+
+  return false;
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef PRIME_ITER_H
+#define PRIME_ITER_H
+
+#include <stdint.h>
+#include <string.h>
+#include "prime_count.h"
+
+//  Incremental prime iterator
+// A PrimeIter hands out the primes in increasing order from any starting
+// point, one per call, without keeping the primes it has passed.  It reads
+// segments of PRIME_SEGMENT_SPAN numbers sieved by piSieveInto(), so besides
+// the segments it needs only the sieving primes below PI_SMALL_LIMIT (about
+// the square root of the range), and it is exact up to PRIME_ITER_MAX.
+//
+// Segments come from PRIME_CACHE_SLOTS slots, and each iterator owns one:
+// it reads any slot that already holds the segment it wants, but sieves only
+// into its own.  So two iterators walking apart, like the Primes explorer's
+// stream and the prime under its slider, never evict each other's segment,
+// and one walking the same stretch as another finds it already sieved.
+//
+//   PrimeIter it;
+//   primeIterStart(&it, 1000000, 0);   // sieves into slot 0
+//   for (uint32_t p = primeIterNext(&it); p != 0 && p < 1001000; p = primeIterNext(&it)) ...
+//
+// Like prime_count.h, nothing here depends on Arduino.
+
+#define PRIME_SEGMENT_WORDS  64                            // 256 bytes of odd-number bits
+#define PRIME_SEGMENT_SPAN   (PRIME_SEGMENT_WORDS * 64UL)  // 4096 numbers
+#define PRIME_CACHE_SLOTS    2
+#define PRIME_ITER_MAX       PI_SIEVE_MAX                  // primeIterNext() returns 0 past this
+
+struct PrimeSegment {
+  uint32_t lo;
+  bool     full;   // false until the slot is first sieved
+  uint32_t bits[PRIME_SEGMENT_WORDS];
+};
+
+static PrimeSegment primeCache[PRIME_CACHE_SLOTS];
+static uint32_t     primeSieveCount = 0;   // segments sieved so far
+
+// The sieved bits of the segment starting at lo, a multiple of
+// PRIME_SEGMENT_SPAN (bit j: lo + 2j + 1 is prime).  On a miss it sieves
+// into slot, the caller's own.
+static const uint32_t* primeSegmentBits(uint32_t lo, uint8_t slot) {
+  for (int i = 0; i < PRIME_CACHE_SLOTS; i++) {
+    if (primeCache[i].full && primeCache[i].lo == lo) return primeCache[i].bits;
+  }
+  PrimeSegment& s = primeCache[slot];
+  piTablesInit();
+  piSieveInto(s.bits, PRIME_SEGMENT_WORDS, lo);
+  s.lo   = lo;
+  s.full = true;
+  primeSieveCount++;
+  return s.bits;
+}
+
+struct PrimeIter {
+  uint32_t lo;     // segment being read
+  uint32_t bit;    // next bit to look at in it
+  bool     two;    // 2 is still to come
+  uint8_t  slot;   // cache slot it sieves into
+};
+
+// Positions it before the first prime >= from; slot (below
+// PRIME_CACHE_SLOTS) is the cache slot it owns.
+static void primeIterStart(PrimeIter* it, uint32_t from, uint8_t slot) {
+  uint32_t odd = from | 1;
+  it->slot = slot;
+  it->two  = (from <= 2);
+  it->lo   = odd / PRIME_SEGMENT_SPAN * PRIME_SEGMENT_SPAN;
+  it->bit  = (odd - it->lo - 1) / 2;
+}
+
+// The next prime, or 0 once past PRIME_ITER_MAX.
+static uint32_t primeIterNext(PrimeIter* it) {
+  if (it->two) {
+    it->two = false;
+    return 2;
+  }
+  while (it->lo <= PRIME_ITER_MAX) {
+    const uint32_t* bits = primeSegmentBits(it->lo, it->slot);
+    while (it->bit < PRIME_SEGMENT_SPAN / 2) {
+      uint32_t word = bits[it->bit >> 5] >> (it->bit & 31);
+      if (word == 0) {
+        it->bit = (it->bit | 31) + 1;   // rest of the word is composite
+        continue;
+      }
+      it->bit += __builtin_ctz(word);
+      uint32_t p = it->lo + 2 * it->bit + 1;
+      it->bit++;
+      return (p <= PRIME_ITER_MAX) ? p : 0;
+    }
+    it->lo += PRIME_SEGMENT_SPAN;
+    it->bit = 0;
+  }
+  return 0;
+}
+
+#endif
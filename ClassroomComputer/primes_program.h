@@ -2,21 +2,90 @@
 #define PRIMES_PROGRAM_H
 
 #include <Arduino.h>
+#include "kv_store.h"
+#include "prime_count.h"
+#include "prime_iter.h"
+#include "task_scheduler.h"
+#include "sketch_shared.h"
+#include "program_registry.h"
+#include "anim_timeline.h"
 
 //  Primes program states
 enum PrimesState {
   PRIMES_TITLE,        // "Calculate Primes" for 1 s
+  PRIMES_SELECT_MODE,  // "Choose mode:" / Nth prime, count to x or explore until slider static for 1.3 s
   PRIMES_INTRO_1,      // "Choose which / prime to find" for 1.5 s
   PRIMES_INTRO_2,      // "Move slider to / specify the #" for 1.5 s
   PRIMES_SHOW_N,       // "N = [n]" until slider static for 1.5 s
-  PRIMES_CALCULATING,  // "Finding the / [n]th prime" until done
+  PRIMES_CALCULATING,  // "Finding [n]th / [progress] ETA" until done
+  PRIMES_SHOW_X,       // "Count primes to" / x until slider static for 1.5 s
+  PRIMES_COUNTING,     // "pi([x])" / [progress] ETA until done
+  PRIMES_EXPLORE,      // "[prime] gap [g]" / stats of its range, until the slider is held far left
   PRIMES_RESULT        // "The [n]th prime / is [result] X" for 4.5 s
 };
 
 //  Primes-specific state
 static PrimesState   primesState  = PRIMES_TITLE;
 static int           primesN      = 500;   // locked-in N (how many primes to find)
-static unsigned long primesResult = 0;     // the Nth prime, set by PRIMES_CALCULATING
+static unsigned long primesResult = 0;     // the Nth prime, or pi(x) in counting mode
+static bool          primesCountMode = false;  // counting primes up to x instead of finding p_N
+static int           primesXStep  = 0;     // locked-in x, an index into PRIMES_X_STEPS
+
+//  Search in progress (a background task while PRIMES_CALCULATING)
+static const unsigned long PRIMES_SLICE_MICROS = 8000UL;
+static int           primesTask      = -1; // scheduler handle of the search
+static unsigned long primesCount     = 1;  // primes found so far (2 is the 1st)
+static unsigned long primesCandidate = 1;  // last odd number tested
+
+//  Results persist in the KV store: KV_KEY(KV_NS_PRIME, N) holds p_N, and id 0
+// holds the furthest (count, prime) pair reached, from which any larger N
+// can resume instead of starting again at 3.
+#define PRIMES_CHECKPOINT_KEY KV_KEY(KV_NS_PRIME, 0)
+
+//  Counting mode: pi(x) for x on a 1-2-5 scale up to the largest 32-bit
+// number, by the time-sliced Meissel count in prime_count.h.  Results are
+// kept under KV_KEY(KV_NS_PI, step).
+static const uint32_t PRIMES_X_STEPS[] = {
+  100UL, 200UL, 500UL, 1000UL, 2000UL, 5000UL, 10000UL, 20000UL, 50000UL,
+  100000UL, 200000UL, 500000UL, 1000000UL, 2000000UL, 5000000UL,
+  10000000UL, 20000000UL, 50000000UL, 100000000UL, 200000000UL, 500000000UL,
+  1000000000UL, 2000000000UL, 4294967295UL
+};
+static const int PRIMES_X_STEP_COUNT = sizeof(PRIMES_X_STEPS) / sizeof(PRIMES_X_STEPS[0]);
+static const unsigned long PRIMES_COUNT_SLICE_MICROS = 8000UL;
+static PiJob primesPiJob;
+
+//  Explorer mode: the slider picks x up to PRIME_ITER_MAX (squared, so the
+// small numbers get room) and the screen shows the first prime from x, the
+// gap after it, and the density, twin primes and largest gap of the
+// PRIMES_RANGE_SPAN numbers around it.  A PrimeIter streams the primes from
+// 2 up to the slider's range in a background task and keeps only these
+// per-range totals, so going back down needs no sieving at all, and the
+// record gap up to x is the largest of the totals below it.  The stream
+// survives leaving the mode, and picks up where it stopped.
+#define PRIMES_RANGE_SPAN   32768UL
+#define PRIMES_RANGE_COUNT  (PRIME_ITER_MAX / PRIMES_RANGE_SPAN + 1)
+#define PRIMES_SLOT_SCAN    0   // prime_iter.h cache slots: the stream's
+#define PRIMES_SLOT_VIEW    1   // and the slider's
+static_assert(PRIMES_SLOT_VIEW < PRIME_CACHE_SLOTS, "the explorer needs a cache slot per iterator");
+static const unsigned long PRIMES_EXPLORE_SLICE_MICROS = 4000UL;
+static const int           PRIMES_EXPLORE_EXIT_MAX     = 153;   // ≤ 15%: hold to exit
+static const unsigned long PRIMES_EXPLORE_EXIT_HOLD    = 2000UL;
+static const unsigned long PRIMES_EXPLORE_PAGE_MS      = 2000UL;
+static const uint32_t      PRIMES_EXPLORE_MAX_X        = PRIME_ITER_MAX - 400;  // two primes above (gaps < 200)
+
+struct PrimesRange {
+  uint16_t primes;
+  uint16_t twins;    // pairs p, p + 2 with p + 2 in the range
+  uint8_t  maxGap;   // largest gap ending in the range (114 is the largest below 10^6)
+};
+
+static PrimesRange   primesRanges[PRIMES_RANGE_COUNT];
+static PrimeIter     primesScan;                 // the stream
+static uint32_t      primesScanLast      = 0;    // last prime streamed; 0 = not started
+static uint16_t      primesScanDone      = 0;    // ranges below this are complete
+static uint16_t      primesExploreRange  = 0;    // range under the slider
+static unsigned long primesExploreExitAt = 0;    // slider entered the exit zone; 0 = not there
 
 //  Forward declarations (need to be visible to other modules)
 void enterPrimesState(PrimesState next);
@@ -47,40 +116,25 @@ static const char* ordinalSuffix(int n) {
 
 //  Primes sub-handler forward declarations
 static void handlePrimesTitle(unsigned long now);
+static void handlePrimesSelectMode(unsigned long now);
 static void handlePrimesIntro1(unsigned long now);
 static void handlePrimesIntro2(unsigned long now);
 static void handlePrimesShowN(unsigned long now);
 static void handlePrimesCalculating(unsigned long now);
+static void handlePrimesShowX(unsigned long now);
+static void handlePrimesCounting(unsigned long now);
+static void handlePrimesExplore(unsigned long now);
 static void handlePrimesResult(unsigned long now);
+static void primesSearchTask(unsigned long now);
+static void primesCountTask(unsigned long now);
+static void primesScanTask(unsigned long now);
 
 //  Implementations
 
-// External references to shared state (defined in main sketch)
-extern rgb_lcd lcd;
-extern const byte COL_PINK[3];
-extern const byte COL_GREEN[3];
-extern unsigned long stateEnteredAt;
-extern int scrollOffset;
-extern unsigned long scrollTickAt;
-extern bool potHasMoved;
-extern int potValue;
-extern unsigned long potLastMovedAt;
-extern byte celebFrame0[8];
-extern byte celebFrame1[8];
-extern byte celebFrame2[8];
-extern byte celebFrame3[8];
-extern byte celebFrame4[8];
-extern byte celebFrame5[8];
-extern byte celebFrame6[8];
-extern byte celebFrame7[8];
-extern const int CELEB_FRAME_COUNT;
-extern int celebFrameIdx;
-extern unsigned long celebTickAt;
-extern const int BUZZER_PIN;
-extern void tickCelebrationSound(unsigned long now);
-extern const unsigned long SCROLL_START_DELAY;
-extern void tickScroll(const char* str, uint8_t row, unsigned long now, int wrapGap, bool loop);
-extern void enterAppState(int nextState);  // forward declaration; APP_PROGRAM_SELECT = 1
+// Bottom line of the result screen; the celebration goes right after it.
+static int formatPrimesBottom(char* out, size_t size) {
+  return snprintf(out, size, primesCountMode ? "= %lu " : "is %lu ", primesResult);
+}
 
 void enterPrimesState(PrimesState next) {
   primesState    = next;
@@ -88,21 +142,59 @@ void enterPrimesState(PrimesState next) {
   scrollOffset   = 0;
   scrollTickAt   = millis();
   potHasMoved    = false;
-  // Green backlight from PRIMES_CALCULATING through PRIMES_RESULT; pink otherwise
-  if (next == PRIMES_CALCULATING || next == PRIMES_RESULT)
-    lcd.setRGB(COL_GREEN[0], COL_GREEN[1], COL_GREEN[2]);
+  // Green backlight while computing and on the result; pink otherwise
+  if (next == PRIMES_CALCULATING || next == PRIMES_COUNTING || next == PRIMES_RESULT)
+    setBacklight(COL_GREEN);
   else
-    lcd.setRGB(COL_PINK[0],  COL_PINK[1],  COL_PINK[2]);
+    setBacklight(COL_PINK);
   lcd.clear();
+  if (next == PRIMES_RESULT) {
+    char botText[16];
+    animPlay(&CELEB_GLYPH_CLIP, formatPrimesBottom(botText, sizeof(botText)), 1);
+    animPlay(&CELEB_GLOW_CLIP);
+  }
+
+  taskCancel(primesTask);
+  if (next == PRIMES_CALCULATING) {
+    primesCount     = 1;
+    primesCandidate = 1;
+    uint32_t checkpoint[2];
+    if (kvGet(PRIMES_CHECKPOINT_KEY, checkpoint, sizeof(checkpoint)) &&
+        checkpoint[0] <= (uint32_t)primesN) {
+      primesCount     = checkpoint[0];
+      primesCandidate = checkpoint[1];
+    }
+    progressBegin(1, 0, 11);
+    primesTask = taskAdd("primes", primesSearchTask, 0, TASK_PRIO_COMPUTE,
+                         PRIMES_SLICE_MICROS, TASK_GROUP_PROGRAM);
+  }
+  if (next == PRIMES_COUNTING) {
+    piJobStart(&primesPiJob, PRIMES_X_STEPS[primesXStep]);
+    progressBegin(1, 0, 11);
+    primesTask = taskAdd("primes", primesCountTask, 0, TASK_PRIO_COMPUTE,
+                         PRIMES_COUNT_SLICE_MICROS, TASK_GROUP_PROGRAM);
+  }
+  if (next == PRIMES_EXPLORE) {
+    if (primesScanLast == 0) {
+      memset(primesRanges, 0, sizeof(primesRanges));
+      primeIterStart(&primesScan, 0, PRIMES_SLOT_SCAN);
+    }
+    primesExploreExitAt = 0;
+    primesTask = -1;  // started by the handler while the stream is behind the slider
+  }
 }
 
 void handlePrimes(unsigned long now) {
   switch (primesState) {
     case PRIMES_TITLE:       handlePrimesTitle(now);       break;
+    case PRIMES_SELECT_MODE: handlePrimesSelectMode(now);  break;
     case PRIMES_INTRO_1:     handlePrimesIntro1(now);      break;
     case PRIMES_INTRO_2:     handlePrimesIntro2(now);      break;
     case PRIMES_SHOW_N:      handlePrimesShowN(now);       break;
     case PRIMES_CALCULATING: handlePrimesCalculating(now); break;
+    case PRIMES_SHOW_X:      handlePrimesShowX(now);       break;
+    case PRIMES_COUNTING:    handlePrimesCounting(now);    break;
+    case PRIMES_EXPLORE:     handlePrimesExplore(now);     break;
     case PRIMES_RESULT:      handlePrimesResult(now);      break;
   }
 }
@@ -116,7 +208,23 @@ static void handlePrimesTitle(unsigned long now) {
   lcd.print("Calculate Primes");
 
   if (now - stateEnteredAt >= 1000UL) {
-    enterPrimesState(PRIMES_INTRO_1);
+    enterPrimesState(PRIMES_SELECT_MODE);
+  }
+}
+
+// State 1b – "Choose mode:" / Nth prime, count to x or explore until slider
+// static for 1.3 s.  The slider in thirds: Nth prime, counting, explorer.
+static void handlePrimesSelectMode(unsigned long now) {
+  int mode = (long)potValue * 3 / 1024;
+
+  lcd.setCursor(0, 0);
+  lcd.print("Choose mode:");
+  lcd.setCursor(0, 1);
+  lcd.print(mode == 2 ? "Explore gaps    " : mode == 1 ? "Count up to x   " : "Find Nth prime  ");
+
+  if (potHasMoved && (now - potLastMovedAt >= 1300UL)) {
+    primesCountMode = (mode == 1);
+    enterPrimesState(mode == 2 ? PRIMES_EXPLORE : mode == 1 ? PRIMES_SHOW_X : PRIMES_INTRO_1);
   }
 }
 
@@ -144,8 +252,34 @@ static void handlePrimesIntro2(unsigned long now) {
   }
 }
 
+//  Lock-in helpers: an N or x found before goes straight to the result
+static void primesLockInN(int n) {
+  primesCountMode = false;
+  primesN = n;
+  uint32_t cached;
+  if (kvGet(KV_KEY(KV_NS_PRIME, n), &cached, sizeof(cached))) {
+    primesResult = cached;
+    enterPrimesState(PRIMES_RESULT);
+  } else {
+    enterPrimesState(PRIMES_CALCULATING);
+  }
+}
+
+static void primesLockInX(int step) {
+  primesCountMode = true;
+  primesXStep = step;
+  uint32_t cached[2];
+  if (kvGet(KV_KEY(KV_NS_PI, step), cached, sizeof(cached)) && cached[0] == PRIMES_X_STEPS[step]) {
+    primesResult = cached[1];
+    enterPrimesState(PRIMES_RESULT);
+  } else {
+    enterPrimesState(PRIMES_COUNTING);
+  }
+}
+
 // State 4 – "N = [n]" with pot mapped to [30000, 100000].
-// Locks in once slider is static for 1.5 s.
+// Locks in once slider is static for 1.5 s; an N found before goes straight
+// to the result.
 static void handlePrimesShowN(unsigned long now) {
   int n = map(potValue, 0, 1023, 30000, 100000);
 
@@ -155,39 +289,184 @@ static void handlePrimesShowN(unsigned long now) {
   lcd.print("      ");  // overwrite leftover digits
 
   if (potHasMoved && (now - potLastMovedAt >= 1500UL)) {
-    primesN = n;
-    enterPrimesState(PRIMES_CALCULATING);
+    bootRememberParam(n);
+    primesLockInN(n);
   }
 }
 
-// State 5 – "Finding the / [n]th prime" while computing.
-// Blocks until the Nth prime is found, then transitions.
+// State 5 – "Finding [n]th" / progress bar + ETA while computing.
+// The search itself is primesSearchTask(); this only redraws the progress.
 static void handlePrimesCalculating(unsigned long now) {
   lcd.setCursor(0, 0);
-  lcd.print("Finding the");
-  lcd.setCursor(0, 1);
+  lcd.print("Finding ");
   lcd.print(primesN);
   lcd.print(ordinalSuffix(primesN));
-  lcd.print(" prime     ");  // pad to clear leftover text
 
-  // Find the primesN-th prime by trial division
-  unsigned long count = 1;       // 2 is the 1st prime
-  unsigned long candidate = 3;
-  while (count < (unsigned long)primesN) {
-    if (isPrime(candidate)) count++;
-    if (count < (unsigned long)primesN) candidate += 2;
+  progressUpdate(primesCount, (unsigned long)primesN, now - stateEnteredAt);
+}
+
+// Background task – trial division for at most PRIMES_SLICE_MICROS per run so
+// the bar keeps moving; the 100,000th prime takes several seconds.
+static void primesSearchTask(unsigned long now) {
+  while (primesCount < (unsigned long)primesN && taskHasBudget()) {
+    primesCandidate += 2;
+    if (isPrime(primesCandidate)) primesCount++;
+  }
+
+  if (primesCount >= (unsigned long)primesN) {
+    primesResult = (primesN == 1) ? 2 : primesCandidate;
+
+    uint32_t value = primesResult;
+    kvPut(KV_KEY(KV_NS_PRIME, primesN), &value, sizeof(value));
+    uint32_t checkpoint[2];
+    bool further = !kvGet(PRIMES_CHECKPOINT_KEY, checkpoint, sizeof(checkpoint)) ||
+                   checkpoint[0] < (uint32_t)primesN;
+    if (further && primesN > 1) {  // resuming needs an odd last prime
+      checkpoint[0] = primesN;
+      checkpoint[1] = primesResult;
+      kvPut(PRIMES_CHECKPOINT_KEY, checkpoint, sizeof(checkpoint));
+    }
+
+    enterPrimesState(PRIMES_RESULT);
   }
-  primesResult = (primesN == 1) ? 2 : candidate;
+}
+
+// State 4b – "Count primes to" / x on a 1-2-5 scale.  Locks in once the
+// slider is static for 1.5 s; an x counted before goes straight to the result.
+static void handlePrimesShowX(unsigned long now) {
+  int step = (long)potValue * PRIMES_X_STEP_COUNT / 1024;
 
+  lcd.setCursor(0, 0);
+  lcd.print("Count primes to");
+  lcd.setCursor(0, 1);
+  lcd.print(PRIMES_X_STEPS[step]);
+  lcd.print("      ");  // overwrite leftover digits
+
+  if (potHasMoved && (now - potLastMovedAt >= 1500UL)) {
+    bootRememberParam(-1 - step);
+    primesLockInX(step);
+  }
+}
+
+// State 5b – "pi([x])" / progress bar + ETA while primesCountTask() runs.
+static void handlePrimesCounting(unsigned long now) {
+  lcd.setCursor(0, 0);
+  lcd.print("pi(");
+  lcd.print(PRIMES_X_STEPS[primesXStep]);
+  lcd.print(")");
+
+  progressUpdate(primesPiJob.stepsDone, primesPiJob.stepsTotal, now - stateEnteredAt);
+}
+
+// Background task – piJobStep() until the slice is spent.  2^32 takes a few
+// seconds, nearly all of it in the phi expansion.
+static void primesCountTask(unsigned long now) {
+  bool more = true;
+  while (more && taskHasBudget()) more = piJobStep(&primesPiJob);
+  if (more) return;
+
+  primesResult = primesPiJob.result;
+  uint32_t value[2] = { primesPiJob.x, primesPiJob.result };
+  kvPut(KV_KEY(KV_NS_PI, primesXStep), value, sizeof(value));
   enterPrimesState(PRIMES_RESULT);
 }
 
+// State 4c – the explorer.  Row 0: the first prime from x and the gap to the
+// next one.  Row 1 alternates density and twins with the range's largest gap
+// and the record gap so far, once the stream has passed the range.  Holding
+// the slider at the far left for 2 s goes back to the menu.
+static void handlePrimesExplore(unsigned long now) {
+  char line[40];
+  if (potHasMoved && potValue <= PRIMES_EXPLORE_EXIT_MAX) {
+    if (primesExploreExitAt == 0) primesExploreExitAt = now;
+    if (now - primesExploreExitAt >= PRIMES_EXPLORE_EXIT_HOLD) {
+      enterAppState(1);  // APP_PROGRAM_SELECT = 1
+      return;
+    }
+    lcd.setCursor(0, 0);
+    lcd.print("Hold to exit... ");
+    lcd.setCursor(0, 1);
+    lcd.print("                ");
+    return;
+  }
+  primesExploreExitAt = 0;
+
+  uint32_t pos  = max(potValue, PRIMES_EXPLORE_EXIT_MAX + 1) - PRIMES_EXPLORE_EXIT_MAX - 1;
+  uint32_t span = 1023 - PRIMES_EXPLORE_EXIT_MAX - 1;
+  uint32_t x    = (uint32_t)((uint64_t)PRIMES_EXPLORE_MAX_X * pos * pos / (span * span));
+  primesExploreRange = x / PRIMES_RANGE_SPAN;
+  if (primesScanDone <= primesExploreRange && primesTask < 0) {
+    primesTask = taskAdd("primes", primesScanTask, 0, TASK_PRIO_COMPUTE,
+                         PRIMES_EXPLORE_SLICE_MICROS, TASK_GROUP_PROGRAM);
+  }
+
+  //  Row 0: from the view's own cache slot, so sliding back and forth rarely
+  // sieves, and the stream running ahead doesn't take the segment away
+  PrimeIter view;
+  primeIterStart(&view, x, PRIMES_SLOT_VIEW);
+  uint32_t p = primeIterNext(&view);
+  uint32_t q = primeIterNext(&view);
+  snprintf(line, sizeof(line), "%-8lu gap %-4lu", (unsigned long)p, (unsigned long)(q - p));
+  lcd.setCursor(0, 0);
+  lcd.print(line);
+
+  //  Row 1: the range's totals
+  uint16_t r = primesExploreRange;
+  if (primesScanDone <= r) {
+    snprintf(line, sizeof(line), "scanning %3d%%   ", (int)(primesScanDone * 100L / (r + 1)));
+  } else if ((now - stateEnteredAt) / PRIMES_EXPLORE_PAGE_MS % 2 == 0) {
+    uint32_t lo    = r * PRIMES_RANGE_SPAN;
+    uint32_t width = min((uint32_t)PRIMES_RANGE_SPAN, PRIME_ITER_MAX + 1 - lo);
+    uint32_t tenths = primesRanges[r].primes * 1000UL / width;   // of a percent
+    snprintf(line, sizeof(line), "%2lu.%lu%% %4u twins", (unsigned long)(tenths / 10),
+             (unsigned long)(tenths % 10), primesRanges[r].twins);
+  } else {
+    uint8_t before = 0;
+    for (uint16_t i = 0; i < r; i++) before = max(before, primesRanges[i].maxGap);
+    uint8_t gap = primesRanges[r].maxGap;
+    if (gap > before) snprintf(line, sizeof(line), "gap %-3u record! ", gap);
+    else              snprintf(line, sizeof(line), "gap %-3u  rec %-3u", gap, before);
+  }
+  line[16] = '\0';
+  lcd.setCursor(0, 1);
+  lcd.print(line);
+}
+
+// Background task – streams primes into primesRanges until the range under
+// the slider is complete, then ends; the handler starts it again when the
+// slider moves past the stream.
+static void primesScanTask(unsigned long now) {
+  while (primesScanDone <= primesExploreRange && taskHasBudget()) {
+    uint32_t p = primeIterNext(&primesScan);
+    if (p == 0) {
+      primesScanDone = PRIMES_RANGE_COUNT;
+      break;
+    }
+    uint16_t r = p / PRIMES_RANGE_SPAN;
+    primesScanDone = r;
+    PrimesRange& g = primesRanges[r];
+    g.primes++;
+    if (primesScanLast > 0) {
+      uint32_t gap = p - primesScanLast;
+      if (gap == 2) g.twins++;
+      if (gap > g.maxGap) g.maxGap = gap;
+    }
+    primesScanLast = p;
+  }
+  if (primesScanDone > primesExploreRange) {
+    taskCancel(primesTask);
+    primesTask = -1;
+  }
+}
+
 // State 6 – "The [n]th prime / is [result] X" for 6.0 s.
-// Top line scrolls if >16 chars; bottom is always static with celeb animation.
+// Top line scrolls if >16 chars; bottom is static, with the celebration
+// enterPrimesState starts after it.
 static void handlePrimesResult(unsigned long now) {
   //  Top line
   char topLine[32];
-  snprintf(topLine, sizeof(topLine), "The %d%s prime", primesN, ordinalSuffix(primesN));
+  if (primesCountMode) snprintf(topLine, sizeof(topLine), "Primes up to %lu", (unsigned long)PRIMES_X_STEPS[primesXStep]);
+  else                 snprintf(topLine, sizeof(topLine), "The %d%s prime", primesN, ordinalSuffix(primesN));
   int topLen = strlen(topLine);
 
   if (topLen <= 16) {
@@ -202,33 +481,12 @@ static void handlePrimesResult(unsigned long now) {
     }
   }
 
-  //  Bottom line (always fits in 16)
+  //  Bottom line (always fits in 16), then the celebration
   char botText[16];
-  snprintf(botText, sizeof(botText), "is %lu ", primesResult);
-  int celebCol = strlen(botText);
-
+  formatPrimesBottom(botText, sizeof(botText));
   lcd.setCursor(0, 1);
   lcd.print(botText);
 
-  //  Celebratory animation (pulsing diamond)
-  if (celebTickAt < stateEnteredAt) {
-    celebFrameIdx = 0;
-    lcd.createChar(0, celebFrame0);
-    celebTickAt = stateEnteredAt + 200UL;
-  }
-
-  if (now >= celebTickAt) {
-    celebFrameIdx = (celebFrameIdx + 1) % CELEB_FRAME_COUNT;
-    byte* frames[8] = {celebFrame0, celebFrame1, celebFrame2, celebFrame3,
-                        celebFrame4, celebFrame5, celebFrame6, celebFrame7};
-    lcd.createChar(0, frames[celebFrameIdx]);
-    celebTickAt = now + 200UL;
-  }
-
-  // createChar moves the cursor, so reposition before writing the char
-  lcd.setCursor(celebCol, 1);
-  lcd.write((uint8_t)0);
-
   // Celebration jingle
   tickCelebrationSound(now);
 
@@ -238,4 +496,28 @@ static void handlePrimesResult(unsigned long now) {
   }
 }
 
+// True while a count is using piSegment (the Serial pi sweeps wait).
+static bool primesCounting() { return primesState == PRIMES_COUNTING && taskSlot(primesTask) >= 0; }
+
+//  Registry entry (see program_registry.h)
+static void primesEnter() { enterPrimesState(PRIMES_TITLE); }
+static void primesExit()  { taskCancel(primesTask); }
+// param is N, or -1 - step for the counting mode's x
+static void primesResume(long param) {
+  if (param < 0) primesLockInX(constrain(-1 - param, 0L, (long)PRIMES_X_STEP_COUNT - 1));
+  else           primesLockInN(constrain(param, 30000L, 100000L));
+}
+
+constexpr size_t PRIMES_STATIC_BYTES =
+  sizeof(primesPiJob) + sizeof(piSegment) + sizeof(piPrimes) + sizeof(piWheelBits) + sizeof(piWheelBase) +
+  sizeof(primeCache) + sizeof(primesRanges);
+static_assert(PRIMES_STATIC_BYTES <= UINT16_MAX, "PRIMES_STATIC_BYTES does not fit ProgramInfo::staticBytes");
+
+constexpr ProgramInfo PRIMES_PROGRAM = {
+  "Primes", primesEnter, handlePrimes, primesExit,
+  PRIMES_STATIC_BYTES,
+  CGRAM_CELEBRATION | CGRAM_PROGRESS_SLOTS,
+  primesResume
+};
+
 #endif
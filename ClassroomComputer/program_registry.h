@@ -0,0 +1,39 @@
+#ifndef PROGRAM_REGISTRY_H
+#define PROGRAM_REGISTRY_H
+
+#include <Arduino.h>
+
+//  Program registry
+// Each program header ends with a constexpr ProgramInfo describing it, and
+// the main sketch lists those descriptors in PROGRAMS[].  The menu, the
+// dispatcher and the power report all work from that table, so adding a
+// program means writing its header and adding one row.
+//
+// Static bytes are the program's own buffers, which stay resident in RAM
+// whichever program is running; CGRAM is the mask of custom-character slots
+// it redefines.  The sketch checks both at compile time against the budgets
+// below.  Each header sums its buffers into a size_t and static_asserts that
+// it fits staticBytes before the entry narrows it.
+//
+// A program that calls bootRememberParam() when the user locks in a setting
+// (an N, a size) can also provide resume(): after a restart with resume
+// enabled the sketch skips the welcome and menu and hands it that setting.
+
+#define PROGRAM_STATIC_BUDGET 17408   // bytes of the R4's 32 KB for program statics, all resident
+
+#define CGRAM_SLOT(n)         (1u << (n))
+#define CGRAM_CELEBRATION     CGRAM_SLOT(0)
+#define CGRAM_SHARED_GLYPHS   (CGRAM_SLOT(1) | CGRAM_SLOT(2) | CGRAM_SLOT(3))  // µ → ←
+#define CGRAM_PROGRESS_SLOTS  (CGRAM_SLOT(4) | CGRAM_SLOT(5) | CGRAM_SLOT(6) | CGRAM_SLOT(7))
+
+struct ProgramInfo {
+  const char* name;                   // menu label
+  void      (*enter)();               // start at the program's first screen
+  void      (*tick)(unsigned long now);
+  void      (*exit)();                // release jobs, sounds; NULL = nothing to do
+  uint16_t    staticBytes;
+  uint8_t     cgram;
+  void      (*resume)(long param);    // restart at a saved setting; NULL = enter()
+};
+
+#endif
@@ -0,0 +1,389 @@
+#ifndef SEARCH_PROGRAM_H
+#define SEARCH_PROGRAM_H
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include "task_scheduler.h"
+#include "sketch_shared.h"
+#include "program_registry.h"
+
+//  Search Test – the sibling of Sort Test: why sorted data matters.
+// Builds N random keys, then times the same batch of lookups (half present,
+// half random) four ways: a linear scan of the raw data, a branchless binary
+// search and an interpolation search of a sorted copy, and an open-addressing
+// hash table.  Building the sorted copy and the table is timed too, so the
+// results show both the per-lookup cost and what each index costs up front.
+
+//  Search Test program states
+enum SearchTestState {
+  SEARCH_TITLE,        // "Search Test" for 1.75 s
+  SEARCH_QUESTION,     // "Scan, bisect or / hash: how fast?" for 2 s
+  SEARCH_SELECT_SIZE,  // "Move slider to / select data size"
+  SEARCH_SHOW_N,       // "N = [n]" until slider static for 1.3 s
+  SEARCH_CONFIRM_N,    // "Timing lookups / for N = [n]" for 1.3 s
+  SEARCH_RUNNING,      // "Timing lookups / [progress] ETA"
+  SEARCH_RESULTS,      // one method per page, 2 s each
+  SEARCH_PAYOFF        // "Sorting pays off / after X lookups" for 3 s
+};
+
+enum SearchMethod { SEARCH_LINEAR, SEARCH_BINARY, SEARCH_INTERP, SEARCH_HASH, SEARCH_METHOD_COUNT };
+
+static const char* const SEARCH_METHOD_NAMES[SEARCH_METHOD_COUNT] = {
+  "Linear", "Binary", "Interp", "Hash"
+};
+
+static const int           SEARCH_MIN_N       = 16;
+static const int           SEARCH_MAX_N       = 512;
+static const int           SEARCH_QUERIES     = 256;     // lookups per timed batch
+static const int           SEARCH_TABLE_MAX   = 1024;    // hash slots (load <= 1/2)
+static const uint16_t      SEARCH_KEY_RANGE   = 60000;
+static const uint16_t      SEARCH_EMPTY       = 0xFFFF;  // free hash slot
+static const unsigned long SEARCH_MIN_TIME_US = 2000;    // repeat batches until this long
+static const int           SEARCH_MAX_REPS    = 64;
+static const unsigned long SEARCH_PAGE_MS     = 2000;
+
+//  Data and indexes
+static uint16_t searchKeys[SEARCH_MAX_N];       // raw, in generation order
+static uint16_t searchSorted[SEARCH_MAX_N];     // sorted copy
+static uint16_t searchTable[SEARCH_TABLE_MAX];  // open addressing, linear probing
+static uint16_t searchQueries[SEARCH_QUERIES];
+
+//  Search-specific state
+static SearchTestState searchState = SEARCH_TITLE;
+static int           searchN        = 100;      // N locked in when leaving SEARCH_SHOW_N
+static int           searchTableBits = 0;
+static int           searchStep     = 0;        // timing steps done while SEARCH_RUNNING
+static int           searchTask     = -1;       // scheduler handle of the timing job
+static unsigned long searchBuildSortUs = 0;
+static unsigned long searchBuildHashUs = 0;
+static unsigned long searchNs[SEARCH_METHOD_COUNT];    // per lookup
+static int           searchHits[SEARCH_METHOD_COUNT];  // per batch; must agree
+
+//  Timing steps: build sorted copy, build table, then one per method
+static const int SEARCH_STEPS = 2 + SEARCH_METHOD_COUNT;
+
+//  Forward declarations
+void enterSearchState(SearchTestState next);
+void handleSearchTest(unsigned long now);
+
+//  Search sub-handler forward declarations
+static void handleSearchTitle(unsigned long now);
+static void handleSearchQuestion(unsigned long now);
+static void handleSearchSelectSize(unsigned long now);
+static void handleSearchShowN(unsigned long now);
+static void handleSearchConfirmN(unsigned long now);
+static void handleSearchRunning(unsigned long now);
+static void handleSearchResults(unsigned long now);
+static void handleSearchPayoff(unsigned long now);
+static void searchRunTask(unsigned long now);
+static void searchReport();
+
+//  Lookup algorithms (each answers "is key present?")
+
+static bool linearFind(const uint16_t* a, int n, uint16_t key) {
+  for (int i = 0; i < n; i++)
+    if (a[i] == key) return true;
+  return false;
+}
+
+// Halves the range without a data-dependent branch: the comparison selects
+// the new base, which compiles to a conditional move.
+static bool binaryFind(const uint16_t* a, int n, uint16_t key) {
+  const uint16_t* base = a;
+  while (n > 1) {
+    int half = n / 2;
+    base = (base[half] <= key) ? base + half : base;
+    n -= half;
+  }
+  return *base == key;
+}
+
+// Guesses the position from the key's value; about log log n probes on
+// uniformly distributed keys.
+static bool interpFind(const uint16_t* a, int n, uint16_t key) {
+  int lo = 0, hi = n - 1;
+  while (lo <= hi && key >= a[lo] && key <= a[hi]) {
+    if (a[hi] == a[lo]) return a[lo] == key;
+    int pos = lo + (int)((long)(key - a[lo]) * (hi - lo) / (a[hi] - a[lo]));
+    if (a[pos] == key) return true;
+    if (a[pos] < key) lo = pos + 1;
+    else              hi = pos - 1;
+  }
+  return false;
+}
+
+// Fibonacci hashing: the top bits of key × 2^32/φ.
+static uint32_t searchHash(uint16_t key) {
+  return (uint32_t)(key * 2654435769UL) >> (32 - searchTableBits);
+}
+
+static void hashInsert(uint16_t key) {
+  uint32_t mask = (1UL << searchTableBits) - 1;
+  uint32_t i = searchHash(key);
+  while (searchTable[i] != SEARCH_EMPTY && searchTable[i] != key) i = (i + 1) & mask;
+  searchTable[i] = key;
+}
+
+static bool hashFind(uint16_t key) {
+  uint32_t mask = (1UL << searchTableBits) - 1;
+  uint32_t i = searchHash(key);
+  while (searchTable[i] != SEARCH_EMPTY) {
+    if (searchTable[i] == key) return true;
+    i = (i + 1) & mask;
+  }
+  return false;
+}
+
+static int compareKeys(const void* a, const void* b) {
+  return (int)*(const uint16_t*)a - (int)*(const uint16_t*)b;
+}
+
+// One batch of lookups with the given method; returns the number found.
+static int searchBatch(int method) {
+  int hits = 0;
+  for (int q = 0; q < SEARCH_QUERIES; q++) {
+    uint16_t key = searchQueries[q];
+    bool found;
+    switch (method) {
+      case SEARCH_LINEAR: found = linearFind(searchKeys, searchN, key);   break;
+      case SEARCH_BINARY: found = binaryFind(searchSorted, searchN, key); break;
+      case SEARCH_INTERP: found = interpFind(searchSorted, searchN, key); break;
+      default:            found = hashFind(key);                          break;
+    }
+    hits += found;
+  }
+  return hits;
+}
+
+//  Implementations
+
+void enterSearchState(SearchTestState next) {
+  searchState    = next;
+  stateEnteredAt = millis();
+  scrollOffset   = 0;
+  scrollTickAt   = millis();
+  potHasMoved    = false;
+  if (next == SEARCH_RUNNING) setBacklight(COL_GREEN);
+  else                        setBacklight(COL_PINK);
+  lcd.clear();
+
+  taskCancel(searchTask);
+  if (next == SEARCH_RUNNING) {
+    for (int i = 0; i < searchN; i++) searchKeys[i] = random(SEARCH_KEY_RANGE);
+    for (int q = 0; q < SEARCH_QUERIES; q++) {
+      searchQueries[q] = (q & 1) ? (uint16_t)random(SEARCH_KEY_RANGE) : searchKeys[random(searchN)];
+    }
+    searchTableBits = 1;
+    while ((1 << searchTableBits) < 2 * searchN) searchTableBits++;
+    searchStep = 0;
+    progressBegin(1, 0, 11);
+    searchTask = taskAdd("search", searchRunTask, 0, TASK_PRIO_COMPUTE, 0, TASK_GROUP_PROGRAM);
+  }
+}
+
+void handleSearchTest(unsigned long now) {
+  switch (searchState) {
+    case SEARCH_TITLE:       handleSearchTitle(now);      break;
+    case SEARCH_QUESTION:    handleSearchQuestion(now);   break;
+    case SEARCH_SELECT_SIZE: handleSearchSelectSize(now); break;
+    case SEARCH_SHOW_N:      handleSearchShowN(now);      break;
+    case SEARCH_CONFIRM_N:   handleSearchConfirmN(now);   break;
+    case SEARCH_RUNNING:     handleSearchRunning(now);    break;
+    case SEARCH_RESULTS:     handleSearchResults(now);    break;
+    case SEARCH_PAYOFF:      handleSearchPayoff(now);     break;
+  }
+}
+
+//  Search sub-handlers
+
+// State 1 – "Search Test" for 1.75 s.
+static void handleSearchTitle(unsigned long now) {
+  lcd.setCursor(0, 0);
+  lcd.print("Search Test");
+
+  if (now - stateEnteredAt >= 1750UL) {
+    enterSearchState(SEARCH_QUESTION);
+  }
+}
+
+// State 2 – "Scan, bisect or / hash: how fast?" for 2 s.
+static void handleSearchQuestion(unsigned long now) {
+  lcd.setCursor(0, 0);
+  lcd.print("Scan, bisect or");
+  lcd.setCursor(0, 1);
+  lcd.print("hash: how fast?");
+
+  if (now - stateEnteredAt >= 2000UL) {
+    enterSearchState(SEARCH_SELECT_SIZE);
+  }
+}
+
+// State 3 – "Move slider to / select data size" until the pot moves.
+static void handleSearchSelectSize(unsigned long now) {
+  lcd.setCursor(0, 0);
+  lcd.print("Move slider to");
+  lcd.setCursor(0, 1);
+  lcd.print("select data size");
+
+  if (potHasMoved) {
+    enterSearchState(SEARCH_SHOW_N);
+  }
+}
+
+// State 4 – "N = [n]" with the pot mapped to [SEARCH_MIN_N, SEARCH_MAX_N].
+// Locks in once the slider is static for 1.3 s.
+static void handleSearchShowN(unsigned long now) {
+  int n = map(potValue, 0, 1023, SEARCH_MIN_N, SEARCH_MAX_N);
+  lcd.setCursor(0, 0);
+  lcd.print("N = ");
+  lcd.print(n);
+  lcd.print("     ");  // overwrite any leftover digits
+
+  if (potHasMoved && (now - potLastMovedAt >= 1300UL)) {
+    searchN = n;
+    bootRememberParam(searchN);
+    enterSearchState(SEARCH_CONFIRM_N);
+  }
+}
+
+// State 5 – "Timing lookups / for N = [n]" for 1.3 s.
+static void handleSearchConfirmN(unsigned long now) {
+  lcd.setCursor(0, 0);
+  lcd.print("Timing lookups");
+  lcd.setCursor(0, 1);
+  lcd.print("for N = ");
+  lcd.print(searchN);
+  lcd.print("     ");
+
+  if (now - stateEnteredAt >= 1300UL) {
+    enterSearchState(SEARCH_RUNNING);
+  }
+}
+
+// State 6 – progress while searchRunTask() works through the steps.
+static void handleSearchRunning(unsigned long now) {
+  lcd.setCursor(0, 0);
+  lcd.print("Timing lookups");
+
+  progressUpdate(searchStep, SEARCH_STEPS, now - stateEnteredAt);
+}
+
+// Background task – one timing step per run: build the sorted copy, build
+// the hash table, then time each method.  A method repeats its batch until
+// SEARCH_MIN_TIME_US has passed so even the fastest gets a readable time.
+static void searchRunTask(unsigned long now) {
+  if (searchStep == 0) {
+    unsigned long t0 = micros();
+    memcpy(searchSorted, searchKeys, searchN * sizeof(uint16_t));
+    qsort(searchSorted, searchN, sizeof(uint16_t), compareKeys);
+    searchBuildSortUs = micros() - t0;
+  } else if (searchStep == 1) {
+    unsigned long t0 = micros();
+    memset(searchTable, 0xFF, sizeof(uint16_t) << searchTableBits);  // SEARCH_EMPTY
+    for (int i = 0; i < searchN; i++) hashInsert(searchKeys[i]);
+    searchBuildHashUs = micros() - t0;
+  } else {
+    int method = searchStep - 2;
+    int reps = 0;
+    unsigned long t0 = micros(), us;
+    do {
+      searchHits[method] = searchBatch(method);
+      reps++;
+      us = micros() - t0;
+    } while (us < SEARCH_MIN_TIME_US && reps < SEARCH_MAX_REPS);
+    searchNs[method] = us * 1000UL / ((unsigned long)reps * SEARCH_QUERIES);
+  }
+
+  searchStep++;
+  if (searchStep == SEARCH_STEPS) {
+    searchReport();
+    enterSearchState(SEARCH_RESULTS);
+  }
+}
+
+// Prints one line per method over Serial.
+static void searchReport() {
+  for (int m = 0; m < SEARCH_METHOD_COUNT; m++) {
+    Serial.print("search: n=");
+    Serial.print(searchN);
+    Serial.print(" method=");
+    Serial.print(SEARCH_METHOD_NAMES[m]);
+    Serial.print(" build_us=");
+    Serial.print(m == SEARCH_LINEAR ? 0UL : (m == SEARCH_HASH ? searchBuildHashUs : searchBuildSortUs));
+    Serial.print(" ns_per_lookup=");
+    Serial.print(searchNs[m]);
+    Serial.print(" hits=");
+    Serial.println(searchHits[m]);
+  }
+}
+
+// State 7 – one page per method: "Binary    85 ns" / "build  312 µs".
+static void handleSearchResults(unsigned long now) {
+  int m = (int)((now - stateEnteredAt) / SEARCH_PAGE_MS);
+  if (m >= SEARCH_METHOD_COUNT) {
+    enterSearchState(SEARCH_PAYOFF);
+    return;
+  }
+  unsigned long build = (m == SEARCH_LINEAR) ? 0 : (m == SEARCH_HASH ? searchBuildHashUs : searchBuildSortUs);
+
+  char line[32];
+  snprintf(line, sizeof(line), "%-8s%5lu ns", SEARCH_METHOD_NAMES[m], searchNs[m]);
+  lcd.setCursor(0, 0);
+  lcd.print(line);
+
+  lcd.setCursor(0, 1);
+  if (searchHits[m] != searchHits[SEARCH_LINEAR]) {
+    lcd.print("hits differ!    ");
+  } else if (m == SEARCH_LINEAR) {
+    lcd.print("no index        ");
+  } else {
+    lcd.print("build ");
+    lcd.print(build);
+    lcd.print(" ");
+    lcd.write(1);  // µ custom character
+    lcd.print("s     ");  // trailing spaces overwrite leftover digits
+  }
+}
+
+// State 8 – how many lookups it takes for sorting to beat scanning.
+static void handleSearchPayoff(unsigned long now) {
+  unsigned long saved = (searchNs[SEARCH_LINEAR] > searchNs[SEARCH_BINARY])
+                      ? searchNs[SEARCH_LINEAR] - searchNs[SEARCH_BINARY] : 0;
+  lcd.setCursor(0, 0);
+  if (saved == 0) {
+    lcd.print("Scanning wins");
+    lcd.setCursor(0, 1);
+    lcd.print("at this N");
+  } else {
+    lcd.print("Sorting pays off");
+    lcd.setCursor(0, 1);
+    lcd.print("after ");
+    lcd.print((searchBuildSortUs * 1000UL + saved - 1) / saved);
+    lcd.print(" finds");
+  }
+
+  if (now - stateEnteredAt >= 3000UL) {
+    enterAppState(1);  // APP_PROGRAM_SELECT
+  }
+}
+
+//  Registry entry (see program_registry.h)
+static void searchEnter() { enterSearchState(SEARCH_TITLE); }
+static void searchResume(long n) {
+  searchN = constrain((int)n, SEARCH_MIN_N, SEARCH_MAX_N);
+  enterSearchState(SEARCH_CONFIRM_N);
+}
+static void searchExit()  { taskCancel(searchTask); }
+
+constexpr size_t SEARCH_STATIC_BYTES =
+  sizeof(searchKeys) + sizeof(searchSorted) + sizeof(searchTable) + sizeof(searchQueries);
+static_assert(SEARCH_STATIC_BYTES <= UINT16_MAX, "SEARCH_STATIC_BYTES does not fit ProgramInfo::staticBytes");
+
+constexpr ProgramInfo SEARCH_PROGRAM = {
+  "Search", searchEnter, handleSearchTest, searchExit,
+  SEARCH_STATIC_BYTES,
+  CGRAM_PROGRESS_SLOTS,
+  searchResume
+};
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef SENSOR_STATS_H
+#define SENSOR_STATS_H
+
+#include <Arduino.h>
+
+//  Thermistor conversion and windowed statistics for the Logger program.
+//
+// thermistorTenthsF() turns a count from the Grove temperature sensor (B =
+// 4275, R0 = 100k, 10-bit ADC) into tenths of a degree Fahrenheit with one
+// table lookup and a linear interpolation, instead of a float log() per
+// sample.  THERM_TENTHS_F holds the exact value every 16 counts:
+//
+//   R = 1023 / a - 1,   T = 1 / (ln(R) / B + 1 / 298.15) - 273.15  (°C)
+//
+// with a clamped to 1..1022.  From 250 to 800 counts (38-129 °F) the
+// interpolated value is within 0.15 °F of the formula; towards the ends of
+// the range the curve bends sharply and the error grows to a few degrees.
+//
+// SensorWindow keeps the last SENSOR_WINDOW samples in a ring together with
+// their sum, sum of squares, minimum and maximum.  A push costs O(1): the
+// sums drop the sample that leaves and add the one that arrives, and the
+// minimum and maximum come from monotonic queues of sample numbers, where
+// every sample is appended once and removed at most once.
+
+#define SENSOR_WINDOW     128   // samples; a power of two
+#define THERM_STEP_SHIFT  4     // table entry every 16 counts
+
+static const int16_t THERM_TENTHS_F[(1024 >> THERM_STEP_SHIFT) + 1] = {
+   -979, -433, -267, -161,  -82,  -18,   37,   86,  129,  169,  206,  240,  272,
+    303,  333,  361,  388,  415,  441,  466,  491,  515,  539,  563,  586,  609,
+    632,  655,  678,  701,  724,  747,  771,  794,  818,  842,  867,  891,  917,
+    943,  969,  997, 1025, 1054, 1084, 1115, 1147, 1181, 1217, 1255, 1295, 1338,
+   1384, 1434, 1488, 1549, 1617, 1694, 1784, 1893, 2029, 2210, 2481, 2999, 5789
+};
+
+static int16_t thermistorTenthsF(int adc) {
+  if (adc < 0)    adc = 0;
+  if (adc > 1023) adc = 1023;
+  int i  = adc >> THERM_STEP_SHIFT;
+  int f  = adc & ((1 << THERM_STEP_SHIFT) - 1);
+  int lo = THERM_TENTHS_F[i];
+  return (int16_t)(lo + ((THERM_TENTHS_F[i + 1] - lo) * f >> THERM_STEP_SHIFT));
+}
+
+struct SensorWindow {
+  int16_t  ring[SENSOR_WINDOW];
+  uint16_t minQ[SENSOR_WINDOW];   // sample numbers, values increasing from the head
+  uint16_t maxQ[SENSOR_WINDOW];   // sample numbers, values decreasing from the head
+  uint16_t minHead, minTail;      // free-running; masked on use
+  uint16_t maxHead, maxTail;
+  uint32_t count;                 // samples pushed since the last reset
+  int32_t  sum;                   // over the window
+  int64_t  sumSq;
+};
+
+#define SENSOR_MASK (SENSOR_WINDOW - 1)
+
+static void sensorReset(SensorWindow* w) {
+  w->minHead = w->minTail = 0;
+  w->maxHead = w->maxTail = 0;
+  w->count   = 0;
+  w->sum     = 0;
+  w->sumSq   = 0;
+}
+
+static void sensorPush(SensorWindow* w, int16_t v) {
+  uint16_t seq = (uint16_t)w->count;
+
+  //  Sample seq - SENSOR_WINDOW leaves the window
+  if (w->count >= SENSOR_WINDOW) {
+    int32_t old = w->ring[seq & SENSOR_MASK];
+    w->sum   -= old;
+    w->sumSq -= old * old;
+  }
+  if (w->minHead != w->minTail && (uint16_t)(seq - w->minQ[w->minHead & SENSOR_MASK]) >= SENSOR_WINDOW) w->minHead++;
+  if (w->maxHead != w->maxTail && (uint16_t)(seq - w->maxQ[w->maxHead & SENSOR_MASK]) >= SENSOR_WINDOW) w->maxHead++;
+
+  w->ring[seq & SENSOR_MASK] = v;
+  w->sum   += v;
+  w->sumSq += (int32_t)v * v;
+  w->count++;
+
+  //  Samples that can no longer be the minimum (maximum) leave the queue
+  while (w->minTail != w->minHead && w->ring[w->minQ[(w->minTail - 1) & SENSOR_MASK] & SENSOR_MASK] >= v) w->minTail--;
+  w->minQ[w->minTail++ & SENSOR_MASK] = seq;
+  while (w->maxTail != w->maxHead && w->ring[w->maxQ[(w->maxTail - 1) & SENSOR_MASK] & SENSOR_MASK] <= v) w->maxTail--;
+  w->maxQ[w->maxTail++ & SENSOR_MASK] = seq;
+}
+
+//  Window queries (valid once at least one sample has been pushed)
+static int sensorCount(const SensorWindow* w) {
+  return w->count < SENSOR_WINDOW ? (int)w->count : SENSOR_WINDOW;
+}
+
+// The i-th oldest sample in the window.
+static int16_t sensorAt(const SensorWindow* w, int i) {
+  return w->ring[(uint16_t)(w->count - sensorCount(w) + i) & SENSOR_MASK];
+}
+
+static int16_t sensorMin(const SensorWindow* w) {
+  return w->ring[w->minQ[w->minHead & SENSOR_MASK] & SENSOR_MASK];
+}
+
+static int16_t sensorMax(const SensorWindow* w) {
+  return w->ring[w->maxQ[w->maxHead & SENSOR_MASK] & SENSOR_MASK];
+}
+
+// Mean and variance in the sample unit (and its square), from the sums.
+static float sensorMean(const SensorWindow* w) {
+  return (float)w->sum / sensorCount(w);
+}
+
+static float sensorVariance(const SensorWindow* w) {
+  int64_t n = sensorCount(w);
+  int64_t spread = n * w->sumSq - (int64_t)w->sum * w->sum;   // n² · variance, exact
+  return (float)spread / (float)(n * n);
+}
+
+#endif
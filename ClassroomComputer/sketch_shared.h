@@ -0,0 +1,55 @@
+#ifndef SKETCH_SHARED_H
+#define SKETCH_SHARED_H
+
+#include <Arduino.h>
+#include "counting_lcd.h"
+
+//  Shared state and helpers defined in the main sketch
+// Every program header includes this instead of declaring its own externs.
+
+//  Hardware
+extern CountingLcd lcd;
+extern const int BUZZER_PIN;
+extern const int TEMP_PIN;
+
+//  Backlight
+extern const byte COL_PINK[3];
+extern const byte COL_GREEN[3];
+extern void setBacklight(const byte* col);
+
+//  Timing and frame rate
+extern unsigned long stateEnteredAt;
+extern const unsigned long UI_FRAME_MS;
+extern void setUiFrameMs(unsigned long ms);  // redraw period of the current screen
+
+//  Potentiometer
+extern int  potValue;
+extern int  potValuePrev;
+extern int  potFiltered;
+extern int  remappedPotValue;
+extern bool potHasMoved;
+extern unsigned long potLastMovedAt;
+extern unsigned long potSampledAt;
+extern unsigned long potPrevSampledAt;
+extern void samplePot(unsigned long now);
+
+//  Scrolling
+extern int scrollSpeed;
+extern int scrollOffset;
+extern unsigned long scrollTickAt;
+extern const unsigned long SCROLL_START_DELAY;
+extern void tickScroll(const char* str, uint8_t row, unsigned long now, int wrapGap, bool loop);
+
+//  Celebration jingle (the animation is in anim_timeline.h)
+extern void tickCelebrationSound(unsigned long now);
+
+//  Progress bar (CGRAM slots 4-7)
+extern void progressBegin(uint8_t row, uint8_t col, uint8_t cells);
+extern void progressUpdate(unsigned long done, unsigned long total, unsigned long elapsedMs);
+
+//  Top-level state; 1 = program select
+extern void enterAppState(int nextState);
+extern bool enterProgramNamed(const char* name);  // false if no program has that label
+extern void bootRememberParam(long param);        // the running program's setting, for resume
+
+#endif
@@ -2,6 +2,11 @@
 #define SORT_PROGRAM_H
 
 #include <Arduino.h>
+#include "kv_store.h"
+#include "task_scheduler.h"
+#include "sketch_shared.h"
+#include "program_registry.h"
+#include "anim_timeline.h"
 
 //  Sort Test program states
 enum SortTestState {
@@ -10,7 +15,7 @@ enum SortTestState {
   SORT_SELECT_SIZE,  // "Move slider to select problem size"
   SORT_SHOW_N,       // "N = [n]" until slider static for 0.75 s
   SORT_CONFIRM_N,    // "Starting sort for / N = [n]" for 1 s
-  SORT_RUNNING,      // "Bubble = TBD us… / Merge = TBD us…"
+  SORT_RUNNING,      // "Bubble sorting / [progress] ETA"
   SORT_RESULTS,      // results for 2.5 s
   SORT_WINNER        // "Merge sort is / the winner! X" for 2 s
 };
@@ -23,16 +28,38 @@ static unsigned long mergeDuration  = 0;     // µs
 static int           sortBuf[500];           // scratch buffer (max N = 500)
 static int           mergeTmp[500];          // merge sort temp buffer
 
+//  Bubble sort in progress (a background task while SORT_RUNNING)
+static const unsigned long SORT_SLICE_MICROS = 8000UL;
+static int           bubblePass = 0;         // outer-loop passes completed
+static int           sortTask   = -1;        // scheduler handle of the sort
+
+//  The latest timings for each N persist in the KV store under
+// KV_KEY(KV_NS_SORT, N)
+struct SortRecord {
+  uint32_t bubbleUs;
+  uint32_t mergeUs;
+};
+
 //  Forward declarations (need to be visible to other modules)
 // These are declared here but implemented below, and called from the main sketch
 void enterSortState(SortTestState next);
 void handleSortTest(unsigned long now);
 
 //  Sort algorithm helpers
+// One outer-loop pass of bubble sort (pass i bubbles the largest of the first
+// n - i elements to the end).
+static void bubblePassStep(int* a, int n, int i) {
+  for (int j = 0; j < n - 1 - i; j++)
+    if (a[j] > a[j+1]) { int t = a[j]; a[j] = a[j+1]; a[j+1] = t; }
+}
+
 static void bubbleSort(int* a, int n) {
-  for (int i = 0; i < n - 1; i++)
-    for (int j = 0; j < n - 1 - i; j++)
-      if (a[j] > a[j+1]) { int t = a[j]; a[j] = a[j+1]; a[j+1] = t; }
+  for (int i = 0; i < n - 1; i++) bubblePassStep(a, n, i);
+}
+
+// Comparisons made by the first `passes` passes of a bubble sort on n items.
+static unsigned long bubbleComparisons(int n, int passes) {
+  return (unsigned long)passes * (n - 1) - (unsigned long)passes * (passes - 1) / 2;
 }
 
 static void mergeSortHelper(int* a, int* tmp, int n) {
@@ -56,44 +83,29 @@ static void handleSortConfirmN(unsigned long now);
 static void handleSortRunning(unsigned long now);
 static void handleSortResults(unsigned long now);
 static void handleSortWinner(unsigned long now);
+static void sortRunTask(unsigned long now);
 
 //  Implementations
 
-// External references to shared state (defined in main sketch)
-extern rgb_lcd lcd;
-extern const byte COL_PINK[3];
-extern const byte COL_GREEN[3];
-extern unsigned long stateEnteredAt;
-extern int scrollOffset;
-extern unsigned long scrollTickAt;
-extern bool potHasMoved;
-extern int potValue;
-extern int remappedPotValue;
-extern unsigned long potLastMovedAt;
-extern byte celebFrame0[8];
-extern byte celebFrame1[8];
-extern byte celebFrame2[8];
-extern byte celebFrame3[8];
-extern byte celebFrame4[8];
-extern byte celebFrame5[8];
-extern byte celebFrame6[8];
-extern byte celebFrame7[8];
-extern const int CELEB_FRAME_COUNT;
-extern int celebFrameIdx;
-extern unsigned long celebTickAt;
-extern const int BUZZER_PIN;
-extern void tickCelebrationSound(unsigned long now);
-extern void enterAppState(int nextState);  // forward declaration; APP_PROGRAM_SELECT = 1
-
 void enterSortState(SortTestState next) {
   sortState      = next;
   stateEnteredAt = millis();
   scrollOffset   = 0;
   scrollTickAt   = millis();
   potHasMoved    = false;
-  if (next == SORT_RUNNING) lcd.setRGB(COL_GREEN[0], COL_GREEN[1], COL_GREEN[2]);
-  else                      lcd.setRGB(COL_PINK[0],  COL_PINK[1],  COL_PINK[2]);
+  if (next == SORT_RUNNING) setBacklight(COL_GREEN);
+  else                      setBacklight(COL_PINK);
   lcd.clear();
+  if (next == SORT_WINNER) animPlay(&CELEB_GLYPH_CLIP, 12, 1);
+
+  taskCancel(sortTask);
+  if (next == SORT_RUNNING) {
+    for (int i = 0; i < confirmedN; i++) sortBuf[i] = random(10000);
+    bubblePass     = 0;
+    bubbleDuration = 0;
+    progressBegin(1, 0, 11);
+    sortTask = taskAdd("sort", sortRunTask, 0, TASK_PRIO_COMPUTE, SORT_SLICE_MICROS, TASK_GROUP_PROGRAM);
+  }
 }
 
 void handleSortTest(unsigned long now) {
@@ -158,6 +170,7 @@ static void handleSortShowN(unsigned long now) {
 
   if (potHasMoved && (now - potLastMovedAt >= 1300UL)) {
     confirmedN = remappedPotValue;
+    bootRememberParam(confirmedN);
     enterSortState(SORT_CONFIRM_N);
   }
 }
@@ -177,31 +190,41 @@ static void handleSortConfirmN(unsigned long now) {
   }
 }
 
-// State 6 – "Bubble = X µs... / Merge = Y µs..." while computing.
-// Blocks while running both sorts, then transitions immediately.
+// State 6 – "Bubble sorting / [progress] ETA" while computing.
+// The sort itself is sortRunTask(); this only redraws the progress.
 static void handleSortRunning(unsigned long now) {
   lcd.setCursor(0, 0);
-  lcd.print("Bubble = X ");
-  lcd.write(1);  // µ custom character
-  lcd.print("s...");
-  lcd.setCursor(0, 1);
-  lcd.print("Merge = Y ");
-  lcd.write(1);  // µ custom character
-  lcd.print("s...");
+  lcd.print("Bubble sorting");
+
+  progressUpdate(bubbleComparisons(confirmedN, bubblePass),
+                 bubbleComparisons(confirmedN, confirmedN - 1), now - stateEnteredAt);
+}
 
-  // Bubble sort on a fresh random array
-  for (int i = 0; i < confirmedN; i++) sortBuf[i] = random(10000);
+// Background task – a few bubble passes per run (at most SORT_SLICE_MICROS);
+// bubbleDuration sums only the time spent inside those passes.  Merge sort is
+// quick enough to run in one go once bubble sort has finished.
+static void sortRunTask(unsigned long now) {
   unsigned long t0 = micros();
-  bubbleSort(sortBuf, confirmedN);
-  bubbleDuration = micros() - t0;
+  unsigned long t1 = t0;
+  while (bubblePass < confirmedN - 1 && taskHasBudget()) {
+    bubblePassStep(sortBuf, confirmedN, bubblePass);
+    bubblePass++;
+    t1 = micros();
+  }
+  bubbleDuration += t1 - t0;
 
-  // Merge sort on a fresh random array
-  for (int i = 0; i < confirmedN; i++) sortBuf[i] = random(10000);
-  t0 = micros();
-  mergeSortHelper(sortBuf, mergeTmp, confirmedN);
-  mergeDuration = micros() - t0;
+  if (bubblePass >= confirmedN - 1) {
+    // Merge sort on a fresh random array
+    for (int i = 0; i < confirmedN; i++) sortBuf[i] = random(10000);
+    t0 = micros();
+    mergeSortHelper(sortBuf, mergeTmp, confirmedN);
+    mergeDuration = micros() - t0;
 
-  enterSortState(SORT_RESULTS);
+    SortRecord rec = { (uint32_t)bubbleDuration, (uint32_t)mergeDuration };
+    kvPut(KV_KEY(KV_NS_SORT, confirmedN), &rec, sizeof(rec));
+
+    enterSortState(SORT_RESULTS);
+  }
 }
 
 // State 7 – "Bubble = [time] µs / Merge  = [time] µs" for 3.5 s.
@@ -227,32 +250,17 @@ static void handleSortResults(unsigned long now) {
 }
 
 // State 8 – "Merge sort is / the winner! X" for 3.6 s.
-// Static text with pulsing diamond animation at end of bottom line.
+// Static text; the celebration at col 12, row 1 is played by enterSortState.
 static void handleSortWinner(unsigned long now) {
-  // Write static text once on entry; also reset animation
-  if (celebTickAt < stateEnteredAt) {
-    celebFrameIdx = 0;
-    lcd.createChar(0, celebFrame0);
+  static unsigned long drawnFor = 0;   // stateEnteredAt of the last draw
+  if (drawnFor != stateEnteredAt) {
+    drawnFor = stateEnteredAt;
     lcd.setCursor(0, 0);
     lcd.print("Merge sort is");
     lcd.setCursor(0, 1);
     lcd.print("the winner! ");
-    celebTickAt = stateEnteredAt + 200UL;
   }
 
-  // Advance animation frame on each tick
-  if (now >= celebTickAt) {
-    celebFrameIdx = (celebFrameIdx + 1) % CELEB_FRAME_COUNT;
-    byte* frames[8] = {celebFrame0, celebFrame1, celebFrame2, celebFrame3,
-                        celebFrame4, celebFrame5, celebFrame6, celebFrame7};
-    lcd.createChar(0, frames[celebFrameIdx]);
-    celebTickAt = now + 200UL;
-  }
-
-  // Redraw animated char at col 12, row 1 (createChar moves the cursor)
-  lcd.setCursor(12, 1);
-  lcd.write((uint8_t)0);
-
   // Celebration jingle
   tickCelebrationSound(now);
 
@@ -261,4 +269,25 @@ static void handleSortWinner(unsigned long now) {
   }
 }
 
+// True while a run is using sortBuf and mergeTmp (the Serial sweeps wait).
+static bool sortRunning() { return taskSlot(sortTask) >= 0; }
+
+//  Registry entry (see program_registry.h)
+static void sortEnter() { enterSortState(SORT_TITLE); }
+static void sortExit()  { taskCancel(sortTask); }
+static void sortResume(long n) {
+  confirmedN = constrain((int)n, 10, 350);
+  enterSortState(SORT_CONFIRM_N);
+}
+
+constexpr size_t SORT_STATIC_BYTES = sizeof(sortBuf) + sizeof(mergeTmp);
+static_assert(SORT_STATIC_BYTES <= UINT16_MAX, "SORT_STATIC_BYTES does not fit ProgramInfo::staticBytes");
+
+constexpr ProgramInfo SORT_PROGRAM = {
+  "Sort", sortEnter, handleSortTest, sortExit,
+  SORT_STATIC_BYTES,
+  CGRAM_CELEBRATION | CGRAM_PROGRESS_SLOTS,
+  sortResume
+};
+
 #endif
@@ -0,0 +1,208 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+
+//  Cooperative task scheduler
+// loop() hands control to taskRunDue(), which runs every task that is due,
+// highest priority first and, within a priority, earliest deadline first.
+// Each task runs at most once per pass and must return promptly:
+//
+//   periodic   – released every periodMs; its deadline is the next release
+//   one-shot   – released once after delayMs, then freed
+//   background – periodMs = 0; released on every pass (long computations)
+//
+// A task that loops (trial division, bubble passes, bignum steps) checks
+// taskHasBudget() and returns once its budget is spent, so input, display and
+// audio keep their rates however long the job runs.  Starting after the
+// deadline counts as late; running past the budget counts as an overrun.
+//
+// Tasks in TASK_GROUP_PROGRAM belong to the running program and are all
+// cancelled when the sketch changes program.  Handles carry a generation
+// count, so cancelling a task that has already finished is harmless.
+
+#define TASK_MAX              10
+#define TASK_ONESHOT_SLACK_MS 5     // one-shot deadline after its release
+
+enum TaskPriority {
+  TASK_PRIO_COMPUTE = 0,
+  TASK_PRIO_SERIAL  = 1,
+  TASK_PRIO_UI      = 2,
+  TASK_PRIO_INPUT   = 3,
+  TASK_PRIO_AUDIO   = 4
+};
+
+enum TaskGroup { TASK_GROUP_SYSTEM, TASK_GROUP_PROGRAM };
+
+typedef void (*TaskFn)(unsigned long now);
+
+struct Task {
+  const char*   name;
+  TaskFn        fn;
+  unsigned long periodMs;   // 0 = background (or unused for one-shots)
+  unsigned long dueAt;      // millis() of the next release
+  unsigned long budgetUs;   // slice for taskHasBudget(); 0 = unlimited
+  uint8_t       priority;
+  uint8_t       group;
+  uint8_t       gen;        // bumped whenever the slot is freed
+  bool          active;
+  bool          oneShot;
+  //  Stats
+  unsigned long runs;
+  unsigned long late;
+  unsigned long overruns;
+  unsigned long maxUs;
+};
+
+static Task          tasks[TASK_MAX];
+static int           taskCurrent   = -1;   // slot of the running task
+static unsigned long taskStartedUs = 0;
+
+// Handle = generation << 8 | slot, so stale handles never match a reused slot.
+static int taskHandle(int slot) { return ((int)tasks[slot].gen << 8) | slot; }
+
+static int taskSlot(int handle) {
+  if (handle < 0) return -1;
+  int slot = handle & 0xFF;
+  if (slot >= TASK_MAX || !tasks[slot].active || tasks[slot].gen != (uint8_t)(handle >> 8)) return -1;
+  return slot;
+}
+
+static int taskAlloc(const char* name, TaskFn fn, uint8_t priority, unsigned long budgetUs, uint8_t group) {
+  for (int i = 0; i < TASK_MAX; i++) {
+    if (tasks[i].active) continue;
+    uint8_t gen = tasks[i].gen;
+    memset(&tasks[i], 0, sizeof(Task));
+    tasks[i].name     = name;
+    tasks[i].fn       = fn;
+    tasks[i].priority = priority;
+    tasks[i].budgetUs = budgetUs;
+    tasks[i].group    = group;
+    tasks[i].gen      = gen;
+    tasks[i].active   = true;
+    tasks[i].dueAt    = millis();
+    return i;
+  }
+  return -1;
+}
+
+// Periodic task (periodMs = 0: background), first released right away.
+// Returns a handle, or -1 if the table is full.
+static int taskAdd(const char* name, TaskFn fn, unsigned long periodMs, uint8_t priority,
+                   unsigned long budgetUs = 0, uint8_t group = TASK_GROUP_SYSTEM) {
+  int slot = taskAlloc(name, fn, priority, budgetUs, group);
+  if (slot < 0) return -1;
+  tasks[slot].periodMs = periodMs;
+  return taskHandle(slot);
+}
+
+// One-shot task released delayMs from now.
+static int taskAddOnce(const char* name, TaskFn fn, unsigned long delayMs, uint8_t priority,
+                       uint8_t group = TASK_GROUP_PROGRAM) {
+  int slot = taskAlloc(name, fn, priority, 0, group);
+  if (slot < 0) return -1;
+  tasks[slot].oneShot = true;
+  tasks[slot].dueAt  += delayMs;
+  return taskHandle(slot);
+}
+
+static void taskFree(int slot) {
+  tasks[slot].active = false;
+  tasks[slot].gen++;
+}
+
+static void taskCancel(int handle) {
+  int slot = taskSlot(handle);
+  if (slot >= 0) taskFree(slot);
+}
+
+static void taskCancelGroup(uint8_t group) {
+  for (int i = 0; i < TASK_MAX; i++) {
+    if (tasks[i].active && tasks[i].group == group) taskFree(i);
+  }
+}
+
+// Changes a periodic task's period from its next release on.
+static void taskSetPeriod(int handle, unsigned long periodMs) {
+  int slot = taskSlot(handle);
+  if (slot < 0 || tasks[slot].periodMs == periodMs) return;
+  tasks[slot].periodMs = periodMs;
+  if (slot != taskCurrent) tasks[slot].dueAt = millis();
+}
+
+// True while the running task is inside its budget.
+static bool taskHasBudget() {
+  if (taskCurrent < 0 || tasks[taskCurrent].budgetUs == 0) return true;
+  return micros() - taskStartedUs < tasks[taskCurrent].budgetUs;
+}
+
+// True while a background task (a long computation) is registered.
+static bool taskHasBackground() {
+  for (int i = 0; i < TASK_MAX; i++) {
+    if (tasks[i].active && !tasks[i].oneShot && tasks[i].periodMs == 0) return true;
+  }
+  return false;
+}
+
+static bool taskIsDue(const Task& t, unsigned long now) {
+  return t.active && (long)(now - t.dueAt) >= 0;
+}
+
+static unsigned long taskDeadline(const Task& t) {
+  if (t.oneShot)       return t.dueAt + TASK_ONESHOT_SLACK_MS;
+  if (t.periodMs == 0) return t.dueAt + 0x7FFFFFFFUL;  // background: no deadline
+  return t.dueAt + t.periodMs;
+}
+
+//  Dispatcher
+// Runs one pass over the due tasks.  Returns the ms until the next release,
+// or 0 if something is already due (a background task always is), so loop()
+// knows how long it may sleep.
+static unsigned long taskRunDue(unsigned long now) {
+  uint16_t ran = 0;
+  for (;;) {
+    // Highest priority, then earliest deadline, among due tasks not yet run
+    int best = -1;
+    for (int i = 0; i < TASK_MAX; i++) {
+      if ((ran & (1u << i)) || !taskIsDue(tasks[i], now)) continue;
+      if (best < 0 || tasks[i].priority > tasks[best].priority ||
+          (tasks[i].priority == tasks[best].priority &&
+           (long)(taskDeadline(tasks[i]) - taskDeadline(tasks[best])) < 0)) best = i;
+    }
+    if (best < 0) break;
+    ran |= 1u << best;
+
+    Task& t = tasks[best];
+    if ((long)(now - taskDeadline(t)) > 0) t.late++;
+    uint8_t gen = t.gen;
+    taskCurrent   = best;
+    taskStartedUs = micros();
+    t.fn(now);
+    unsigned long us = micros() - taskStartedUs;
+    taskCurrent = -1;
+    now = millis();
+
+    if (!t.active || t.gen != gen) continue;  // cancelled itself
+    t.runs++;
+    if (us > t.maxUs) t.maxUs = us;
+    if (t.budgetUs && us > t.budgetUs) t.overruns++;
+    if (t.oneShot) {
+      taskFree(best);
+    } else if (t.periodMs > 0) {
+      t.dueAt += t.periodMs;
+      if ((long)(now - t.dueAt) >= 0) t.dueAt = now + t.periodMs;  // fell behind: skip
+    } else {
+      t.dueAt = now;
+    }
+  }
+
+  unsigned long wait = 0xFFFFFFFFUL;
+  for (int i = 0; i < TASK_MAX; i++) {
+    if (!tasks[i].active) continue;
+    if (taskIsDue(tasks[i], now)) return 0;
+    if (tasks[i].dueAt - now < wait) wait = tasks[i].dueAt - now;
+  }
+  return wait;
+}
+
+#endif
@@ -0,0 +1,272 @@
+#ifndef VM_H
+#define VM_H
+
+#include <stdint.h>
+#include <string.h>
+
+//  Bytecode virtual machine
+// A small stack machine for programs uploaded at run time.  Values are
+// 32-bit signed integers on a fixed operand stack; CALL/RET use a separate
+// return stack; LOAD/STORE address VM_VARS variables.  Multi-byte operands
+// are little-endian and jump targets are absolute code offsets.
+//
+//   HALT                     stop
+//   PUSH8 b / PUSH16 w / PUSH32 d   push a sign-extended constant
+//   DUP DROP SWAP OVER       stack shuffles
+//   ADD SUB MUL DIV MOD NEG  arithmetic (DIV/MOD by zero is an error)
+//   AND OR XOR SHL SHR NOT   bitwise; NOT is logical (0 -> 1, else 0)
+//   EQ LT GT                 comparisons, push 1 or 0
+//   JMP a / JZ a / JNZ a     jumps; JZ/JNZ pop the condition
+//   LOAD v / STORE v         variable v (one byte)
+//   CALL a / RET             subroutines
+//   SYS n                    syscall n, handled by the host (LCD, pot, ...)
+//
+// vmRun() executes at most `budget` instructions and returns, so the caller
+// can run a program in slices between other work.  Dispatch is threaded
+// (computed goto: every handler jumps straight to the next one) where the
+// compiler supports it; build with VM_COMPUTED_GOTO 0 to compare against a
+// plain switch.  Every stack, variable, jump and opcode access is checked,
+// so a faulty program stops with an error instead of corrupting memory.
+//
+// This header has no Arduino dependencies, so it also builds on a host.
+
+#ifndef VM_COMPUTED_GOTO
+#ifdef __GNUC__
+#define VM_COMPUTED_GOTO 1
+#else
+#define VM_COMPUTED_GOTO 0
+#endif
+#endif
+
+#define VM_STACK      32
+#define VM_RSTACK     8
+#define VM_VARS       32
+#define VM_CODE_PAD   4     // zero bytes after the code, so operand reads stay in bounds
+
+#define VM_OPCODES(X) \
+  X(HALT) X(PUSH8) X(PUSH16) X(PUSH32) X(DUP) X(DROP) X(SWAP) X(OVER) \
+  X(ADD) X(SUB) X(MUL) X(DIV) X(MOD) X(NEG) X(AND) X(OR) X(XOR) X(SHL) X(SHR) X(NOT) \
+  X(EQ) X(LT) X(GT) X(JMP) X(JZ) X(JNZ) X(LOAD) X(STORE) X(CALL) X(RET) X(SYS)
+
+enum VmOp {
+#define VM_ENUM_OP(name) VM_##name,
+  VM_OPCODES(VM_ENUM_OP)
+#undef VM_ENUM_OP
+  VM_OP_COUNT
+};
+
+enum VmStatus { VM_RUNNING, VM_HALTED, VM_FAILED };
+
+enum VmError {
+  VM_OK,
+  VM_ERR_OPCODE,     // unknown opcode
+  VM_ERR_STACK,      // operand stack over- or underflow
+  VM_ERR_RSTACK,     // CALL too deep or RET without CALL
+  VM_ERR_DIVZERO,
+  VM_ERR_PC,         // ran off the end of the code or jumped outside it
+  VM_ERR_VAR,        // variable index out of range
+  VM_ERR_SYSCALL     // unknown syscall or bad syscall arguments
+};
+
+//  Syscall results
+enum VmSysResult { VM_CONTINUE, VM_YIELD, VM_BAD_SYSCALL };
+
+struct Vm;
+typedef VmSysResult (*VmSyscallFn)(Vm* vm, uint8_t n);
+
+struct Vm {
+  const uint8_t* code;      // followed by VM_CODE_PAD zero bytes
+  uint16_t       len;
+  uint16_t       pc;
+  uint8_t        sp;        // operand stack depth
+  uint8_t        rsp;       // return stack depth
+  VmStatus       status;
+  VmError        error;
+  uint16_t       errorPc;   // offset of the failing instruction
+  uint32_t       executed;  // instructions since vmReset()
+  VmSyscallFn    syscall;
+  int32_t        stack[VM_STACK];
+  uint16_t       rstack[VM_RSTACK];
+  int32_t        vars[VM_VARS];
+};
+
+static const char* const VM_ERROR_NAMES[] = {
+  "ok", "bad opcode", "stack", "call depth", "div by zero", "bad address", "bad variable", "bad syscall"
+};
+
+static void vmReset(Vm* vm, const uint8_t* code, uint16_t len, VmSyscallFn syscall) {
+  memset(vm, 0, sizeof(Vm));
+  vm->code    = code;
+  vm->len     = len;
+  vm->syscall = syscall;
+  vm->status  = VM_RUNNING;
+}
+
+//  Stack helpers for syscalls (the interpreter keeps sp in a register and
+// writes it back before every syscall)
+static bool vmPop(Vm* vm, int32_t* v) {
+  if (vm->sp == 0) return false;
+  *v = vm->stack[--vm->sp];
+  return true;
+}
+
+static bool vmPush(Vm* vm, int32_t v) {
+  if (vm->sp >= VM_STACK) return false;
+  vm->stack[vm->sp++] = v;
+  return true;
+}
+
+// Runs up to budget instructions (fewer if the program halts, fails or a
+// syscall yields).  Returns the number executed.
+static uint32_t vmRun(Vm* vm, uint32_t budget) {
+  if (vm->status != VM_RUNNING) return 0;
+
+  const uint8_t* code = vm->code;
+  const uint16_t len  = vm->len;
+  int32_t*       s    = vm->stack;
+  uint16_t       pc   = vm->pc;
+  uint16_t       opPc = pc;
+  uint8_t        sp   = vm->sp;
+  uint32_t       left = budget;
+  VmError        err  = VM_OK;
+  uint8_t        op;
+  int32_t        a, b;
+  uint16_t       target;
+
+#define VM_FETCH() do {                                          \
+    if (left == 0) goto slice_done;                              \
+    if (pc >= len) { err = VM_ERR_PC; goto fail; }               \
+    left--;                                                      \
+    opPc = pc;                                                   \
+    op   = code[pc++];                                           \
+    if (op >= VM_OP_COUNT) { err = VM_ERR_OPCODE; goto fail; }   \
+  } while (0)
+#define VM_NEED(n)  do { if (sp < (n)) { err = VM_ERR_STACK; goto fail; } } while (0)
+#define VM_ROOM(n)  do { if (sp + (n) > VM_STACK) { err = VM_ERR_STACK; goto fail; } } while (0)
+#define VM_U16()    ((uint16_t)(code[pc] | (code[pc + 1] << 8)))
+#define VM_BINARY(expr) VM_NEED(2); b = s[--sp]; a = s[sp - 1]; s[sp - 1] = (expr); VM_NEXT
+
+#if VM_COMPUTED_GOTO
+  static const void* const labels[VM_OP_COUNT] = {
+#define VM_LABEL_OP(name) &&op_##name,
+    VM_OPCODES(VM_LABEL_OP)
+#undef VM_LABEL_OP
+  };
+#define VM_OP(name) op_##name:
+#define VM_NEXT     do { VM_FETCH(); goto *labels[op]; } while (0)
+  VM_NEXT;
+#else
+#define VM_OP(name) case VM_##name:
+#define VM_NEXT     goto next
+next:
+  VM_FETCH();
+  switch (op) {
+#endif
+
+  VM_OP(HALT)   vm->status = VM_HALTED; goto slice_done;
+  VM_OP(PUSH8)  VM_ROOM(1); s[sp++] = (int8_t)code[pc]; pc += 1; VM_NEXT;
+  VM_OP(PUSH16) VM_ROOM(1); s[sp++] = (int16_t)VM_U16(); pc += 2; VM_NEXT;
+  VM_OP(PUSH32)
+    VM_ROOM(1);
+    s[sp++] = (int32_t)((uint32_t)code[pc] | ((uint32_t)code[pc + 1] << 8) |
+                        ((uint32_t)code[pc + 2] << 16) | ((uint32_t)code[pc + 3] << 24));
+    pc += 4;
+    VM_NEXT;
+  VM_OP(DUP)    VM_NEED(1); VM_ROOM(1); s[sp] = s[sp - 1]; sp++; VM_NEXT;
+  VM_OP(DROP)   VM_NEED(1); sp--; VM_NEXT;
+  VM_OP(SWAP)   VM_NEED(2); a = s[sp - 1]; s[sp - 1] = s[sp - 2]; s[sp - 2] = a; VM_NEXT;
+  VM_OP(OVER)   VM_NEED(2); VM_ROOM(1); s[sp] = s[sp - 2]; sp++; VM_NEXT;
+  VM_OP(ADD)    VM_BINARY((int32_t)((uint32_t)a + (uint32_t)b));
+  VM_OP(SUB)    VM_BINARY((int32_t)((uint32_t)a - (uint32_t)b));
+  VM_OP(MUL)    VM_BINARY((int32_t)((uint32_t)a * (uint32_t)b));
+  VM_OP(DIV)
+    VM_NEED(2);
+    if (s[sp - 1] == 0) { err = VM_ERR_DIVZERO; goto fail; }
+    VM_BINARY((a == INT32_MIN && b == -1) ? a : a / b);
+  VM_OP(MOD)
+    VM_NEED(2);
+    if (s[sp - 1] == 0) { err = VM_ERR_DIVZERO; goto fail; }
+    VM_BINARY((b == -1) ? 0 : a % b);
+  VM_OP(NEG)    VM_NEED(1); s[sp - 1] = (int32_t)(0u - (uint32_t)s[sp - 1]); VM_NEXT;
+  VM_OP(AND)    VM_BINARY(a & b);
+  VM_OP(OR)     VM_BINARY(a | b);
+  VM_OP(XOR)    VM_BINARY(a ^ b);
+  VM_OP(SHL)    VM_BINARY((int32_t)((uint32_t)a << (b & 31)));
+  VM_OP(SHR)    VM_BINARY(a >> (b & 31));
+  VM_OP(NOT)    VM_NEED(1); s[sp - 1] = !s[sp - 1]; VM_NEXT;
+  VM_OP(EQ)     VM_BINARY(a == b);
+  VM_OP(LT)     VM_BINARY(a < b);
+  VM_OP(GT)     VM_BINARY(a > b);
+  VM_OP(JMP)
+    target = VM_U16();
+    if (target >= len) { err = VM_ERR_PC; goto fail; }
+    pc = target;
+    VM_NEXT;
+  VM_OP(JZ)
+    VM_NEED(1);
+    target = VM_U16();
+    if (target >= len) { err = VM_ERR_PC; goto fail; }
+    pc = (s[--sp] == 0) ? target : pc + 2;
+    VM_NEXT;
+  VM_OP(JNZ)
+    VM_NEED(1);
+    target = VM_U16();
+    if (target >= len) { err = VM_ERR_PC; goto fail; }
+    pc = (s[--sp] != 0) ? target : pc + 2;
+    VM_NEXT;
+  VM_OP(LOAD)
+    if (code[pc] >= VM_VARS) { err = VM_ERR_VAR; goto fail; }
+    VM_ROOM(1);
+    s[sp++] = vm->vars[code[pc++]];
+    VM_NEXT;
+  VM_OP(STORE)
+    if (code[pc] >= VM_VARS) { err = VM_ERR_VAR; goto fail; }
+    VM_NEED(1);
+    vm->vars[code[pc++]] = s[--sp];
+    VM_NEXT;
+  VM_OP(CALL)
+    target = VM_U16();
+    if (target >= len) { err = VM_ERR_PC; goto fail; }
+    if (vm->rsp >= VM_RSTACK) { err = VM_ERR_RSTACK; goto fail; }
+    vm->rstack[vm->rsp++] = pc + 2;
+    pc = target;
+    VM_NEXT;
+  VM_OP(RET)
+    if (vm->rsp == 0) { err = VM_ERR_RSTACK; goto fail; }
+    pc = vm->rstack[--vm->rsp];
+    VM_NEXT;
+  VM_OP(SYS) {
+    uint8_t n = code[pc++];
+    vm->pc = pc;
+    vm->sp = sp;
+    VmSysResult r = vm->syscall ? vm->syscall(vm, n) : VM_BAD_SYSCALL;
+    sp = vm->sp;
+    if (r == VM_BAD_SYSCALL) { err = VM_ERR_SYSCALL; goto fail; }
+    if (r == VM_YIELD)       goto slice_done;
+    VM_NEXT;
+  }
+
+#if !VM_COMPUTED_GOTO
+  }
+#endif
+
+fail:
+  vm->status  = VM_FAILED;
+  vm->error   = err;
+  vm->errorPc = opPc;
+slice_done:
+  vm->pc = pc;
+  vm->sp = sp;
+  vm->executed += budget - left;
+  return budget - left;
+
+#undef VM_FETCH
+#undef VM_NEED
+#undef VM_ROOM
+#undef VM_U16
+#undef VM_BINARY
+#undef VM_OP
+#undef VM_NEXT
+}
+
+#endif
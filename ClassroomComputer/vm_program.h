@@ -0,0 +1,333 @@
+#ifndef VM_PROGRAM_H
+#define VM_PROGRAM_H
+
+#include <Arduino.h>
+#include "vm.h"
+#include "kv_store.h"
+#include "task_scheduler.h"
+#include "sketch_shared.h"
+#include "program_registry.h"
+
+//  VM program – runs bytecode uploaded over Serial (see vm.h for the
+// instruction set).  "vm load <hex>" appends code to the RAM buffer, "vm save"
+// copies it to data flash and the program restores it from there when the
+// buffer is empty, so an uploaded program survives a power-off.  "vm run"
+// (or picking "VM" in the menu) starts it; the program owns the LCD until it
+// halts, fails or is stopped with "vm stop".
+//
+// The interpreter runs as a background task in slices of VM_SLICE_INSNS
+// instructions until the task's VM_SLICE_US budget is spent, so the slider,
+// Serial and sound keep running whatever the program does.
+//
+// Syscalls (SYS n; arguments are popped last-pushed first):
+//   0 clear               LCD clear
+//   1 cursor  col row     LCD cursor
+//   2 number  n           print n
+//   3 char    c           print character c
+//   4 text    addr len    print len bytes of the code image starting at addr
+//   5 pot     -> v        slider, 0-1023
+//   6 tone    hz ms       beep (hz <= 0: silence; ms >= 0)
+//   7 millis  -> ms
+//   8 sleep   ms          pause the program (the board sleeps meanwhile)
+//   9 yield               end the current slice
+//  10 random  n -> r      0 <= r < n
+//
+// "vm bench [n]" times a built-in counting loop of n iterations in the
+// background and prints instructions per second, to tune the dispatch (see
+// VM_COMPUTED_GOTO in vm.h).
+
+//  VM program states
+enum VmProgramState {
+  VMP_TITLE,    // "Bytecode VM" / size of the loaded program, 1.5 s
+  VMP_RUNNING,  // the bytecode owns the LCD
+  VMP_DONE      // "Halted" or the error, 3 s
+};
+
+enum VmSyscallNumber {
+  SYSCALL_CLEAR, SYSCALL_CURSOR, SYSCALL_NUMBER, SYSCALL_CHAR, SYSCALL_TEXT, SYSCALL_POT,
+  SYSCALL_TONE, SYSCALL_MILLIS, SYSCALL_SLEEP, SYSCALL_YIELD, SYSCALL_RANDOM
+};
+
+#define VM_CODE_MAX     512
+#define VM_SLICE_INSNS  256
+#define VM_SLICE_US     4000
+#define VM_SAVE_CHUNK   KV_MAX_VALUE
+#define VM_BENCH_N      100000L
+#define VM_BENCH_MAX_N  10000000L   // 60 million instructions, seconds on the R4
+
+//  Code image and interpreter
+static uint8_t  vmCode[VM_CODE_MAX + VM_CODE_PAD];
+static uint16_t vmCodeLen = 0;
+static Vm       vm;
+
+//  VM-specific state
+static VmProgramState vmState     = VMP_TITLE;
+static int            vmTask      = -1;
+static bool           vmSleeping  = false;
+static unsigned long  vmWakeAt    = 0;
+static unsigned long  vmStartedAt = 0;
+static unsigned long  vmRunMs     = 0;
+
+//  Forward declarations
+void enterVmState(VmProgramState next);
+void handleVm(unsigned long now);
+static void vmTaskRun(unsigned long now);
+
+//  Syscalls
+
+static VmSysResult vmSyscall(Vm* m, uint8_t n) {
+  int32_t a, b;
+  switch (n) {
+    case SYSCALL_CLEAR:
+      lcd.clear();
+      return VM_CONTINUE;
+    case SYSCALL_CURSOR:
+      if (!vmPop(m, &b) || !vmPop(m, &a) || a < 0 || a > 15 || b < 0 || b > 1) return VM_BAD_SYSCALL;
+      lcd.setCursor(a, b);
+      return VM_CONTINUE;
+    case SYSCALL_NUMBER:
+      if (!vmPop(m, &a)) return VM_BAD_SYSCALL;
+      lcd.print((long)a);
+      return VM_CONTINUE;
+    case SYSCALL_CHAR:
+      if (!vmPop(m, &a)) return VM_BAD_SYSCALL;
+      lcd.write((uint8_t)a);
+      return VM_CONTINUE;
+    case SYSCALL_TEXT:
+      if (!vmPop(m, &b) || !vmPop(m, &a) || a < 0 || b < 0 || b > m->len || a > m->len - b) return VM_BAD_SYSCALL;
+      for (int32_t i = 0; i < b; i++) lcd.write(m->code[a + i]);
+      return VM_CONTINUE;
+    case SYSCALL_POT:
+      return vmPush(m, potValue) ? VM_CONTINUE : VM_BAD_SYSCALL;
+    case SYSCALL_TONE:
+      if (!vmPop(m, &b) || !vmPop(m, &a) || b < 0) return VM_BAD_SYSCALL;
+      if (a > 0) tone(BUZZER_PIN, a, b);
+      else       noTone(BUZZER_PIN);
+      return VM_CONTINUE;
+    case SYSCALL_MILLIS:
+      return vmPush(m, (int32_t)millis()) ? VM_CONTINUE : VM_BAD_SYSCALL;
+    case SYSCALL_SLEEP:
+      if (!vmPop(m, &a)) return VM_BAD_SYSCALL;
+      vmSleeping = true;
+      vmWakeAt   = millis() + (a > 0 ? a : 0);
+      return VM_YIELD;
+    case SYSCALL_YIELD:
+      return VM_YIELD;
+    case SYSCALL_RANDOM:
+      if (!vmPop(m, &a) || a <= 0) return VM_BAD_SYSCALL;
+      return vmPush(m, random(a)) ? VM_CONTINUE : VM_BAD_SYSCALL;
+  }
+  return VM_BAD_SYSCALL;
+}
+
+//  Persistence: the length under id 0, then the code in 32-byte records
+
+static bool vmSave() {
+  uint16_t len = vmCodeLen;
+  for (uint16_t off = 0; off < len; off += VM_SAVE_CHUNK) {
+    uint8_t chunk[VM_SAVE_CHUNK];
+    memset(chunk, 0, sizeof(chunk));
+    memcpy(chunk, vmCode + off, min((uint16_t)VM_SAVE_CHUNK, (uint16_t)(len - off)));
+    if (!kvPut(KV_KEY(KV_NS_VM, 1 + off / VM_SAVE_CHUNK), chunk, sizeof(chunk))) return false;
+  }
+  return kvPut(KV_KEY(KV_NS_VM, 0), &len, sizeof(len));
+}
+
+static bool vmRestore() {
+  uint16_t len = 0;
+  if (!kvGet(KV_KEY(KV_NS_VM, 0), &len, sizeof(len)) || len > VM_CODE_MAX) return false;
+  for (uint16_t off = 0; off < len; off += VM_SAVE_CHUNK) {
+    uint8_t chunk[VM_SAVE_CHUNK];
+    if (!kvGet(KV_KEY(KV_NS_VM, 1 + off / VM_SAVE_CHUNK), chunk, sizeof(chunk))) return false;
+    memcpy(vmCode + off, chunk, min((uint16_t)VM_SAVE_CHUNK, (uint16_t)(len - off)));
+  }
+  memset(vmCode + len, 0, VM_CODE_PAD);
+  vmCodeLen = len;
+  return true;
+}
+
+//  Implementations
+
+void enterVmState(VmProgramState next) {
+  vmState        = next;
+  stateEnteredAt = millis();
+  potHasMoved    = false;
+  setBacklight(next == VMP_DONE && vm.status == VM_FAILED ? COL_PINK : COL_GREEN);
+  lcd.clear();
+
+  taskCancel(vmTask);
+  if (next == VMP_TITLE && vmCodeLen == 0) vmRestore();
+  if (next == VMP_RUNNING) {
+    vmReset(&vm, vmCode, vmCodeLen, vmSyscall);
+    vmSleeping  = false;
+    vmStartedAt = millis();
+    vmTask = taskAdd("vm", vmTaskRun, 0, TASK_PRIO_COMPUTE, VM_SLICE_US, TASK_GROUP_PROGRAM);
+  }
+  if (next == VMP_DONE) {
+    noTone(BUZZER_PIN);
+    vmRunMs = millis() - vmStartedAt;
+    if (vmCodeLen > 0) {
+      benchPrintf("vm: %s pc=%u instructions=%lu ms=%lu\n",
+                  vm.status == VM_FAILED ? VM_ERROR_NAMES[vm.error] : "halted",
+                  vm.status == VM_FAILED ? vm.errorPc : vm.pc, (unsigned long)vm.executed, vmRunMs);
+    }
+  }
+}
+
+void handleVm(unsigned long now) {
+  switch (vmState) {
+    case VMP_TITLE:
+      lcd.setCursor(0, 0);
+      lcd.print("Bytecode VM");
+      lcd.setCursor(0, 1);
+      if (vmCodeLen > 0) { lcd.print(vmCodeLen); lcd.print(" bytes"); }
+      else               lcd.print("No program");
+      if (now - stateEnteredAt >= 1500UL) enterVmState(vmCodeLen > 0 ? VMP_RUNNING : VMP_DONE);
+      break;
+
+    case VMP_RUNNING:
+      if (vm.status != VM_RUNNING) enterVmState(VMP_DONE);
+      break;
+
+    case VMP_DONE:
+      lcd.setCursor(0, 0);
+      if (vmCodeLen == 0) {
+        lcd.print("Upload with");
+        lcd.setCursor(0, 1);
+        lcd.print("vm load <hex>");
+      } else if (vm.status == VM_FAILED) {
+        lcd.print(VM_ERROR_NAMES[vm.error]);
+        lcd.setCursor(0, 1);
+        lcd.print("at pc ");
+        lcd.print(vm.errorPc);
+      } else {
+        lcd.print("Halted");
+        lcd.setCursor(0, 1);
+        lcd.print(vm.executed);
+        lcd.print(" instr");
+      }
+      if (now - stateEnteredAt >= 3000UL) enterAppState(1);  // APP_PROGRAM_SELECT
+      break;
+  }
+}
+
+// Background task – slices until the budget is spent, the program yields or
+// sleeps, or it stops.  While asleep the task polls once a millisecond so
+// the board can sleep too.
+static void vmTaskRun(unsigned long now) {
+  if (vmSleeping) {
+    if ((long)(now - vmWakeAt) < 0) return;
+    vmSleeping = false;
+    taskSetPeriod(vmTask, 0);
+  }
+  while (vm.status == VM_RUNNING && taskHasBudget()) {
+    if (vmRun(&vm, VM_SLICE_INSNS) < VM_SLICE_INSNS) break;  // halted, failed or yielded
+  }
+  if (vmSleeping) taskSetPeriod(vmTask, 1);
+}
+
+//  Dispatch benchmark: a counting loop of six instructions per iteration,
+// run by its own task in VM_SLICE_US slices like the program itself.  Only
+// the time spent inside vmRun() counts.
+static uint8_t       vmBenchCode[] = {
+  VM_PUSH32, 0, 0, 0, 0,   //  0: push n
+  VM_STORE, 0,             //  5: v0 = n
+  VM_LOAD, 0,              //  7: loop: v0
+  VM_PUSH8, 1,             //  9
+  VM_SUB,                  // 11
+  VM_DUP,                  // 12
+  VM_STORE, 0,             // 13: v0 = v0 - 1
+  VM_JNZ, 7, 0,            // 15: until zero
+  VM_HALT,                 // 18
+  0, 0, 0, 0               // VM_CODE_PAD
+};
+static Vm            vmBenchVm;
+static int           vmBenchTask = -1;
+static long          vmBenchN    = 0;
+static unsigned long vmBenchUs   = 0;
+
+static void vmBenchRun(unsigned long now) {
+  unsigned long t0 = micros();
+  while (vmBenchVm.status == VM_RUNNING && taskHasBudget()) vmRun(&vmBenchVm, VM_SLICE_INSNS);
+  vmBenchUs += micros() - t0;
+  if (vmBenchVm.status == VM_RUNNING) return;
+
+  unsigned long us = max(vmBenchUs, 1UL);
+  benchPrintf("vm bench: dispatch=%s n=%ld instructions=%lu us=%lu ips=%lu ns_per_insn=%lu\n",
+              VM_COMPUTED_GOTO ? "goto" : "switch", vmBenchN, (unsigned long)vmBenchVm.executed, us,
+              (unsigned long)((unsigned long long)vmBenchVm.executed * 1000000ULL / us),
+              (unsigned long)((unsigned long long)us * 1000ULL / vmBenchVm.executed));
+  taskCancel(vmBenchTask);
+  vmBenchTask = -1;
+}
+
+// n, the loop count, is clamped to 1..VM_BENCH_MAX_N.
+static void vmBench(long n) {
+  if (vmBenchTask >= 0) { benchWrite("# vm: bench already running\n"); return; }
+  vmBenchN = constrain(n, 1L, VM_BENCH_MAX_N);
+  int32_t count = (int32_t)vmBenchN;
+  memcpy(vmBenchCode + 1, &count, 4);   // little-endian on both the R4 and hosts
+  vmReset(&vmBenchVm, vmBenchCode, sizeof(vmBenchCode) - VM_CODE_PAD, NULL);
+  vmBenchUs   = 0;
+  vmBenchTask = taskAdd("vmbench", vmBenchRun, 0, TASK_PRIO_COMPUTE, VM_SLICE_US, TASK_GROUP_SYSTEM);
+}
+
+//  Serial commands: vm load <hex> | run | stop | save | dump | clear | bench [n]
+// args is the rest of the command line after "vm" (may be NULL).
+static void vmCommand(char* args) {
+  char* sub = args ? strtok(args, " \t\r") : NULL;
+  if (!sub) { benchWrite("# vm load <hex>|run|stop|save|dump|clear|bench [n]\n"); return; }
+
+  if (strcmp(sub, "load") == 0) {
+    const char* hex = strtok(NULL, " \t\r");
+    while (hex && hex[0] && hex[1] && vmCodeLen < VM_CODE_MAX) {
+      char pair[3] = { hex[0], hex[1], '\0' };
+      vmCode[vmCodeLen++] = (uint8_t)strtoul(pair, NULL, 16);
+      hex += 2;
+    }
+    memset(vmCode + vmCodeLen, 0, VM_CODE_PAD);
+    benchPrintf("# vm: %u bytes\n", vmCodeLen);
+  } else if (strcmp(sub, "run") == 0) {
+    if (vmCodeLen == 0) vmRestore();
+    if (vmCodeLen == 0) benchWrite("# vm: nothing loaded\n");
+    else                enterProgramNamed("VM");
+  } else if (strcmp(sub, "stop") == 0) {
+    if (vm.status == VM_RUNNING) vm.status = VM_HALTED;
+  } else if (strcmp(sub, "save") == 0) {
+    benchWrite(vmSave() ? "# vm: saved\n" : "# vm: data flash full\n");
+  } else if (strcmp(sub, "dump") == 0) {
+    char line[16 + 2 * 32];
+    for (uint16_t i = 0; i < vmCodeLen; i += 32) {
+      int n = snprintf(line, sizeof(line), "vm load ");
+      for (uint16_t j = i; j < vmCodeLen && j < i + 32; j++) {
+        n += snprintf(line + n, sizeof(line) - n, "%02X", vmCode[j]);
+      }
+      benchPrintf("%s\n", line);
+    }
+    benchPrintf("# vm: %u bytes\n", vmCodeLen);
+  } else if (strcmp(sub, "clear") == 0) {
+    if (vm.status == VM_RUNNING) vm.status = VM_HALTED;
+    vmCodeLen = 0;
+  } else if (strcmp(sub, "bench") == 0) {
+    const char* n = strtok(NULL, " \t\r");
+    vmBench(n ? atol(n) : VM_BENCH_N);
+  } else {
+    benchPrintf("# vm: unknown '%s'\n", sub);
+  }
+}
+
+//  Registry entry (see program_registry.h)
+static void vmEnter() { enterVmState(VMP_TITLE); }
+static void vmExit()  { noTone(BUZZER_PIN); }
+
+constexpr size_t VM_STATIC_BYTES = sizeof(vmCode) + sizeof(Vm);
+static_assert(VM_STATIC_BYTES <= UINT16_MAX, "VM_STATIC_BYTES does not fit ProgramInfo::staticBytes");
+
+constexpr ProgramInfo VM_PROGRAM = {
+  "VM", vmEnter, handleVm, vmExit,
+  VM_STATIC_BYTES,
+  0,
+  NULL
+};
+
+#endif
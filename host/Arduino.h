@@ -0,0 +1,119 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+//  Host stand-in for the Arduino core
+// Just enough of the API for the sketch to build and run on a PC (see
+// sketch.cpp and the Makefile).  Time is real time from the first call;
+// analogRead() returns hostAnalog[pin], which tests set to move the slider
+// or the sensor.  tone() and the pins do nothing.  Serial writes to stdout;
+// the benchmark console reads stdin itself (bench_serial.h), so
+// Serial.available() is always 0.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define INPUT  0
+#define OUTPUT 1
+#define LOW    0
+#define HIGH   1
+#define DEC    10
+#define HEX    16
+
+#define PROGMEM
+#define F(s) (s)
+
+//  Time
+inline unsigned long micros() {
+  static const auto t0 = std::chrono::steady_clock::now();
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now() - t0).count();
+}
+inline unsigned long millis() { return micros() / 1000; }
+inline void delay(unsigned long ms)         { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+inline void delayMicroseconds(unsigned us)  { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+
+//  Pins
+inline int  hostAnalog[A3 + 1];
+inline int  analogRead(int pin)       { return (pin >= 0 && pin <= A3) ? hostAnalog[pin] : 0; }
+inline void analogWrite(int, int)     {}
+inline void pinMode(int, int)         {}
+inline void digitalWrite(int, int)    {}
+inline int  digitalRead(int)          { return LOW; }
+inline void tone(int, unsigned, unsigned long = 0) {}
+inline void noTone(int)               {}
+
+//  Maths
+inline void randomSeed(unsigned long seed) { srand((unsigned)seed); }
+inline long random(long hi)                { return hi > 0 ? rand() % hi : 0; }
+inline long random(long lo, long hi)       { return hi > lo ? lo + rand() % (hi - lo) : lo; }
+inline long map(long x, long inLo, long inHi, long outLo, long outHi) {
+  return (x - inLo) * (outHi - outLo) / (inHi - inLo) + outLo;
+}
+template <class T> T constrain(T x, T lo, T hi) { return x < lo ? lo : (x > hi ? hi : x); }
+using std::abs;
+using std::min;
+using std::max;
+
+//  Number formatting (avr-libc)
+inline char* ltoa(long v, char* s, int)           { sprintf(s, "%ld", v); return s; }
+inline char* ultoa(unsigned long v, char* s, int) { sprintf(s, "%lu", v); return s; }
+inline char* dtostrf(double v, signed char width, unsigned char prec, char* s) {
+  sprintf(s, "%*.*f", width, prec, v);
+  return s;
+}
+
+//  Print
+struct Print {
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  size_t write(const char* s)                   { size_t n = 0; while (*s) n += write((uint8_t)*s++); return n; }
+  size_t write(const uint8_t* b, size_t len)    { for (size_t i = 0; i < len; i++) write(b[i]); return len; }
+
+  size_t print(const char* s)                   { return write(s); }
+  size_t print(char c)                          { return write((uint8_t)c); }
+  size_t print(int v, int base = DEC)           { return print((long)v, base); }
+  size_t print(unsigned v, int base = DEC)      { return print((unsigned long)v, base); }
+  size_t print(long v, int base = DEC)          { return printf(base == HEX ? "%lX" : "%ld", v); }
+  size_t print(unsigned long v, int base = DEC) { return printf(base == HEX ? "%lX" : "%lu", v); }
+  size_t print(long long v, int = DEC)          { return printf("%lld", v); }
+  size_t print(unsigned long long v, int = DEC) { return printf("%llu", v); }
+  size_t print(double v, int digits = 2)        { return printf("%.*f", digits, v); }
+
+  size_t println()                              { return write((uint8_t)'\n'); }
+  template <class T> size_t println(T v)        { size_t n = print(v); return n + println(); }
+  template <class T> size_t println(T v, int f) { size_t n = print(v, f); return n + println(); }
+
+private:
+  template <class... A> size_t printf(const char* fmt, A... args) {
+    char t[48];
+    snprintf(t, sizeof(t), fmt, args...);
+    return write(t);
+  }
+};
+
+struct HostSerial : Print {
+  void   begin(unsigned long) {}
+  void   flush()              { fflush(stdout); }
+  int    available()          { return 0; }
+  int    read()               { return -1; }
+  size_t write(uint8_t c) override { fputc(c, stdout); return 1; }
+  using Print::write;
+  explicit operator bool()    { return true; }
+};
+
+inline HostSerial Serial;
+
+#endif
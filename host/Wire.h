@@ -0,0 +1,15 @@
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+//  Host stand-in for the I2C library; the LCD stand-in (rgb_lcd.h) keeps
+// its screen in memory, so nothing is sent anywhere.
+
+#include "Arduino.h"
+
+struct TwoWire {
+  void begin() {}
+};
+
+inline TwoWire Wire;
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef HOST_RGB_LCD_H
+#define HOST_RGB_LCD_H
+
+//  Host stand-in for the Grove 16x2 RGB LCD
+// Keeps the screen, the eight CGRAM glyphs and the backlight in memory so
+// tests can read back what a program drew.  Custom characters (0-7) show as
+// their slot digit in line().
+
+#include "Arduino.h"
+
+struct rgb_lcd : Print {
+  char    text[2][17];
+  byte    glyphs[8][8];
+  byte    rgb[3];
+  uint8_t col = 0, row = 0;
+
+  rgb_lcd() { clear(); }
+
+  void begin(uint8_t, uint8_t) { clear(); }
+  void clear() {
+    memset(text, ' ', sizeof(text));
+    text[0][16] = text[1][16] = '\0';
+    col = row = 0;
+  }
+  void home()                              { col = row = 0; }
+  void setCursor(uint8_t c, uint8_t r)     { col = c; row = r; }
+  void createChar(uint8_t slot, byte* map) { memcpy(glyphs[slot & 7], map, 8); }
+  void setRGB(byte r, byte g, byte b)      { rgb[0] = r; rgb[1] = g; rgb[2] = b; }
+  void display()   {}
+  void noDisplay() {}
+
+  size_t write(uint8_t c) override {
+    if (row < 2 && col < 16) text[row][col] = (c < 8) ? (char)('0' + c) : (char)c;
+    col++;
+    return 1;
+  }
+  using Print::write;
+
+  const char* line(int r) const { return text[r & 1]; }
+};
+
+#endif
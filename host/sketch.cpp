@@ -0,0 +1,29 @@
+//  Host build of the sketch
+// Runs setup() and then loop() until stdin is closed and the Serial work it
+// asked for (sweeps, micro, xsort, vm bench, a trace replay) has finished, so
+//
+//   echo "sort n=10:100:10" | ./sketch
+//
+// prints the CSV and exits.  "./sketch SECONDS" keeps running for that long
+// instead, whatever stdin does.  Slider and sensor read 0 unless a test sets
+// hostAnalog[].
+
+#include "../ClassroomComputer/ClassroomComputer.ino"
+
+static bool hostSerialIdle() {
+  return benchStdinEof
+      && benchSweep.kind == BENCH_IDLE
+      && taskSlot(microTask) < 0
+      && !xsortBusy()
+      && taskSlot(vmBenchTask) < 0
+      && traceMode != TRACE_REPLAYING;
+}
+
+int main(int argc, char** argv) {
+  long runForMs = (argc > 1) ? (long)(atof(argv[1]) * 1000) : -1;
+
+  setup();
+  while (runForMs >= 0 ? (long)millis() < runForMs : !hostSerialIdle()) loop();
+  fflush(stdout);
+  return 0;
+}
@@ -0,0 +1,47 @@
+#!/bin/sh
+# Drives build/sketch through its Serial commands and checks the output.
+# Run from the build directory (make test does).
+
+fail=0
+check() {  # description, then a command that must succeed (its output is dropped)
+  what=$1; shift
+  if "$@" > /dev/null 2>&1; then echo "smoke: $what ok"; else echo "smoke: $what FAILED"; fail=1; fi
+}
+
+rm -f classroom_kv.bin
+
+out=$(echo "sort n=10,100,500 algo=bubble,merge dist=random,sorted,reversed,few reps=2" | ./sketch)
+check "sort sweep rows"   test "$(echo "$out" | grep -c '^sort,')" -eq 48
+check "sort sweep sorted" test "$(echo "$out" | grep '^sort,' | grep -vc ',1$')" -eq 0
+
+out=$(echo "primes n=1000,10000" | ./sketch)
+check "primes p_1000"  sh -c "echo '$out' | grep -q '^primes,trial,,1000,1,[0-9]*,7919$'"
+check "primes p_10000" sh -c "echo '$out' | grep -q '^primes,trial,,10000,1,[0-9]*,104729$'"
+
+out=$(echo "pi n=1000000,2000000 algo=meissel,sieve" | ./sketch)
+check "pi meissel" test "$(echo "$out" | grep -c '^pi,meissel,,1000000,1,[0-9]*,78498$')" -eq 1
+check "pi sieve"   test "$(echo "$out" | grep -c '^pi,sieve,,2000000,1,[0-9]*,148933$')" -eq 1
+
+# The synthetic signal starts at ADC 480-483 (72.4-72.8 F); the slider at 0
+# samples once a second
+out=$( (printf 'logger synth on\nlogger run\n'; sleep 4; echo logger) | ./sketch 4.5)
+check "logger synth" sh -c "echo '$out' | grep -q '^# logger: rate_hz=1 source=synth samples=[1-9][0-9]* n=[0-9]* min_f=72\.[4-8] max_f=72\.[4-8] '"
+
+out=$(printf 'stop\nhelp\n' | ./sketch)
+check "help" sh -c "echo '$out' | grep -q 'sort'"
+
+check "interactive run" sh -c "./sketch 0.5 < /dev/null"
+
+if command -v python3 > /dev/null; then
+  check "xsort peer" python3 ../../tools/xsort_peer.py --exec ./sketch -n 3000
+
+  # The compare step itself, on numbers that do not depend on the machine
+  echo micro | ./sketch > micro_smoke.json
+  sed 's/"ns_min":\([0-9]*\)/"ns_min":1/' micro_smoke.json > micro_fast.json
+  check "micro compare same"  python3 ../../tools/micro_compare.py micro_smoke.json micro_smoke.json
+  check "micro compare flags" sh -c "! python3 ../../tools/micro_compare.py micro_fast.json micro_smoke.json"
+  rm -f micro_smoke.json micro_fast.json
+fi
+
+rm -f classroom_kv.bin
+exit $fail
@@ -0,0 +1,49 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+//  Minimal checks for the host tests
+// Each test program includes the whole sketch first, so it can reach every
+// static in it, then runs its checks from main() and returns testReport().
+
+#include <stdio.h>
+#include <string.h>
+
+static int testChecks   = 0;
+static int testFailures = 0;
+
+static void testFail(const char* file, int line, const char* what) {
+  testFailures++;
+  printf("%s:%d: FAILED %s\n", file, line, what);
+}
+
+#define CHECK(cond) \
+  do { testChecks++; if (!(cond)) testFail(__FILE__, __LINE__, #cond); } while (0)
+
+#define CHECK_EQ(a, b)                                                             \
+  do {                                                                             \
+    testChecks++;                                                                  \
+    long long va_ = (long long)(a), vb_ = (long long)(b);                          \
+    if (va_ != vb_) {                                                              \
+      char what_[160];                                                             \
+      snprintf(what_, sizeof(what_), "%s == %s (%lld vs %lld)", #a, #b, va_, vb_); \
+      testFail(__FILE__, __LINE__, what_);                                         \
+    }                                                                              \
+  } while (0)
+
+#define CHECK_STR(a, b)                                                                \
+  do {                                                                                 \
+    testChecks++;                                                                      \
+    const char *sa_ = (a), *sb_ = (b);                                                 \
+    if (strcmp(sa_, sb_) != 0) {                                                       \
+      char what_[160];                                                                 \
+      snprintf(what_, sizeof(what_), "%s == %s (\"%s\" vs \"%s\")", #a, #b, sa_, sb_); \
+      testFail(__FILE__, __LINE__, what_);                                             \
+    }                                                                                  \
+  } while (0)
+
+static int testReport(const char* name) {
+  printf("%s: %d checks, %d failed\n", name, testChecks, testFailures);
+  return testFailures ? 1 : 0;
+}
+
+#endif
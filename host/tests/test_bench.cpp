@@ -0,0 +1,97 @@
+//  Serial sweeps share buffers with the programs: they wait for the Sort
+// Test's run and the Primes count, and primes and pi rows are cut into slices
+
+#define KV_HOST_FILE "test_bench_kv.bin"
+#include "../../ClassroomComputer/ClassroomComputer.ino"
+#include "test.h"
+
+static void command(const char* text) {
+  char line[BENCH_LINE_MAX];
+  strncpy(line, text, sizeof(line) - 1);
+  line[sizeof(line) - 1] = '\0';
+  benchCommand(line);
+}
+
+// Runs the scheduler (and with it the serial task) until the sweep is over.
+static void runSweep() {
+  unsigned long until = millis() + 20000;
+  while (benchSweep.kind != BENCH_IDLE && (long)(millis() - until) < 0) taskRunDue(millis());
+}
+
+int main() {
+  remove(KV_HOST_FILE);
+  setup();
+
+  //  pi rows wait while the count is sieving in piSegment; both come out right
+  enterProgramNamed("Primes");
+  primesXStep = 17;  // 50,000,000
+  enterPrimesState(PRIMES_COUNTING);
+  CHECK(primesCounting());
+  command("pi n=2000000 algo=meissel,sieve");
+  benchStep();
+  CHECK(benchSweep.waiting);
+  CHECK_EQ(benchSweep.rows, 0);
+  while (primesState == PRIMES_COUNTING) taskRunDue(millis());
+  CHECK_EQ(primesResult, 3001134);
+  runSweep();
+  CHECK_EQ(benchSweep.kind, BENCH_IDLE);
+  CHECK_EQ(benchSweep.rows, 2);
+
+  //  Sort rows wait for the Sort Test's run
+  enterProgramNamed("Sort");
+  confirmedN = 300;
+  enterSortState(SORT_RUNNING);
+  CHECK(sortRunning());
+  command("sort n=500 algo=merge reps=2");
+  benchStep();
+  CHECK(benchSweep.waiting);
+  CHECK_EQ(benchSweep.rows, 0);
+  runSweep();
+  CHECK(!sortRunning());
+  CHECK_EQ(benchSweep.rows, 2);
+
+  //  A large primes row takes many slices of the serial task's budget
+  enterProgramNamed("Primes");
+  command("primes n=200000");
+  runSweep();
+  const Task& serial = tasks[taskSlot(serialTask)];
+  CHECK_EQ(benchSweep.rows, 1);
+  CHECK_EQ(benchSweep.candidate, 2750159);   // p_200000
+  CHECK(serial.runs > 10);
+  CHECK(serial.maxUs < 4 * SERIAL_SLICE_US);
+
+  //  pi rows are cut into slices too, Meissel and sieve alike (a short budget
+  // stands in for the board's slower clock)
+  Task& serial2 = tasks[taskSlot(serialTask)];
+  serial2.budgetUs = 200;
+  const char* const piRows[] = { "pi n=2000000000 algo=meissel", "pi n=2000000 algo=sieve" };
+  for (int i = 0; i < 2; i++) {
+    command(piRows[i]);
+    serial2.runs  = 0;
+    serial2.maxUs = 0;
+    runSweep();
+    CHECK_EQ(benchSweep.rows, 1);
+    if (i == 1) CHECK_EQ(benchSweep.count, 148933);
+    CHECK(serial2.runs > 5);
+    CHECK(serial2.maxUs < 20 * 200);
+  }
+
+  //  A count that starts in the middle of a pi row makes the row start over
+  enterProgramNamed("Primes");
+  command("pi n=2000000 algo=sieve");
+  while (!benchSweep.slicing && benchSweep.rows == 0) taskRunDue(millis());
+  CHECK(benchSweep.slicing && benchSweep.rows == 0);
+  primesXStep = 17;
+  enterPrimesState(PRIMES_COUNTING);
+  benchStep();
+  CHECK(benchSweep.waiting && !benchSweep.slicing);
+  while (primesState == PRIMES_COUNTING) taskRunDue(millis());
+  CHECK_EQ(primesResult, 3001134);
+  runSweep();
+  CHECK_EQ(benchSweep.rows, 1);
+  CHECK_EQ(benchSweep.count, 148933);
+  serial2.budgetUs = SERIAL_SLICE_US;
+
+  remove(KV_HOST_FILE);
+  return testReport("bench");
+}
@@ -0,0 +1,55 @@
+//  Boot resume: the last program goes to flash only while resume is on,
+// and only when it changes
+
+#define KV_HOST_FILE "test_boot_kv.bin"
+#include "../../ClassroomComputer/ClassroomComputer.ino"
+#include "test.h"
+
+static void boot(const char* text) {
+  char line[BENCH_LINE_MAX];
+  strncpy(line, text, sizeof(line) - 1);
+  line[sizeof(line) - 1] = '\0';
+  bootCommand(line);
+}
+
+int main() {
+  remove(KV_HOST_FILE);
+  setup();
+
+  //  Resume off: switching programs writes nothing
+  uint16_t tail = kvTail;
+  enterProgramNamed("Primes");
+  enterProgramNamed("Sort");
+  bootRememberParam(300);
+  BootRecord saved;
+  CHECK_EQ(kvTail, tail);
+  CHECK(!kvGet(KV_BOOT_LAST, &saved, sizeof(saved)));
+
+  //  Turning it on saves the program in use, with its setting
+  boot("resume on");
+  CHECK(kvGet(KV_BOOT_LAST, &saved, sizeof(saved)));
+  CHECK_STR(saved.program, "Sort");
+  CHECK_EQ(saved.param, 300);
+
+  //  Re-entering the same program or locking in the same setting writes nothing
+  tail = kvTail;
+  enterProgramNamed("Sort");
+  bootRememberParam(300);
+  CHECK_EQ(kvTail, tail);
+
+  //  A new program does
+  enterProgramNamed("Primes");
+  CHECK(kvTail != tail);
+  CHECK(kvGet(KV_BOOT_LAST, &saved, sizeof(saved)));
+  CHECK_STR(saved.program, "Primes");
+  CHECK_EQ(saved.hasParam, 0);
+
+  //  Off again: switches stop being recorded
+  boot("resume off");
+  tail = kvTail;
+  enterProgramNamed("Sort");
+  CHECK_EQ(kvTail, tail);
+
+  remove(KV_HOST_FILE);
+  return testReport("boot");
+}
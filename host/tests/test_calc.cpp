@@ -0,0 +1,70 @@
+//  Exact calculator arithmetic and the big-number jobs
+
+#include "../../ClassroomComputer/ClassroomComputer.ino"
+#include "test.h"
+
+static const char* exact(long a, char op, long b) {
+  static char out[CALC_EXACT_BYTES + 8];
+  memset(out, '#', sizeof(out));
+  formatCalcExact(calcEvaluate(a, op, b), out);
+  CHECK(strlen(out) < CALC_EXACT_BYTES);
+  return out;
+}
+
+static const char* bigDigits(BigJobOp op, uint32_t base, uint32_t n) {
+  static char out[1300];
+  static BigJob job;
+  bigJobStart(&job, op, base, n);
+  while (bigJobStep(&job)) {}
+  int len = 0;
+  while (bigJobHasDigits(&job) && len < (int)sizeof(out) - 1) out[len++] = bigJobNextDigit(&job);
+  out[len] = '\0';
+  CHECK_EQ(job.digitCount, len);
+  return out;
+}
+
+int main() {
+  //  Integers get commas
+  CHECK_STR(exact(1000000, '*', 1000), "1,000,000,000");
+  CHECK_STR(exact(-999, '-', 1), "-1,000");
+  CHECK_STR(exact(0, '+', 0), "0");
+
+  //  Fractions: as many decimals as fit, rounded half away from zero
+  CHECK_STR(exact(1, '/', 3), "0.333333333333");
+  CHECK_STR(exact(2, '/', 3), "0.666666666667");
+  CHECK_STR(exact(-1, '/', 8), "-0.125");
+  CHECK_STR(exact(-2, '/', 3), "-0.66666666667");
+  CHECK_STR(exact(999999999, '/', 1000000000), "0.999999999");
+  CHECK_STR(exact(99999, '/', 100000), "0.99999");
+
+  //  Reduced and sign on the numerator
+  CalcValue v = calcEvaluate(6, '/', -4);
+  CHECK_EQ(v.num, -3);
+  CHECK_EQ(v.den, 2);
+
+  //  Division by zero
+  CHECK(!calcIsValid(calcEvaluate(5, '/', 0)));
+  CHECK_STR(exact(5, '/', 0), "Error");
+
+  //  Every result of the Calculator's operands (1-100) fits its width
+  const char ops[] = { '+', '-', '*', '/' };
+  int tooWide = 0;
+  for (long a = 1; a <= 100; a++)
+    for (long b = 1; b <= 100; b++)
+      for (char op : ops) tooWide += strlen(exact(a, op, b)) > CALC_RESULT_CHARS;
+  CHECK_EQ(tooWide, 0);
+
+  //  Big numbers
+  CHECK_STR(bigDigits(BIG_OP_POWER, 2, 100), "1267650600228229401496703205376");
+  CHECK_STR(bigDigits(BIG_OP_FACTORIAL, 0, 20), "2432902008176640000");
+  CHECK_STR(bigDigits(BIG_OP_FACTORIAL, 0, 0), "1");
+  CHECK_STR(bigDigits(BIG_OP_POWER, 7, 0), "1");
+  CHECK_EQ(strlen(bigDigits(BIG_OP_FACTORIAL, 0, 450)), 1001);  // 450! has 1001 digits
+
+  static BigJob overflow;
+  bigJobStart(&overflow, BIG_OP_POWER, 3, 100000);
+  while (bigJobStep(&overflow)) {}
+  CHECK_EQ(overflow.phase, BIG_PHASE_OVERFLOW);
+
+  return testReport("calc");
+}
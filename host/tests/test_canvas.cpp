@@ -0,0 +1,116 @@
+//  Pixel canvas: sprites, rectangles, the soup Life draws with them and
+// the compositor's I2C byte count
+
+#include "../../ClassroomComputer/ClassroomComputer.ino"
+#include "test.h"
+
+static bool pixel(int x, int y) {
+  return (canvasRows[y][x >> 5] >> (31 - (x & 31))) & 1;
+}
+
+static int litPixels() {
+  int n = 0;
+  for (int y = 0; y < CANVAS_H; y++) {
+    for (int w = 0; w < CANVAS_WORDS; w++) n += __builtin_popcount(canvasRows[y][w]);
+  }
+  return n;
+}
+
+// True if the 5x5 patch at (x, y) is LIFE_GLIDER on a clear border.
+static bool gliderAt(int x, int y) {
+  for (int r = 0; r < 5; r++) {
+    for (int c = 0; c < 5; c++) {
+      bool on = r >= 1 && r <= 3 && c >= 1 && c <= 3 && ((LIFE_GLIDER[r - 1] << (c - 1)) >> 31);
+      if (pixel(x + c, y + r) != on) return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  //  A sprite straddling a word boundary lands bit for bit
+  static const uint32_t bar[2] = { 0xF0000000UL, 0x90000000UL };
+  canvasClear();
+  canvasBlit(bar, 2, 30, 3);
+  CHECK_EQ(litPixels(), 6);
+  CHECK(pixel(30, 3) && pixel(31, 3) && pixel(32, 3) && pixel(33, 3));
+  CHECK(pixel(30, 4) && !pixel(31, 4) && !pixel(32, 4) && pixel(33, 4));
+
+  //  XOR takes it away again
+  canvasBlit(bar, 2, 30, 3, true);
+  CHECK_EQ(litPixels(), 0);
+
+  //  Clipped at every edge, and never into pixels 80-95
+  canvasBlit(bar, 2, -2, -1);   // only the second row's last pixel is on screen
+  CHECK_EQ(litPixels(), 1);
+  CHECK(pixel(1, 0));
+  canvasClear();
+  canvasBlit(bar, 2, 78, 15);
+  CHECK_EQ(litPixels(), 2);
+  CHECK(pixel(78, 15) && pixel(79, 15));
+  CHECK_EQ(canvasRows[15][CANVAS_WORDS - 1] & 0xFFFFUL, 0);
+  canvasBlit(bar, 2, -32, 0);
+  canvasBlit(bar, 2, CANVAS_W, 0);
+  CHECK_EQ(litPixels(), 2);
+
+  //  Rectangles across all three words, clipped, and cleared
+  canvasClear();
+  canvasFillRect(10, 2, 60, 3, true);
+  CHECK_EQ(litPixels(), 180);
+  CHECK(!pixel(9, 2) && pixel(10, 2) && pixel(69, 4) && !pixel(70, 4) && !pixel(10, 5));
+  canvasFillRect(-5, -5, 200, 200, true);
+  CHECK_EQ(litPixels(), CANVAS_W * CANVAS_H);
+  CHECK_EQ(canvasRows[0][CANVAS_WORDS - 1] & 0xFFFFUL, 0);
+  canvasFillRect(20, 0, 40, CANVAS_H, false);
+  CHECK_EQ(litPixels(), 40 * CANVAS_H);
+  CHECK(!pixel(20, 7) && !pixel(59, 7) && pixel(19, 7) && pixel(60, 7));
+  canvasFillRect(5, 5, 0, 4, true);
+  CHECK_EQ(litPixels(), 40 * CANVAS_H);
+
+  //  A frame's byte count is what the LCD's counter saw
+  canvasClear();
+  canvasReset();
+  canvasFillRect(0, 0, 5, 8, true);                  // solid: the ROM block
+  canvasBlit(bar, 2, 12, 9);                         // two custom tiles
+  canvasFillRect(40, 2, 3, 3, true);
+  uint32_t before = lcd.i2cBytes;
+  canvasCompose();
+  CHECK_EQ(canvasStats.glyphUploads, 3);
+  CHECK_EQ(canvasStats.cellWrites, 4);
+  CHECK_EQ(canvasStats.i2cBytes, lcd.i2cBytes - before);
+  CHECK_EQ(canvasStats.i2cBytes, 3 * LCD_I2C_CREATECHAR + (4 + 3) * LCD_I2C_COMMAND);  // 3 cursor moves
+
+  //  Uploads that would overrun the budget wait for the next frame, and so
+  // do their cells
+  canvasClear();
+  canvasReset();
+  canvasByteBudget = 2 * LCD_I2C_CREATECHAR + 4 * LCD_I2C_COMMAND;
+  for (int i = 0; i < 4; i++) canvasFillRect(i * 10, 0, 1 + i, 2, true);   // four distinct tiles
+  before = lcd.i2cBytes;
+  canvasCompose();
+  CHECK_EQ(canvasStats.glyphUploads, 2);
+  CHECK_EQ(canvasStats.cellWrites, 2);
+  CHECK_EQ(canvasStats.deferredCells, 2);
+  CHECK_EQ(canvasStats.overflowTiles, 0);
+  CHECK(canvasStats.i2cBytes <= canvasByteBudget);
+  CHECK_EQ(lcd.i2cBytes - before, canvasStats.i2cBytes);
+  canvasCompose();
+  CHECK_EQ(canvasStats.glyphUploads, 2);
+  CHECK_EQ(canvasStats.cellWrites, 2);
+  CHECK_EQ(canvasStats.deferredCells, 0);
+  canvasCompose();
+  CHECK_EQ(canvasStats.i2cBytes, 0);
+  canvasByteBudget = 320;
+
+  //  Life's soup has its glider on a cleared patch
+  for (int run = 0; run < 20; run++) {
+    lifeSeed();
+    bool found = false;
+    for (int y = 0; y + 5 <= CANVAS_H && !found; y++) {
+      for (int x = 0; x + 5 <= CANVAS_W && !found; x++) found = gliderAt(x, y);
+    }
+    CHECK(found);
+  }
+
+  return testReport("canvas");
+}
@@ -0,0 +1,30 @@
+//  The Fibonacci Lab's five methods agree
+
+#include "../../ClassroomComputer/ClassroomComputer.ino"
+#include "test.h"
+
+int main() {
+  uint64_t steps;
+  int mismatches = 0;
+  for (int n = 0; n <= FIB_MAX_N; n++) {
+    uint64_t want = fibIterative(n, &steps);
+    for (uint8_t m = FIB_MEMO; m < FIB_METHOD_COUNT; m++) mismatches += fibCompute(m, n, &steps) != want;
+  }
+  CHECK_EQ(mismatches, 0);
+  CHECK(fibDoubling(FIB_MAX_N, &steps) == 12200160415121876738ULL);
+  CHECK_EQ(fibIterative(10, &steps), 55);
+
+  //  The resumable naive recursion makes exactly 2·F(n+1) - 1 calls
+  static FibNaiveJob job;
+  fibNaiveStart(&job, 20);
+  while (fibNaiveStep(&job, 1000)) {}
+  CHECK_EQ(job.result, 6765);
+  CHECK_EQ(job.calls, 21891);
+  CHECK_EQ((long)fibNaiveCalls(20), 21891);
+
+  char out[32];
+  fibFormatU64(out, 12200160415121876738ULL);
+  CHECK_STR(out, "12200160415121876738");
+
+  return testReport("fib");
+}
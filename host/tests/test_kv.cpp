@@ -0,0 +1,78 @@
+//  Key/value store: persistence, compaction and the cache quota
+
+#define KV_HOST_FILE "test_kv.bin"
+#include "../../ClassroomComputer/ClassroomComputer.ino"
+#include "test.h"
+
+// Forgets the in-memory state and reads the file back, like a reset.
+static void kvReopen() {
+  if (kvFile) fclose(kvFile);
+  kvFile  = NULL;
+  kvReady = false;
+  kvBegin();
+}
+
+int main() {
+  remove(KV_HOST_FILE);
+
+  //  Round trip, overwrite, wrong length, persistence
+  uint32_t v = 12345, out = 0;
+  CHECK(!kvGet(KV_KEY(KV_NS_PI, 1), &out, sizeof(out)));
+  CHECK(kvPut(KV_KEY(KV_NS_PI, 1), &v, sizeof(v)));
+  CHECK(kvGet(KV_KEY(KV_NS_PI, 1), &out, sizeof(out)));
+  CHECK_EQ(out, 12345);
+  v = 777;
+  CHECK(kvPut(KV_KEY(KV_NS_PI, 1), &v, sizeof(v)));
+  uint16_t tail = kvTail;
+  CHECK(kvPut(KV_KEY(KV_NS_PI, 1), &v, sizeof(v)));
+  CHECK_EQ(kvTail, tail);  // same value: nothing written
+  uint16_t shortOut;
+  CHECK(!kvGet(KV_KEY(KV_NS_PI, 1), &shortOut, sizeof(shortOut)));
+  kvReopen();
+  CHECK(kvGet(KV_KEY(KV_NS_PI, 1), &out, sizeof(out)));
+  CHECK_EQ(out, 777);
+
+  //  Scores
+  CHECK(kvRecordScore(KV_SCORE_PADDLE, 10));
+  CHECK(!kvRecordScore(KV_SCORE_PADDLE, 9));
+  CHECK_EQ(kvBestScore(KV_SCORE_PADDLE), 10);
+
+  //  Hundreds of memoised primes: older ones are dropped, the rest survives
+  int failed = 0;
+  for (uint32_t n = 1; n <= 400; n++) failed += !kvPut(KV_KEY(KV_NS_PRIME, n), &n, sizeof(n));
+  CHECK_EQ(failed, 0);
+  CHECK(kvGet(KV_KEY(KV_NS_PRIME, 400), &out, sizeof(out)));
+  CHECK_EQ(out, 400);
+  CHECK(!kvGet(KV_KEY(KV_NS_PRIME, 1), &out, sizeof(out)));
+  CHECK(kvGet(KV_KEY(KV_NS_PI, 1), &out, sizeof(out)));
+  CHECK_EQ(kvBestScore(KV_SCORE_PADDLE), 10);
+
+  //  Settings that outgrow a bank: puts fail without compacting every time
+  uint8_t chunk[KV_MAX_VALUE];
+  memset(chunk, 0x5A, sizeof(chunk));
+  int stored = 0;
+  for (uint32_t id = 1; id <= 80; id++) {
+    chunk[0] = (uint8_t)id;
+    if (!kvPut(KV_KEY(KV_NS_VM, id), chunk, sizeof(chunk))) break;
+    stored++;
+  }
+  CHECK(stored > 0 && stored < 80);
+  for (uint32_t id = 2; kvPut(KV_KEY(KV_NS_PI, id), &id, sizeof(id)); id++) {}
+  uint16_t seq = kvSeq;
+  CHECK(!kvPut(KV_KEY(KV_NS_VM, 200), chunk, sizeof(chunk)));
+  CHECK(!kvRecordScore(KV_SCORE_ASTEROIDS, 5));
+  CHECK_EQ(kvSeq, seq);
+  CHECK(kvGet(KV_KEY(KV_NS_VM, stored), chunk, sizeof(chunk)));
+  CHECK_EQ(chunk[0], stored);
+
+  //  A torn record (length byte never written) reads as free space
+  kvReopen();
+  uint16_t end = kvTail;
+  kvWrite(kvBankBase(kvBank) + end + 2, 0x11);  // key byte, no length
+  kvReopen();
+  CHECK_EQ(kvTail, end);
+  CHECK_EQ(kvBestScore(KV_SCORE_PADDLE), 10);
+
+  remove(KV_HOST_FILE);
+  return testReport("kv");
+}
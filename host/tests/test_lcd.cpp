@@ -0,0 +1,43 @@
+//  The LCD's I2C byte counter, and the trace report that uses it
+
+#define KV_HOST_FILE "test_lcd_kv.bin"
+#include "../../ClassroomComputer/ClassroomComputer.ino"
+#include "test.h"
+
+int main() {
+  remove(KV_HOST_FILE);
+  setup();
+
+  //  Each call adds what it sends, address bytes included
+  uint32_t start = lcd.i2cBytes;
+  lcd.setCursor(0, 0);
+  CHECK_EQ(lcd.i2cBytes - start, 3);
+  lcd.print("Hi!");
+  CHECK_EQ(lcd.i2cBytes - start, 3 + 3 * 3);
+  lcd.print(42);
+  CHECK_EQ(lcd.i2cBytes - start, 3 + 5 * 3);
+  byte glyph[8] = { 0 };
+  lcd.createChar(1, glyph);
+  CHECK_EQ(lcd.i2cBytes - start, 3 + 5 * 3 + 13);
+  setBacklight(COL_GREEN);
+  CHECK_EQ(lcd.i2cBytes - start, 3 + 5 * 3 + 13 + 9);
+  lcd.clear();
+  CHECK_EQ(lcd.i2cBytes - start, 3 + 5 * 3 + 13 + 9 + 3);
+  CHECK(lcd.line(0)[0] == ' ');   // the counter leaves the screen to rgb_lcd
+
+  //  A trace session counts only its own bytes
+  traceStartRecording(analogRead(A0));
+  CHECK_EQ(traceI2cStart, lcd.i2cBytes - 3 - 9);   // the menu's clear and backlight
+  for (int i = 0; i < 20; i++) loop();
+  CHECK(lcd.i2cBytes - traceI2cStart > 16 * 3);    // at least one line of the menu
+  traceStop();
+
+  //  A bare "trace" does nothing, even with another line still in strtok()
+  char other[] = "trace rec";
+  strtok(other, " ");
+  traceCommand(NULL);
+  CHECK_EQ(traceMode, TRACE_OFF);
+
+  remove(KV_HOST_FILE);
+  return testReport("lcd");
+}
@@ -0,0 +1,91 @@
+//  Prime counting (Meissel and the reference sieve), the prime iterator, its
+// cache slots and trial division
+
+#include "../../ClassroomComputer/ClassroomComputer.ino"
+#include "test.h"
+
+static uint32_t piByJob(uint32_t x) {
+  static PiJob job;
+  piJobStart(&job, x);
+  while (job.phase != PI_PHASE_DONE) piJobStep(&job);
+  return job.result;
+}
+
+// The reference count: plain segmented sieve; x <= PI_SIEVE_MAX.
+static uint32_t piBySieve(uint32_t x) {
+  piTablesInit();
+  if (x < 2) return 0;
+  uint32_t count = 1;  // 2
+  for (uint32_t lo = 0; lo <= x; lo += PI_SEGMENT_SPAN) count += piSieveCount(lo, x);
+  return count;
+}
+
+int main() {
+  //  Known values of pi(x)
+  CHECK_EQ(piByJob(1), 0);
+  CHECK_EQ(piByJob(2), 1);
+  CHECK_EQ(piByJob(1000), 168);
+  CHECK_EQ(piByJob(1000000), 78498);
+  CHECK_EQ(piByJob(10000000), 664579);
+  CHECK_EQ(piByJob(1000000000), 50847534);
+  CHECK_EQ(piByJob(4294967295UL), 203280221);
+  CHECK_EQ(piBySieve(1000000), 78498);
+  CHECK_EQ(piBySieve(PI_SIEVE_MAX), piByJob(PI_SIEVE_MAX));
+
+  //  Meissel and the sieve agree around segment and table edges
+  const uint32_t edges[] = { PI_SMALL_LIMIT - 1, PI_SMALL_LIMIT, PI_SEGMENT_SPAN - 1, PI_SEGMENT_SPAN,
+                             PI_SEGMENT_SPAN + 1, 3 * PI_SEGMENT_SPAN, 999983, 2000003 };
+  for (uint32_t x : edges) CHECK_EQ(piByJob(x), piBySieve(x));
+
+  //  The iterator from 0, across segments, and near its end
+  PrimeIter it;
+  primeIterStart(&it, 0, 0);
+  const uint32_t first[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29 };
+  for (uint32_t p : first) CHECK_EQ(primeIterNext(&it), p);
+
+  primeIterStart(&it, 0, 0);
+  uint32_t count = 0;
+  while (primeIterNext(&it) < 100000) count++;
+  CHECK_EQ(count, 9592);
+
+  primeIterStart(&it, 1000000, 0);
+  CHECK_EQ(primeIterNext(&it), 1000003);
+  CHECK_EQ(primeIterNext(&it), 1000033);
+  primeIterStart(&it, 1000003, 0);
+  CHECK_EQ(primeIterNext(&it), 1000003);
+
+  primeIterStart(&it, PRIME_ITER_MAX - 100, 0);
+  uint32_t p, last = 0;
+  while ((p = primeIterNext(&it)) != 0) last = p;
+  CHECK(last > 0 && last <= PRIME_ITER_MAX);
+
+  //  The explorer's stream runs ahead without evicting the slider's segment:
+  // with the view still, only its first frame sieves
+  enterPrimesState(PRIMES_EXPLORE);
+  potValue = 1023;
+  uint32_t viewSieves = 0, scanSieves = 0;
+  for (int frame = 0; frame < 200; frame++) {
+    uint32_t before = primeSieveCount;
+    handlePrimesExplore(millis());
+    viewSieves += primeSieveCount - before;
+    before = primeSieveCount;
+    taskRunDue(millis());
+    scanSieves += primeSieveCount - before;
+  }
+  CHECK_EQ(viewSieves, 1);
+  CHECK(scanSieves > 20);
+  CHECK(primesScanLast > 20 * PRIME_SEGMENT_SPAN);
+
+  //  Trial division agrees with the sieve
+  primeIterStart(&it, 0, 0);
+  int mismatches = 0;
+  uint32_t next = primeIterNext(&it);
+  for (unsigned long n = 0; n < 20000; n++) {
+    bool sieved = (n == next);
+    if (sieved) next = primeIterNext(&it);
+    mismatches += isPrime(n) != sieved;
+  }
+  CHECK_EQ(mismatches, 0);
+
+  return testReport("primes");
+}
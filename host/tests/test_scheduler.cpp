@@ -0,0 +1,88 @@
+//  Cooperative scheduler: ordering, handles, groups, one-shots, budgets
+
+#include "../../ClassroomComputer/ClassroomComputer.ino"
+#include "test.h"
+
+static char order[16];
+static int  orderLen = 0;
+static bool budgetRanOut = false;
+
+static void runA(unsigned long) { order[orderLen++] = 'a'; }
+static void runB(unsigned long) { order[orderLen++] = 'b'; }
+static void runC(unsigned long) { order[orderLen++] = 'c'; }
+
+static void runBudget(unsigned long) {
+  unsigned long t0 = micros();
+  while (taskHasBudget() && micros() - t0 < 100000UL) {}
+  budgetRanOut = !taskHasBudget();
+}
+
+static void resetTasks() {
+  for (int i = 0; i < TASK_MAX; i++) if (tasks[i].active) taskFree(i);
+  orderLen = 0;
+  memset(order, 0, sizeof(order));
+}
+
+int main() {
+  //  Higher priority first; every due task runs once per pass
+  resetTasks();
+  taskAdd("a", runA, 0, TASK_PRIO_COMPUTE);
+  taskAdd("b", runB, 0, TASK_PRIO_AUDIO);
+  taskAdd("c", runC, 0, TASK_PRIO_UI);
+  CHECK_EQ(taskRunDue(millis()), 0);   // background tasks are always due
+  CHECK_STR(order, "bca");
+
+  //  Stale handles never match a reused slot
+  resetTasks();
+  int h = taskAdd("a", runA, 10, TASK_PRIO_UI);
+  CHECK(taskSlot(h) >= 0);
+  taskCancel(h);
+  CHECK_EQ(taskSlot(h), -1);
+  int h2 = taskAdd("b", runB, 10, TASK_PRIO_UI);
+  CHECK(h2 != h);
+  CHECK_EQ(taskSlot(h2), h & 0xFF);
+  taskCancel(h);                       // harmless
+  CHECK(taskSlot(h2) >= 0);
+
+  //  Changing program cancels only the program's tasks
+  resetTasks();
+  int sys  = taskAdd("sys",  runA, 10, TASK_PRIO_UI);
+  int prog = taskAdd("prog", runB, 10, TASK_PRIO_UI, 0, TASK_GROUP_PROGRAM);
+  taskCancelGroup(TASK_GROUP_PROGRAM);
+  CHECK(taskSlot(sys) >= 0);
+  CHECK_EQ(taskSlot(prog), -1);
+
+  //  One-shots wait for their delay, run once and free their slot
+  resetTasks();
+  int once = taskAddOnce("once", runC, 5, TASK_PRIO_AUDIO);
+  unsigned long wait = taskRunDue(millis());
+  CHECK(wait > 0 && wait <= 5);
+  CHECK_EQ(orderLen, 0);
+  delay(6);
+  taskRunDue(millis());
+  CHECK_STR(order, "c");
+  CHECK_EQ(taskSlot(once), -1);
+
+  //  A periodic task is not due again until its period has passed
+  resetTasks();
+  int per = taskAdd("per", runA, 50, TASK_PRIO_UI);
+  taskRunDue(millis());
+  taskRunDue(millis());
+  CHECK_EQ(orderLen, 1);
+  CHECK_EQ(tasks[taskSlot(per)].runs, 1);
+
+  //  taskHasBudget() turns false once the slice is spent
+  resetTasks();
+  int slice = taskAdd("slice", runBudget, 0, TASK_PRIO_COMPUTE, 2000);
+  taskRunDue(millis());
+  CHECK(budgetRanOut);
+  CHECK(taskHasBudget());              // outside any task
+  CHECK(tasks[taskSlot(slice)].maxUs >= 2000);
+
+  //  The table fills up
+  resetTasks();
+  for (int i = 0; i < TASK_MAX; i++) CHECK(taskAdd("fill", runA, 100, TASK_PRIO_UI) >= 0);
+  CHECK_EQ(taskAdd("full", runA, 100, TASK_PRIO_UI), -1);
+
+  return testReport("scheduler");
+}
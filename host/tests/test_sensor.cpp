@@ -0,0 +1,66 @@
+//  Thermistor table and the sensor window's running statistics
+
+#include "../../ClassroomComputer/ClassroomComputer.ino"
+#include "test.h"
+
+#include <math.h>
+
+// The formula the table was built from, in tenths of a degree Fahrenheit.
+static double thermistorExact(int adc) {
+  double r = 1023.0 / adc - 1.0;
+  double c = 1.0 / (log(r) / 4275.0 + 1.0 / 298.15) - 273.15;
+  return (c * 9.0 / 5.0 + 32.0) * 10.0;
+}
+
+int main() {
+  //  Table and interpolation against the formula over the documented range
+  double worst = 0;
+  for (int adc = 250; adc <= 800; adc++) {
+    double err = fabs(thermistorTenthsF(adc) - thermistorExact(adc));
+    if (err > worst) worst = err;
+  }
+  CHECK(worst <= 1.5);
+  CHECK_EQ(thermistorTenthsF(-5), thermistorTenthsF(0));
+  CHECK_EQ(thermistorTenthsF(2000), thermistorTenthsF(1023));
+
+  //  Window statistics against a plain recount, past the wrap of the
+  // uint16_t sample numbers; ramps exercise the monotonic queues, noise the
+  // sums
+  static SensorWindow win;
+  static int16_t history[70000];
+  sensorReset(&win);
+  uint32_t seed = 1;
+  int mismatches = 0;
+  for (long i = 0; i < 70000; i++) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    int16_t v;
+    switch ((i / 300) % 3) {
+      case 0:  v = (int16_t)(i % 300) * 100 - 15000;   break;   // rising
+      case 1:  v = 15000 - (int16_t)(i % 300) * 100;   break;   // falling
+      default: v = (int16_t)(seed & 0xFFFF);           break;   // anything
+    }
+    history[i] = v;
+    sensorPush(&win, v);
+
+    long    from = max(0L, i + 1 - SENSOR_WINDOW);
+    int16_t lo = history[from], hi = history[from];
+    int32_t sum = 0;
+    int64_t sumSq = 0;
+    for (long k = from; k <= i; k++) {
+      lo = min(lo, history[k]);
+      hi = max(hi, history[k]);
+      sum   += history[k];
+      sumSq += (int32_t)history[k] * history[k];
+    }
+    if (sensorCount(&win) != i + 1 - from || sensorMin(&win) != lo || sensorMax(&win) != hi ||
+        win.sum != sum || win.sumSq != sumSq || sensorAt(&win, 0) != history[from]) {
+      mismatches++;
+    }
+  }
+  CHECK_EQ(win.count, 70000);
+  CHECK_EQ(mismatches, 0);
+
+  return testReport("sensor");
+}
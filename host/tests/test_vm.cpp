@@ -0,0 +1,138 @@
+//  Bytecode VM: results, bounds checks, error paths and the bench
+
+#include "../../ClassroomComputer/ClassroomComputer.ino"
+#include "test.h"
+
+// Loads code into vmCode (which keeps VM_CODE_PAD zero bytes after it) and
+// runs it with the program's syscalls for at most budget instructions.
+static Vm* run(const uint8_t* code, uint16_t len, uint32_t budget = 10000) {
+  memset(vmCode, 0, sizeof(vmCode));
+  memcpy(vmCode, code, len);
+  vmReset(&vm, vmCode, len, vmSyscall);
+  vmRun(&vm, budget);
+  return &vm;
+}
+
+#define RUN(...) ([]() { static const uint8_t c_[] = { __VA_ARGS__ }; return run(c_, sizeof(c_)); }())
+
+static void checkFails(Vm* m, VmError err, uint16_t errorPc, int line) {
+  testChecks++;
+  if (m->status != VM_FAILED || m->error != err || m->errorPc != errorPc) {
+    char what[96];
+    snprintf(what, sizeof(what), "status %d error %d at %u, wanted error %d at %u",
+             m->status, m->error, m->errorPc, err, errorPc);
+    testFail(__FILE__, line, what);
+  }
+}
+#define CHECK_FAILS(m, err, pc) checkFails((m), (err), (pc), __LINE__)
+
+int main() {
+  Vm* m;
+
+  //  Arithmetic, constants and wrap-around
+  m = RUN(VM_PUSH8, 2, VM_PUSH8, 3, VM_ADD, VM_PUSH8, 0xFC, VM_MUL, VM_HALT);
+  CHECK_EQ(m->status, VM_HALTED);
+  CHECK_EQ(m->sp, 1);
+  CHECK_EQ(m->stack[0], -20);
+  m = RUN(VM_PUSH32, 0xFF, 0xFF, 0xFF, 0x7F, VM_PUSH8, 1, VM_ADD, VM_HALT);
+  CHECK_EQ(m->stack[0], INT32_MIN);
+  m = RUN(VM_PUSH32, 0, 0, 0, 0x80, VM_PUSH8, 0xFF, VM_DIV, VM_HALT);   // INT32_MIN / -1
+  CHECK_EQ(m->status, VM_HALTED);
+  CHECK_EQ(m->stack[0], INT32_MIN);
+  m = RUN(VM_PUSH16, 0x10, 0x27, VM_PUSH8, 7, VM_MOD, VM_HALT);
+  CHECK_EQ(m->stack[0], 10000 % 7);
+
+  //  Loops, variables and calls: sum 1..10 in var 0
+  m = RUN(VM_PUSH8, 10, VM_STORE, 1,                              // 0: n = 10
+          VM_LOAD, 0, VM_LOAD, 1, VM_ADD, VM_STORE, 0,            // 4: sum += n
+          VM_LOAD, 1, VM_PUSH8, 1, VM_SUB, VM_DUP, VM_STORE, 1,   // 11: n--
+          VM_JNZ, 4, 0,                                           // 19
+          VM_CALL, 26, 0, VM_HALT,                                // 22
+          VM_PUSH8, 42, VM_RET);                                  // 26
+  CHECK_EQ(m->status, VM_HALTED);
+  CHECK_EQ(m->vars[0], 55);
+  CHECK_EQ(m->sp, 1);
+  CHECK_EQ(m->stack[0], 42);
+
+  //  The budget stops a slice; the next slice carries on
+  static const uint8_t spin[] = { VM_JMP, 0, 0 };
+  m = run(spin, sizeof(spin), 100);
+  CHECK_EQ(m->status, VM_RUNNING);
+  CHECK_EQ(m->executed, 100);
+  CHECK_EQ(vmRun(m, 50), 50);
+  CHECK_EQ(m->executed, 150);
+
+  //  Every error stops the program at the failing instruction
+  CHECK_FAILS(RUN(VM_PUSH8, 1, 0xEE), VM_ERR_OPCODE, 2);
+  CHECK_FAILS(RUN(VM_PUSH8, 1, VM_ADD), VM_ERR_STACK, 2);
+  CHECK_FAILS(RUN(VM_DROP), VM_ERR_STACK, 0);
+  CHECK_FAILS(RUN(VM_PUSH8, 1, VM_DUP, VM_JMP, 2, 0), VM_ERR_STACK, 2);   // overflow
+  CHECK_FAILS(RUN(VM_PUSH8, 1, VM_PUSH8, 0, VM_DIV), VM_ERR_DIVZERO, 4);
+  CHECK_FAILS(RUN(VM_PUSH8, 1, VM_PUSH8, 0, VM_MOD), VM_ERR_DIVZERO, 4);
+  CHECK_FAILS(RUN(VM_PUSH8, 1), VM_ERR_PC, 0);                            // ran off the end
+  CHECK_FAILS(RUN(VM_JMP, 3, 0), VM_ERR_PC, 0);
+  CHECK_FAILS(RUN(VM_PUSH8, 0, VM_JZ, 0xFF, 0xFF), VM_ERR_PC, 2);
+  CHECK_FAILS(RUN(VM_CALL, 0x00, 0x01), VM_ERR_PC, 0);
+  CHECK_FAILS(RUN(VM_LOAD, VM_VARS), VM_ERR_VAR, 0);
+  CHECK_FAILS(RUN(VM_PUSH8, 1, VM_STORE, 0xFF), VM_ERR_VAR, 2);
+  CHECK_FAILS(RUN(VM_RET), VM_ERR_RSTACK, 0);
+  CHECK_FAILS(RUN(VM_CALL, 0, 0), VM_ERR_RSTACK, 0);                      // endless recursion
+  CHECK_FAILS(RUN(VM_SYS, 99), VM_ERR_SYSCALL, 0);
+  static const uint8_t sys[] = { VM_SYS, SYSCALL_CLEAR, VM_HALT };
+  memcpy(vmCode, sys, sizeof(sys));
+  vmReset(&vm, vmCode, sizeof(sys), NULL);
+  vmRun(&vm, 10);
+  CHECK_FAILS(&vm, VM_ERR_SYSCALL, 0);
+
+  //  Operands that would run past the code read the zero padding
+  m = RUN(VM_PUSH32);
+  CHECK_FAILS(m, VM_ERR_PC, 0);
+  CHECK_EQ(m->stack[0], 0);
+
+  //  Syscalls check their arguments
+  lcd.clear();
+  m = RUN(VM_PUSH8, 3, VM_PUSH8, 1, VM_SYS, SYSCALL_CURSOR,
+          VM_PUSH8, 13, VM_PUSH8, 4, VM_SYS, SYSCALL_TEXT, VM_HALT, 'a', 'b', 'c', 'd');
+  CHECK_EQ(m->status, VM_HALTED);
+  CHECK(strncmp(lcd.line(1) + 3, "abcd", 4) == 0);
+  CHECK(RUN(VM_PUSH8, 0, VM_PUSH8, 7, VM_SYS, SYSCALL_TEXT, VM_HALT)->status == VM_HALTED);  // whole image
+  CHECK_FAILS(RUN(VM_PUSH8, 16, VM_PUSH8, 0, VM_SYS, SYSCALL_CURSOR), VM_ERR_SYSCALL, 4);
+  CHECK_FAILS(RUN(VM_PUSH8, 0, VM_PUSH8, 7, VM_SYS, SYSCALL_TEXT), VM_ERR_SYSCALL, 4);    // 1 byte past
+  CHECK_FAILS(RUN(VM_PUSH8, 0xFF, VM_PUSH8, 1, VM_SYS, SYSCALL_TEXT), VM_ERR_SYSCALL, 4); // negative
+  CHECK_FAILS(RUN(VM_PUSH32, 0xF0, 0xFF, 0xFF, 0x7F, VM_PUSH8, 0x20, VM_SYS, SYSCALL_TEXT),
+              VM_ERR_SYSCALL, 7);   // address + length overflows int32_t
+  CHECK_FAILS(RUN(VM_PUSH8, 0, VM_SYS, SYSCALL_RANDOM), VM_ERR_SYSCALL, 2);
+  CHECK_FAILS(RUN(VM_SYS, SYSCALL_NUMBER), VM_ERR_SYSCALL, 0);
+  CHECK_FAILS(RUN(VM_PUSH16, 0xB8, 0x01, VM_PUSH8, 0xFF, VM_SYS, SYSCALL_TONE), VM_ERR_SYSCALL, 5);  // -1 ms
+
+  //  sleep and yield end the slice without failing
+  m = RUN(VM_PUSH8, 5, VM_SYS, SYSCALL_SLEEP, VM_HALT);
+  CHECK_EQ(m->status, VM_RUNNING);
+  CHECK_EQ(m->pc, 4);
+  CHECK(vmSleeping);
+
+  //  vm bench clamps n and runs in slices of its task's budget
+  const char* const benches[] = { "bench x", "bench -5", "bench 0", "bench 99999999999" };
+  const long        clamped[] = { 1, 1, 1, VM_BENCH_MAX_N };
+  for (int i = 0; i < 4; i++) {
+    char cmd[24];
+    strcpy(cmd, benches[i]);
+    vmCommand(cmd);
+    CHECK_EQ(vmBenchN, clamped[i]);
+    int slot = taskSlot(vmBenchTask);
+    unsigned long runs = 0, maxUs = 0;
+    while (taskSlot(vmBenchTask) >= 0) {
+      taskRunDue(millis());
+      runs  = tasks[slot].runs;
+      maxUs = tasks[slot].maxUs;
+    }
+    CHECK_EQ(vmBenchVm.status, VM_HALTED);
+    CHECK_EQ(vmBenchVm.executed, 3 + 6 * clamped[i]);
+    if (clamped[i] == VM_BENCH_MAX_N) {
+      CHECK(runs > 10);
+      CHECK(maxUs < 4 * VM_SLICE_US);
+    }
+  }
+
+  return testReport("vm");
+}
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""Compares a "micro" run of the Classroom Computer against a baseline.
+
+Both files hold the JSON the sketch prints for "micro" (see
+ClassroomComputer/micro_bench.h); anything before it, such as CSV from other
+commands, is skipped.  Cases are matched by kernel and n, and ns_min is
+compared.  Given several runs, each case counts at its fastest, so a run
+slowed by the rest of the machine does not fail the check.  The exit status is
+1 if a case is more than --pct percent slower than its baseline or a baseline
+case is missing from the runs, so a build can fail on a regression:
+
+  for i in 1 2 3; do echo micro | host/build/sketch > micro$i.json; done
+  python3 tools/micro_compare.py host/micro_baseline.json micro?.json --pct 25
+
+make -C host micro-check does both steps.  With --write, the runs are written
+out as a new baseline instead (make -C host micro-baseline), each case at its
+median: a typical run, against which the check's best run has some room.
+"""
+
+import argparse
+import json
+import statistics
+import sys
+
+
+def load_results(path):
+    """Returns {(kernel, n): ns_min} from the first micro object in path."""
+    with open(path) as f:
+        text = f.read()
+    start = text.find('{"suite":"micro"')
+    if start < 0:
+        sys.exit("micro_compare: no micro results in %s" % path)
+    suite, _ = json.JSONDecoder().raw_decode(text[start:])
+    return {(r["kernel"], r["n"]): r["ns_min"] for r in suite["results"]}
+
+
+def write_baseline(path, results):
+    """Writes results as a micro object, one case per line like the sketch."""
+    rows = ['{"kernel":"%s","n":%d,"ns_min":%d}' % (k, n, ns) for (k, n), ns in results.items()]
+    with open(path, "w") as f:
+        f.write('{"suite":"micro","platform":"host","results":[\n' + "\n,".join(rows) + "\n]}\n")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("baseline", help="micro JSON with the reference numbers")
+    ap.add_argument("current", nargs="+", help="micro JSON of the runs to check")
+    ap.add_argument("--pct", type=float, default=10, help="allowed slowdown in percent (default 10)")
+    ap.add_argument("--write", action="store_true", help="write the runs' medians to baseline instead")
+    args = ap.parse_args()
+
+    runs = {}
+    for path in args.current:
+        for key, ns in load_results(path).items():
+            runs.setdefault(key, []).append(ns)
+
+    if args.write:
+        write_baseline(args.baseline, {key: statistics.median_low(ns) for key, ns in runs.items()})
+        return
+
+    cur = {key: min(ns) for key, ns in runs.items()}
+    base = load_results(args.baseline)
+
+    failed = 0
+    print("kernel,n,baseline_ns,ns,delta_pct,status")
+    for key in sorted(base.keys() | cur.keys()):
+        kernel, n = key
+        if key not in cur:
+            print("%s,%d,%d,,,missing" % (kernel, n, base[key]))
+            failed += 1
+            continue
+        if key not in base or base[key] == 0:
+            print("%s,%d,,%d,,new" % (kernel, n, cur[key]))
+            continue
+        delta = (cur[key] - base[key]) * 100.0 / base[key]
+        slower = delta > args.pct
+        failed += slower
+        print("%s,%d,%d,%d,%.1f,%s" % (kernel, n, base[key], cur[key], delta, "regression" if slower else "ok"))
+
+    print("# %d of %d baseline cases failed (threshold %g%%)" % (failed, len(base), args.pct))
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+"""Host side of the Classroom Computer's external merge sort ("xsort").
+
+Generates a list of integers, streams it to the sketch, keeps the runs the
+sketch spills, answers its read requests and checks the sorted result.  The
+protocol is described at the top of ClassroomComputer/ext_sort.h.
+
+  python3 xsort_peer.py --port /dev/ttyACM0 -n 20000        # the board (needs pyserial)
+  python3 xsort_peer.py --exec host/build/sketch -n 100000   # the host build (make -C host)
+"""
+
+import argparse
+import random
+import shlex
+import subprocess
+import sys
+import time
+
+LINE_MAX = 95          # BENCH_LINE_MAX - 1
+PUT = "xsort put"
+
+
+def put_lines(values):
+    """Packs values into "xsort put" lines that fit the sketch's line buffer."""
+    line = PUT
+    for v in values:
+        item = " %d" % v
+        if len(line) + len(item) > LINE_MAX:
+            yield line
+            line = PUT
+        line += item
+    if line != PUT:
+        yield line
+
+
+class SerialLink:
+    def __init__(self, port, baud):
+        import serial  # pyserial
+        self.port = serial.Serial(port, baud, timeout=10)
+        time.sleep(2)  # the board resets when the port opens
+        self.port.reset_input_buffer()
+
+    def send(self, line):
+        self.port.write((line + "\n").encode())
+
+    def receive(self):
+        return self.port.readline().decode(errors="replace")
+
+    def close(self):
+        self.port.close()
+
+
+class ProcessLink:
+    def __init__(self, command):
+        # No shell in between, so close() stops the sketch itself
+        self.proc = subprocess.Popen(shlex.split(command), stdin=subprocess.PIPE,
+                                     stdout=subprocess.PIPE, text=True, bufsize=1)
+
+    def send(self, line):
+        self.proc.stdin.write(line + "\n")
+        self.proc.stdin.flush()
+
+    def receive(self):
+        return self.proc.stdout.readline()
+
+    def close(self):
+        self.proc.kill()
+        self.proc.wait()
+
+
+def make_data(n, dist, seed):
+    rng = random.Random(seed)
+    if dist == "sorted":
+        return list(range(n))
+    if dist == "reversed":
+        return list(range(n, 0, -1))
+    if dist == "few":
+        return [rng.randrange(10) for _ in range(n)]
+    return [rng.randrange(-1000000, 1000000) for _ in range(n)]
+
+
+def run(link, data, run_size, ways, verbose):
+    runs = {}                # run id -> values spilled by the sketch
+    out = []
+    queue = input_lines(data)
+    stats = None
+    link.send("xsort begin run=%d ways=%d" % (run_size, ways))
+    while stats is None:
+        line = link.receive()
+        if not line:
+            sys.exit("xsort_peer: the sketch closed the connection")
+        words = line.split()
+        if not words:
+            continue
+        kind = words[0]
+        if kind == "xack":
+            link.send(next(queue))
+        elif kind == "xrun":
+            runs.setdefault(int(words[1]), []).extend(int(w) for w in words[2:])
+        elif kind == "xget":
+            run_id, offset, count = (int(w) for w in words[1:4])
+            queue = iter(list(put_lines(runs[run_id][offset:offset + count])))
+            link.send(next(queue))
+        elif kind == "xout":
+            out.extend(int(w) for w in words[1:])
+        elif kind == "xdone":
+            stats = dict(w.split("=", 1) for w in words[1:])
+        elif kind == "#" and verbose:
+            print(line.rstrip(), file=sys.stderr)
+    return out, stats, runs
+
+
+def input_lines(data):
+    yield from put_lines(data)
+    yield "xsort end"
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    link_arg = ap.add_mutually_exclusive_group(required=True)
+    link_arg.add_argument("--port", help="serial port of the board")
+    link_arg.add_argument("--exec", dest="command", help="command that runs the host build")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("-n", type=int, default=10000, help="values to sort")
+    ap.add_argument("--dist", choices=["random", "sorted", "reversed", "few"], default="random")
+    ap.add_argument("--seed", type=int, default=1)
+    ap.add_argument("--run", type=int, default=256, help="values sorted in RAM at a time")
+    ap.add_argument("--ways", type=int, default=8, help="runs merged at a time")
+    ap.add_argument("-v", "--verbose", action="store_true", help="echo the sketch's # lines")
+    args = ap.parse_args()
+
+    link = SerialLink(args.port, args.baud) if args.port else ProcessLink(args.command)
+    data = make_data(args.n, args.dist, args.seed)
+    started = time.time()
+    out, stats, runs = run(link, data, args.run, args.ways, args.verbose)
+    seconds = time.time() - started
+    link.close()
+
+    ok = out == sorted(data)
+    spilled = sum(len(r) for r in runs.values())
+    print("n=%d runs=%s passes=%s sketch_ms=%s per_s=%s host_s=%.2f spilled=%d sorted=%s check=%s" % (
+        args.n, stats["runs"], stats["passes"], stats["ms"], stats["per_s"], seconds,
+        spilled, stats["sorted"], "ok" if ok else "FAILED"))
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()